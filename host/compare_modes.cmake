@@ -0,0 +1,63 @@
+# Runs every scene with --check on builds of the same panel in different
+# render modes and checks they all drew the same frames. Band mode builds are
+# compared on every scene but those in BAND_SKIP.
+# usage: cmake -DSIMS=<warpdrive_sim>,... [-DBAND_SIMS=<warpdrive_sim>,... -DBAND_SKIP=<scene>,...]
+#              [-DSCALE=<objectScale on 128 px>] -P compare_modes.cmake
+string(REPLACE "," ";" sims "${SIMS}")
+string(REPLACE "," ";" band_sims "${BAND_SIMS}")
+string(REPLACE "," ";" band_skip "${BAND_SKIP}")
+if(NOT SCALE)
+  set(SCALE 1.8)
+endif()
+
+# One "scene hash" per report row of sim, in hashes_out
+function(run_sim sim hashes_out)
+  execute_process(COMMAND ${sim} --frames 120 --scale ${SCALE} --check
+                  OUTPUT_VARIABLE output ERROR_VARIABLE errors RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${sim} failed:\n${output}${errors}")
+  endif()
+  string(REGEX MATCHALL "[a-z]+ +[0-9]+ [^\n]* [0-9a-f]+\n" rows "${output}")
+  set(hashes "")
+  foreach(row ${rows})
+    string(REGEX REPLACE "^([a-z]+) .* ([0-9a-f]+)\n$" "\\1 \\2" row "${row}")
+    list(APPEND hashes "${row}")
+  endforeach()
+  if(NOT hashes)
+    message(FATAL_ERROR "${sim} printed no scenes:\n${output}")
+  endif()
+  message(STATUS "${sim}: ${hashes}")
+  set(${hashes_out} "${hashes}" PARENT_SCOPE)
+endfunction()
+
+# Fails if a row of hashes is missing from expected, leaving out the scenes in skip
+function(compare sim hashes expected first skip)
+  set(differ "")
+  foreach(row ${hashes})
+    string(REGEX REPLACE " .*" "" scene "${row}")
+    list(FIND skip "${scene}" skipped)
+    list(FIND expected "${row}" found)
+    if(skipped EQUAL -1 AND found EQUAL -1)
+      list(APPEND differ ${scene})
+    endif()
+  endforeach()
+  if(differ)
+    message(FATAL_ERROR "${sim} draws different frames from ${first} in: ${differ}")
+  endif()
+endfunction()
+
+set(first "")
+foreach(sim ${sims} ${band_sims})
+  run_sim(${sim} hashes)
+  if(first STREQUAL "")
+    set(first ${sim})
+    set(expected "${hashes}")
+  else()
+    list(FIND band_sims "${sim}" band)
+    if(band EQUAL -1)
+      compare(${sim} "${hashes}" "${expected}" ${first} "")
+    else()
+      compare(${sim} "${hashes}" "${expected}" ${first} "${band_skip}")
+    endif()
+  endif()
+endforeach()
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""Turns the .ino into a C++ translation unit the way the Arduino builder does.
+
+Prototypes for every function defined in the sketch are inserted just before
+the first function definition, after the sketch's own #includes and types.
+#line directives keep compiler messages pointing at the .ino.
+
+usage: gen_sketch.py <sketch.ino> <output.cpp>
+"""
+import re
+import sys
+
+FUNCTION = re.compile(
+    r'^((?:static\s+|inline\s+)*[A-Za-z_][\w:<>]*[\s*&]+)([A-Za-z_]\w*)\s*\(([^;{}()]*)\)\s*\{',
+    re.M)
+NOT_FUNCTIONS = {'if', 'for', 'while', 'switch'}
+NOT_RETURN_TYPES = {'return', 'else', 'struct', 'class', 'enum', 'namespace'}
+
+
+def strip_comments(source):
+    # Keep the line count so match offsets map back to sketch lines
+    source = re.sub(r'/\*.*?\*/', lambda m: '\n' * m.group(0).count('\n'), source, flags=re.S)
+    return re.sub(r'//[^\n]*', '', source)
+
+
+def main():
+    sketch_path, output_path = sys.argv[1], sys.argv[2]
+    with open(sketch_path) as f:
+        sketch = f.read()
+    code = strip_comments(sketch)
+
+    prototypes = []
+    first = None
+    for match in FUNCTION.finditer(code):
+        return_type, name, args = match.groups()
+        if name in NOT_FUNCTIONS or return_type.strip() in NOT_RETURN_TYPES:
+            continue
+        if first is None:
+            first = match.start()
+        args = re.sub(r'\s*=\s*[^,]+', '', args)  # Default arguments stay on the definition
+        prototypes.append('%s %s(%s);' % (return_type.strip(), name, ' '.join(args.split())))
+
+    lines = sketch.split('\n')
+    insert_at = code[:first].count('\n') if first is not None else len(lines)
+    lines.insert(insert_at, '\n'.join(prototypes) + '\n#line %d "%s"' % (insert_at + 1, sketch_path))
+
+    with open(output_path, 'w') as f:
+        f.write('#line 1 "%s"\n' % sketch_path)
+        f.write('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()
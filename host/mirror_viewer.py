@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Receives the sketch's network mirror (mirror.h) and rebuilds the screen.
+
+Prints the telemetry as it arrives and, with --dump, writes the rebuilt
+screen as PNG every --every frames. Works with the board on Wi-Fi and with
+the host simulator built with -DWARPDRIVE_NET_MIRROR=1.
+
+usage: mirror_viewer.py [--port 5005] [--dump DIR] [--every 30] [--seconds S]
+"""
+import argparse
+import os
+import socket
+import struct
+import time
+import zlib
+
+MAGIC = 0x4D57
+TILE_RAW, TILE_RLE, TELEMETRY = 0, 1, 2
+HEADER = struct.Struct('<HBBI')
+TILE = struct.Struct('<HBBIHHHH')
+TELEMETRY_FORMAT = struct.Struct('<HBBIHHHBBB3xI8III')
+
+STATES = ['normal', 'warp', 'discovery']
+OBJECTS = ['star', 'planet', 'nebula', 'galaxy', 'solar', 'asteroids',
+           'blackhole', 'pulsar', 'supernova', 'comet', 'binary', 'station']
+SECTIONS = ['frame', 'pot', 'input', 'stars', 'warp', 'shooting', 'present', 'delay']
+
+
+class Screen:
+    def __init__(self):
+        self.width = self.height = 0
+        self.pixels = []
+
+    def resize(self, width, height):
+        if (width, height) != (self.width, self.height):
+            self.width, self.height = width, height
+            self.pixels = [0] * (width * height)
+
+    def put(self, x, y, w, h, colors):
+        if not self.width:
+            return  # Size comes with the first telemetry
+        for i, color in enumerate(colors[:w * h]):
+            px, py = x + i % w, y + i // w
+            if px < self.width and py < self.height:
+                self.pixels[py * self.width + px] = color
+
+    def write_png(self, path):
+        rows = bytearray()
+        for y in range(self.height):
+            rows.append(0)
+            for color in self.pixels[y * self.width:(y + 1) * self.width]:
+                r, g, b = color >> 11, (color >> 5) & 0x3F, color & 0x1F
+                rows += bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+        def chunk(kind, data):
+            body = kind + data
+            return struct.pack('>I', len(data)) + body + struct.pack('>I', zlib.crc32(body) & 0xFFFFFFFF)
+
+        with open(path, 'wb') as f:
+            f.write(b'\x89PNG\r\n\x1a\n')
+            f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', self.width, self.height, 8, 2, 0, 0, 0)))
+            f.write(chunk(b'IDAT', zlib.compress(bytes(rows))))
+            f.write(chunk(b'IEND', b''))
+
+
+def decode_tile(packet, kind):
+    """Pixels of a tile packet, row by row; the sketch sends them high byte first"""
+    _, _, _, _, x, y, w, h = TILE.unpack_from(packet)
+    body = packet[TILE.size:]
+    if kind == TILE_RAW:
+        colors = list(struct.unpack('>%dH' % (len(body) // 2), body[:len(body) // 2 * 2]))
+    else:
+        colors = []
+        for i in range(0, len(body) - 2, 3):
+            colors += [struct.unpack_from('>H', body, i + 1)[0]] * (body[i] + 1)
+    return x, y, w, h, colors
+
+
+def print_telemetry(packet):
+    fields = TELEMETRY_FORMAT.unpack_from(packet)
+    frame, width, height, pot, state, obj, detail, skipped = fields[3:11]
+    sections, pixels, spi = fields[11:19], fields[19], fields[20]
+    shown = OBJECTS[obj] if obj < len(OBJECTS) else '-'
+    state_name = STATES[state] if state < len(STATES) else str(state)
+    timings = ' '.join('%s=%d' % (name, us) for name, us in zip(SECTIONS, sections))
+    print('frame %6d %dx%d pot=%4d %-9s %-9s lod=%3d skipped=%d px=%d spi=%d us: %s'
+          % (frame, width, height, pot, state_name, shown, detail, skipped, pixels, spi, timings))
+    return width, height
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--port', type=int, default=5005)
+    parser.add_argument('--dump', help='directory for mirror_<frame>.png')
+    parser.add_argument('--every', type=int, default=30, help='with --dump, frames between images')
+    parser.add_argument('--seconds', type=float, help='stop after this long')
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(('', args.port))
+    sock.settimeout(0.5)
+    if args.dump:
+        os.makedirs(args.dump, exist_ok=True)
+
+    screen = Screen()
+    stop = time.time() + args.seconds if args.seconds else None
+    last_dump = None
+    while stop is None or time.time() < stop:
+        try:
+            packet = sock.recv(2048)
+        except socket.timeout:
+            continue
+        if len(packet) < HEADER.size:
+            continue
+        magic, kind, _, frame = HEADER.unpack_from(packet)
+        if magic != MAGIC:
+            continue
+        if kind == TELEMETRY:
+            screen.resize(*print_telemetry(packet))
+        elif kind in (TILE_RAW, TILE_RLE):
+            screen.put(*decode_tile(packet, kind))
+        if args.dump and screen.width and (last_dump is None or frame - last_dump >= args.every):
+            screen.write_png(os.path.join(args.dump, 'mirror_%06d.png' % frame))
+            last_dump = frame
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,121 @@
+#include <Arduino.h>
+#include <esp_sleep.h>
+
+#include <deque>
+#include <stdexcept>
+
+HardwareSerial Serial;
+
+namespace {
+  uint64_t g_micros = 0;
+  uint32_t g_rng = 0x12345678u;
+  int g_analog[64] = {};
+  int g_digital[64];
+  bool g_digitalInit = false;
+  uint32_t g_cpuMhz = 240;
+  bool g_serialEcho = false;
+  std::deque<uint8_t> g_serialIn;
+  esp_sleep_wakeup_cause_t g_wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+  uint64_t g_sleepTimerUs = 0;
+  const uint64_t LIGHT_SLEEP_WAKE_US = 500; // About what an ESP32 takes to come back from light sleep
+
+  uint32_t nextRandom() {
+    // xorshift32: deterministic for a given seed, independent of the host libc
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+  }
+}
+
+namespace host {
+  void setMillis(unsigned long ms) { g_micros = (uint64_t)ms * 1000; }
+  void advanceMicros(uint64_t us) { g_micros += us; }
+  uint64_t nowMicros() { return g_micros; }
+  void setAnalogValue(int pin, int value) { g_analog[pin & 63] = value; }
+  void setDigitalValue(int pin, int value) {
+    if (!g_digitalInit) { for (int& d : g_digital) d = HIGH; g_digitalInit = true; }
+    g_digital[pin & 63] = value;
+  }
+  void setRandomSeed(uint32_t seed) { g_rng = seed ? seed : 0x12345678u; }
+  void setSerialEcho(bool echo) { g_serialEcho = echo; }
+  void pushSerialInput(const char* text) { while (*text) g_serialIn.push_back((uint8_t)*text++); }
+  void setWakeupCause(esp_sleep_wakeup_cause_t cause) { g_wakeCause = cause; }
+}
+
+unsigned long millis() { return (unsigned long)(g_micros / 1000); }
+unsigned long micros() { return (unsigned long)g_micros; }
+void delay(unsigned long ms) { g_micros += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { g_micros += us; }
+void yield() {}
+
+uint32_t esp_random() { return nextRandom(); }
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return (long)(nextRandom() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) host::setRandomSeed((uint32_t)seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  long divisor = in_max - in_min;
+  if (divisor == 0) return -1;
+  return (x - in_min) * (out_max - out_min) / divisor + out_min;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+
+int digitalRead(uint8_t pin) {
+  if (!g_digitalInit) { for (int& d : g_digital) d = HIGH; g_digitalInit = true; }
+  return g_digital[pin & 63];
+}
+
+uint16_t analogRead(uint8_t pin) { return (uint16_t)g_analog[pin & 63]; }
+void analogReadResolution(uint8_t) {}
+
+bool setCpuFrequencyMhz(uint32_t mhz) { g_cpuMhz = mhz; return true; }
+uint32_t getCpuFrequencyMhz() { return g_cpuMhz; }
+
+EspClass ESP;
+
+int HardwareSerial::available() { return (int)g_serialIn.size(); }
+
+int HardwareSerial::read() {
+  if (g_serialIn.empty()) return -1;
+  uint8_t c = g_serialIn.front();
+  g_serialIn.pop_front();
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (g_serialEcho) fputc(c, stdout);
+  return 1;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return g_wakeCause; }
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t, int) { return ESP_OK; }
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) { g_sleepTimerUs = us; return ESP_OK; }
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_wakeup_cause_t source) {
+  if (source == ESP_SLEEP_WAKEUP_TIMER) g_sleepTimerUs = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start() {
+  // Both cores stop, so unlike vTaskDelay() no other task runs meanwhile
+  g_micros += g_sleepTimerUs + LIGHT_SLEEP_WAKE_US;
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+  throw std::runtime_error("deep sleep");
+}
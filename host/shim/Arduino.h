@@ -0,0 +1,141 @@
+// Host-side stand-in for the Arduino core, just enough for the sketch to build
+// and run headless. Time, randomness and analog input are driven by the harness.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using std::abs;
+using std::max;
+using std::min;
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x) * (x))
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define PROGMEM
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ---- Harness controls --------------------------------------------------------
+namespace host {
+  void setMillis(unsigned long ms);
+  void advanceMicros(uint64_t us);
+  uint64_t nowMicros();
+  void setAnalogValue(int pin, int value);
+  void setDigitalValue(int pin, int value);
+  void setRandomSeed(uint32_t seed);
+  void setSerialEcho(bool echo);         // Copy Serial output to stdout
+  void pushSerialInput(const char* text); // Queue bytes for Serial.read()
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+// The host does not track its heap, so both read 0
+class EspClass {
+public:
+  uint32_t getHeapSize() { return 0; }
+  uint32_t getFreeHeap() { return 0; }
+};
+extern EspClass ESP;
+
+// ---- Print / Serial ----------------------------------------------------------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = 10) { return base == 16 ? printf("%lx", v) : printf("%ld", v); }
+  size_t print(unsigned long v, int base = 10) { return base == 16 ? printf("%lx", v) : printf("%lu", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(T v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    return write((const uint8_t*)buf, std::min((size_t)len, sizeof(buf) - 1));
+  }
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int available();
+  int read();
+  size_t write(uint8_t c) override;
+  using Print::write;
+  void flush() {}
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#ifndef ESP32
+#define ESP32 1
+#endif
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#endif // HOST_ARDUINO_H
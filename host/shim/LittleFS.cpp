@@ -0,0 +1,40 @@
+#include "LittleFS.h"
+
+LittleFSFS LittleFS;
+
+namespace {
+  std::string g_fsRoot = ".";
+
+  std::string hostPath(const char* path) {
+    return g_fsRoot + path;
+  }
+}
+
+namespace host {
+  void setFsRoot(const char* dir) { g_fsRoot = dir; }
+}
+
+size_t File::size() const {
+  if (!file_) return 0;
+  long at = ftell(file_.get());
+  fseek(file_.get(), 0, SEEK_END);
+  long end = ftell(file_.get());
+  fseek(file_.get(), at, SEEK_SET);
+  return end < 0 ? 0 : (size_t)end;
+}
+
+File LittleFSFS::open(const char* path, const char* mode) {
+  // Binary mode, the sketch writes raw structs
+  std::string binaryMode = std::string(mode) + "b";
+  return File(fopen(hostPath(path).c_str(), binaryMode.c_str()));
+}
+
+bool LittleFSFS::exists(const char* path) {
+  FILE* file = fopen(hostPath(path).c_str(), "rb");
+  if (file) fclose(file);
+  return file != nullptr;
+}
+
+bool LittleFSFS::remove(const char* path) {
+  return ::remove(hostPath(path).c_str()) == 0;
+}
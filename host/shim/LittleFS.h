@@ -0,0 +1,43 @@
+// Host stand-in for the ESP32 LittleFS library. Files live in a directory on
+// the host, set by the harness; nothing needs formatting.
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+
+namespace host {
+  void setFsRoot(const char* dir); // Prefix for every path, "." at start; "" uses paths as given
+}
+
+class File {
+public:
+  File() {}
+  explicit File(FILE* file) { if (file) file_.reset(file, fclose); }
+
+  size_t write(const uint8_t* buffer, size_t size) { return file_ ? fwrite(buffer, 1, size, file_.get()) : 0; }
+  int read(uint8_t* buffer, size_t size) { return file_ ? (int)fread(buffer, 1, size, file_.get()) : -1; }
+  size_t size() const;
+  void flush() { if (file_) fflush(file_.get()); }
+  void close() { file_.reset(); }
+  operator bool() const { return (bool)file_; }
+
+private:
+  std::shared_ptr<FILE> file_;
+};
+
+class LittleFSFS {
+public:
+  bool begin(bool formatOnFail = false) { (void)formatOnFail; return true; }
+  File open(const char* path, const char* mode = FILE_READ);
+  bool exists(const char* path);
+  bool remove(const char* path);
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
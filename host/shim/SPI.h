@@ -0,0 +1,5 @@
+// Host stand-in for the SPI library; the TFT_eSPI shim does not need a bus.
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+#include <Arduino.h>
+#endif
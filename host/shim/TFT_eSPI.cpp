@@ -0,0 +1,499 @@
+#include <TFT_eSPI.h>
+
+namespace {
+  host::PanelStats g_stats = {};
+  int g_callDepth = 0;
+
+  // Bytes for a full CASET + RASET + RAMWR sequence
+  constexpr uint32_t ADDR_WINDOW_BYTES = 11;
+
+  inline uint16_t swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+}
+
+namespace host {
+  PanelStats& panelStats() { return g_stats; }
+  void resetPanelStats() { g_stats = PanelStats(); }
+}
+
+TFT_eSPI::CallScope::CallScope(TFT_eSPI* t) : tft(t), outer(g_callDepth == 0) {
+  if (outer) g_stats.drawCalls++;
+  g_callDepth++;
+}
+
+TFT_eSPI::CallScope::~CallScope() { g_callDepth--; }
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : _width(w), _height(h), _initWidth(w), _initHeight(h) {
+  _panel = new uint16_t[(size_t)w * h]();
+}
+
+TFT_eSPI::~TFT_eSPI() { delete[] _panel; }
+
+void TFT_eSPI::init(uint8_t) {
+  _writeDepth = 0;
+  _lastPixelX = _lastPixelY = -1;
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+  _rotation = r & 3;
+  if (_rotation & 1) { _width = _initHeight; _height = _initWidth; }
+  else               { _width = _initWidth;  _height = _initHeight; }
+}
+
+int16_t TFT_eSPI::width(void) { return (int16_t)_width; }
+int16_t TFT_eSPI::height(void) { return (int16_t)_height; }
+
+void TFT_eSPI::plot(int32_t x, int32_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  _panel[y * _width + x] = color;
+  g_stats.panelPixels++;
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) {
+  CallScope scope(this);
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  // The driver only re-sends the column/row address when it changes
+  uint32_t bytes = 1 + 2;
+  if (x != _lastPixelX) bytes += 5;
+  if (y != _lastPixelY) bytes += 5;
+  _lastPixelX = x;
+  _lastPixelY = y;
+  g_stats.panelBytes += bytes;
+  g_stats.addrWindows++;
+  plot(x, y, (uint16_t)color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  CallScope scope(this);
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width) w = _width - x;
+  if (y + h > _height) h = _height - y;
+  if (w < 1 || h < 1) return;
+  g_stats.panelBytes += ADDR_WINDOW_BYTES + 2ull * w * h;
+  g_stats.addrWindows++;
+  _lastPixelX = _lastPixelY = -1;
+  for (int32_t j = 0; j < h; j++)
+    for (int32_t i = 0; i < w; i++) plot(x + i, y + j, (uint16_t)color);
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+  CallScope scope(this);
+  fillRect(x, y, w, 1, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+  CallScope scope(this);
+  fillRect(x, y, 1, h, color);
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+  CallScope scope(this);
+  bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+  if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+  if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+  int32_t dx = x1 - x0, dy = std::abs(y1 - y0);
+  int32_t err = dx >> 1, ystep = (y0 < y1) ? 1 : -1;
+  int32_t runStart = x0, dlen = 0;
+  for (; x0 <= x1; x0++) {
+    dlen++;
+    err -= dy;
+    if (err < 0 || x0 == x1) {
+      if (steep) drawFastVLine(y0, runStart, dlen, color);
+      else       drawFastHLine(runStart, y0, dlen, color);
+      dlen = 0;
+      runStart = x0 + 1;
+      if (err < 0) { y0 += ystep; err += dx; }
+    }
+  }
+}
+
+void TFT_eSPI::fillScreen(uint32_t color) {
+  CallScope scope(this);
+  fillRect(0, 0, _width, _height, color);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  CallScope scope(this);
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y + 1, h - 2, color);
+  drawFastVLine(x + w - 1, y + 1, h - 2, color);
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+  CallScope scope(this);
+  if (r < 0) return;
+  int32_t f = 1 - r, ddFx = 1, ddFy = -2 * r, x = 0, y = r;
+  drawPixel(x0, y0 + r, color);
+  drawPixel(x0, y0 - r, color);
+  drawPixel(x0 + r, y0, color);
+  drawPixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) { y--; ddFy += 2; f += ddFy; }
+    x++;
+    ddFx += 2;
+    f += ddFx;
+    drawPixel(x0 + x, y0 + y, color);
+    drawPixel(x0 - x, y0 + y, color);
+    drawPixel(x0 + x, y0 - y, color);
+    drawPixel(x0 - x, y0 - y, color);
+    drawPixel(x0 + y, y0 + x, color);
+    drawPixel(x0 - y, y0 + x, color);
+    drawPixel(x0 + y, y0 - x, color);
+    drawPixel(x0 - y, y0 - x, color);
+  }
+}
+
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+  CallScope scope(this);
+  if (r < 0) return;
+  drawFastHLine(x0 - r, y0, 2 * r + 1, color);
+  int32_t f = 1 - r, ddFx = 1, ddFy = -2 * r, x = 0, y = r;
+  while (x < y) {
+    if (f >= 0) {
+      drawFastHLine(x0 - x, y0 + y, 2 * x + 1, color);
+      drawFastHLine(x0 - x, y0 - y, 2 * x + 1, color);
+      y--;
+      ddFy += 2;
+      f += ddFy;
+    }
+    x++;
+    ddFx += 2;
+    f += ddFx;
+    drawFastHLine(x0 - y, y0 + x, 2 * y + 1, color);
+    drawFastHLine(x0 - y, y0 - x, 2 * y + 1, color);
+  }
+}
+
+void TFT_eSPI::drawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) {
+  CallScope scope(this);
+  drawLine(x1, y1, x2, y2, color);
+  drawLine(x2, y2, x3, y3, color);
+  drawLine(x3, y3, x1, y1, color);
+}
+
+void TFT_eSPI::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+  CallScope scope(this);
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+  if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+
+  if (y0 == y2) {
+    int32_t a = std::min({x0, x1, x2}), b = std::max({x0, x1, x2});
+    drawFastHLine(a, y0, b - a + 1, color);
+    return;
+  }
+
+  int32_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0;
+  int32_t dx12 = x2 - x1, dy12 = y2 - y1, sa = 0, sb = 0, y, last;
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    int32_t a = x0 + sa / dy01, b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b) std::swap(a, b);
+    drawFastHLine(a, y, b - a + 1, color);
+  }
+  sa = dx12 * (y - y1);
+  sb = dx02 * (y - y0);
+  for (; y <= y2; y++) {
+    int32_t a = x1 + sa / dy12, b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b) std::swap(a, b);
+    drawFastHLine(a, y, b - a + 1, color);
+  }
+}
+
+// Placeholder 5x7 glyphs: the harness cares about coverage and cost, not legibility.
+void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) {
+  CallScope scope(this);
+  if (size == 0) size = 1;
+  uint32_t bits = (uint32_t)c * 2654435761u;
+  for (int8_t col = 0; col < 6; col++) {
+    for (int8_t row = 0; row < 8; row++) {
+      bool on = c != ' ' && col < 5 && row < 7 &&
+                (row == 0 || row == 6 || col == 0 || col == 4 || ((bits >> ((row * 5 + col) & 31)) & 1));
+      if (on) fillRect(x + col * size, y + row * size, size, size, color);
+      else if (bg != color) fillRect(x + col * size, y + row * size, size, size, bg);
+    }
+  }
+}
+
+size_t TFT_eSPI::write(uint8_t c) {
+  if (c == '\n') { _cursorX = 0; _cursorY += 8 * _textSize; return 1; }
+  if (c == '\r') return 1;
+  drawChar(_cursorX, _cursorY, c, _textColor, _textFill ? _textBg : _textColor, _textSize);
+  _cursorX += 6 * _textSize;
+  return 1;
+}
+
+int16_t TFT_eSPI::drawString(const char* string, int32_t x, int32_t y, uint8_t font) {
+  int16_t w = textWidth(string, font);
+  int16_t h = fontHeight(font);
+  switch (_textDatum) {
+    case TC_DATUM: x -= w / 2; break;
+    case TR_DATUM: x -= w; break;
+    case ML_DATUM: y -= h / 2; break;
+    case MC_DATUM: x -= w / 2; y -= h / 2; break;
+    case MR_DATUM: x -= w; y -= h / 2; break;
+    case BL_DATUM: y -= h; break;
+    case BC_DATUM: x -= w / 2; y -= h; break;
+    case BR_DATUM: x -= w; y -= h; break;
+    default: break;
+  }
+  int16_t cx = _cursorX, cy = _cursorY;
+  setCursor((int16_t)x, (int16_t)y);
+  print(string);
+  _cursorX = cx;
+  _cursorY = cy;
+  return w;
+}
+
+void TFT_eSPI::startWrite(void) { _writeDepth++; }
+void TFT_eSPI::endWrite(void) { if (_writeDepth > 0) _writeDepth--; }
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+  _winX0 = _winX = x;
+  _winY0 = _winY = y;
+  _winX1 = x + w - 1;
+  _winY1 = y + h - 1;
+  _lastPixelX = _lastPixelY = -1;
+  g_stats.panelBytes += ADDR_WINDOW_BYTES;
+  g_stats.addrWindows++;
+}
+
+void TFT_eSPI::streamPixel(uint16_t color) {
+  plot(_winX, _winY, color);
+  g_stats.panelBytes += 2;
+  if (++_winX > _winX1) {
+    _winX = _winX0;
+    if (++_winY > _winY1) _winY = _winY0;
+  }
+}
+
+void TFT_eSPI::pushColor(uint16_t color) { streamPixel(color); }
+
+void TFT_eSPI::pushColors(uint16_t* data, uint32_t len, bool swap) {
+  CallScope scope(this);
+  while (len--) streamPixel(swap ? *data++ : swap16(*data++));
+}
+
+void TFT_eSPI::pushBlock(uint16_t color, uint32_t len) {
+  CallScope scope(this);
+  while (len--) streamPixel(color);
+}
+
+void TFT_eSPI::pushPixels(const void* data, uint32_t len) {
+  CallScope scope(this);
+  const uint16_t* p = (const uint16_t*)data;
+  while (len--) streamPixel(fromBus(*p++));
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+  CallScope scope(this);
+  if (w < 1 || h < 1) return;
+  setAddrWindow(x, y, w, h);
+  for (int32_t i = 0; i < w * h; i++) streamPixel(fromBus(data[i]));
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data) {
+  pushImage(x, y, w, h, (const uint16_t*)data);
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data, uint16_t transparent) {
+  CallScope scope(this);
+  if (_swapBytes) transparent = swap16(transparent);
+  for (int32_t j = 0; j < h; j++) {
+    int32_t i = 0;
+    while (i < w) {
+      while (i < w && data[j * w + i] == transparent) i++;
+      int32_t start = i;
+      while (i < w && data[j * w + i] != transparent) i++;
+      if (i > start) {
+        setAddrWindow(x + start, y + j, i - start, 1);
+        for (int32_t k = start; k < i; k++) streamPixel(fromBus(data[j * w + k]));
+      }
+    }
+  }
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint16_t transparent) {
+  pushImage(x, y, w, h, (const uint16_t*)data, transparent);
+}
+
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint16_t* buffer) {
+  CallScope scope(this);
+  if (buffer) {
+    memcpy(buffer, data, (size_t)w * h * 2);
+    data = buffer;
+  }
+  g_stats.dmaTransfers++;
+  pushImage(x, y, w, h, (const uint16_t*)data);
+}
+
+void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len) {
+  CallScope scope(this);
+  g_stats.dmaTransfers++;
+  while (len--) streamPixel(fromBus(*image++));
+}
+
+uint16_t TFT_eSPI::readPixel(int32_t x, int32_t y) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+  return _panel[y * _width + x];
+}
+
+// ---- Sprite ------------------------------------------------------------------
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI* tft) : TFT_eSPI(0, 0), _tft(tft) {
+  delete[] _panel;
+  _panel = nullptr;
+}
+
+TFT_eSprite::~TFT_eSprite() { deleteSprite(); }
+
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
+  if (_img) return _img;
+  if (w < 1 || h < 1) return nullptr;
+  _iwidth = _width = w;
+  _iheight = _height = h;
+  _img1 = (uint16_t*)calloc((size_t)w * h, 2);
+  _img2 = frames > 1 ? (uint16_t*)calloc((size_t)w * h, 2) : nullptr;
+  _img = _img1;
+  return _img;
+}
+
+void TFT_eSprite::deleteSprite(void) {
+  free(_img1);
+  free(_img2);
+  _img = _img1 = _img2 = nullptr;
+}
+
+void* TFT_eSprite::frameBuffer(int8_t f) {
+  if (!_img1) return nullptr;
+  _img = (f == 2 && _img2) ? _img2 : _img1;
+  return _img;
+}
+
+void TFT_eSprite::plot(int32_t x, int32_t y, uint16_t color) {
+  if (!_img || x < 0 || y < 0 || x >= _iwidth || y >= _iheight) return;
+  _img[y * _iwidth + x] = swap16(color);
+  g_stats.spritePixels++;
+}
+
+void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color) {
+  CallScope scope(this);
+  plot(x, y, (uint16_t)color);
+}
+
+void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  CallScope scope(this);
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _iwidth) w = _iwidth - x;
+  if (y + h > _iheight) h = _iheight - y;
+  if (w < 1 || h < 1) return;
+  for (int32_t j = 0; j < h; j++)
+    for (int32_t i = 0; i < w; i++) plot(x + i, y + j, (uint16_t)color);
+}
+
+void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+  CallScope scope(this);
+  fillRect(x, y, w, 1, color);
+}
+
+void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+  CallScope scope(this);
+  fillRect(x, y, 1, h, color);
+}
+
+void TFT_eSprite::drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye, uint32_t color) {
+  TFT_eSPI::drawLine(xs, ys, xe, ye, color);
+}
+
+void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) {
+  TFT_eSPI::drawChar(x, y, c, color, bg, size);
+}
+
+void TFT_eSprite::fillSprite(uint32_t color) {
+  CallScope scope(this);
+  if (!_img) return;
+  uint16_t v = swap16((uint16_t)color);
+  for (int32_t i = 0; i < _iwidth * _iheight; i++) _img[i] = v;
+  g_stats.spritePixels += (uint64_t)_iwidth * _iheight;
+}
+
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) {
+  if (!_img || x < 0 || y < 0 || x >= _iwidth || y >= _iheight) return 0;
+  return swap16(_img[y * _iwidth + x]);
+}
+
+void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+  CallScope scope(this);
+  if (!_img) return;
+  for (int32_t j = 0; j < h; j++) {
+    for (int32_t i = 0; i < w; i++) {
+      int32_t px = x + i, py = y + j;
+      if (px < 0 || py < 0 || px >= _iwidth || py >= _iheight) continue;
+      uint16_t v = data[j * w + i];
+      // With swap enabled the source is native RGB565, otherwise already in bus order
+      _img[py * _iwidth + px] = _swapBytes ? swap16(v) : v;
+      g_stats.spritePixels++;
+    }
+  }
+}
+
+void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint8_t) {
+  pushImage(x, y, w, h, (const uint16_t*)data);
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y) {
+  if (!_img) return;
+  bool swap = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
+  _tft->pushImage(x, y, _iwidth, _iheight, _img);
+  _tft->setSwapBytes(swap);
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transparent) {
+  if (!_img) return;
+  bool swap = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
+  _tft->pushImage(x, y, _iwidth, _iheight, _img, swap16(transparent));
+  _tft->setSwapBytes(swap);
+}
+
+bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh) {
+  if (!_img) return false;
+  if (sx < 0) { sw += sx; tx -= sx; sx = 0; }
+  if (sy < 0) { sh += sy; ty -= sy; sy = 0; }
+  if (sx + sw > _iwidth) sw = _iwidth - sx;
+  if (sy + sh > _iheight) sh = _iheight - sy;
+  if (sw < 1 || sh < 1) return false;
+  CallScope scope(this);
+  _tft->setAddrWindow(tx, ty, sw, sh);
+  for (int32_t j = 0; j < sh; j++)
+    for (int32_t i = 0; i < sw; i++) _tft->streamPixel(swap16(_img[(sy + j) * _iwidth + sx + i]));
+  return true;
+}
+
+bool TFT_eSprite::pushToSprite(TFT_eSprite* dspr, int32_t x, int32_t y) {
+  if (!_img || !dspr || !dspr->_img) return false;
+  CallScope scope(this);
+  for (int32_t j = 0; j < _iheight; j++)
+    for (int32_t i = 0; i < _iwidth; i++) dspr->plot(x + i, y + j, swap16(_img[j * _iwidth + i]));
+  return true;
+}
+
+bool TFT_eSprite::pushToSprite(TFT_eSprite* dspr, int32_t x, int32_t y, uint16_t transparent) {
+  if (!_img || !dspr || !dspr->_img) return false;
+  CallScope scope(this);
+  for (int32_t j = 0; j < _iheight; j++) {
+    for (int32_t i = 0; i < _iwidth; i++) {
+      uint16_t c = swap16(_img[j * _iwidth + i]);
+      if (c != transparent) dspr->plot(x + i, y + j, c);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,241 @@
+// Host-side stand-in for Bodmer's TFT_eSPI. The panel is an in-memory RGB565
+// framebuffer and every primitive is counted so the harness can report draw
+// calls, pixels touched and bytes that would have crossed the SPI bus.
+//
+// Byte order follows the real library: 16-bit sprites store pixels
+// byte-swapped (ready for SPI), and pushImage()/pushImageDMA() honour
+// setSwapBytes() the same way the ESP32 driver does.
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+#include <Arduino.h>
+#include <User_Setup.h>
+
+// Panel size from the build (WARPDRIVE_PANEL) in place of the sketch's setup
+#ifdef HOST_TFT_WIDTH
+#undef TFT_WIDTH
+#undef TFT_HEIGHT
+#define TFT_WIDTH HOST_TFT_WIDTH
+#define TFT_HEIGHT HOST_TFT_HEIGHT
+#endif
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH 128
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 128
+#endif
+
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_DARKGREEN   0x03E0
+#define TFT_DARKCYAN    0x03EF
+#define TFT_MAROON      0x7800
+#define TFT_PURPLE      0x780F
+#define TFT_OLIVE       0x7BE0
+#define TFT_LIGHTGREY   0xD69A
+#define TFT_DARKGREY    0x7BEF
+#define TFT_BLUE        0x001F
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_ORANGE      0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK        0xFE19
+#define TFT_BROWN       0x9A60
+#define TFT_GOLD        0xFEA0
+#define TFT_SILVER      0xC618
+#define TFT_SKYBLUE     0x867D
+#define TFT_VIOLET      0x915C
+#define TFT_TRANSPARENT 0x0120
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+namespace host {
+  struct PanelStats {
+    uint64_t drawCalls;     // Public drawing API calls (nested primitives not counted)
+    uint64_t panelPixels;   // Pixels written to the panel
+    uint64_t panelBytes;    // Bytes that would have crossed the SPI bus
+    uint64_t addrWindows;   // Address window (CASET/RASET/RAMWR) sequences
+    uint64_t spritePixels;  // Pixels written into sprites
+    uint64_t dmaTransfers;  // pushImageDMA() calls
+  };
+  PanelStats& panelStats();
+  void resetPanelStats();
+}
+
+// setAttribute() ids
+#define CP437_SWITCH 1
+#define UTF8_SWITCH  2
+#define PSRAM_ENABLE 3
+
+class TFT_eSprite;
+
+class TFT_eSPI : public Print {
+  friend class TFT_eSprite;
+public:
+  TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+  virtual ~TFT_eSPI();
+
+  void init(uint8_t tc = 0);
+  void begin(uint8_t tc = 0) { init(tc); }
+  void setRotation(uint8_t r);
+  uint8_t getRotation() const { return _rotation; }
+
+  virtual void drawPixel(int32_t x, int32_t y, uint32_t color);
+  virtual void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size);
+  virtual void drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye, uint32_t color);
+  virtual void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+  virtual void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  virtual int16_t width(void);
+  virtual int16_t height(void);
+
+  void fillScreen(uint32_t color);
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+  void fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+  void drawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color);
+  void fillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color);
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  // Text
+  void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+  int16_t getCursorX() const { return _cursorX; }
+  int16_t getCursorY() const { return _cursorY; }
+  void setTextColor(uint16_t c) { _textColor = c; _textBg = c; _textFill = false; }
+  void setTextColor(uint16_t c, uint16_t b, bool bgfill = false) { _textColor = c; _textBg = b; _textFill = bgfill; }
+  void setTextSize(uint8_t s) { _textSize = s > 0 ? s : 1; }
+  void setTextFont(uint8_t f) { (void)f; }
+  void setTextDatum(uint8_t d) { _textDatum = d; }
+  void setTextWrap(bool wrapX, bool wrapY = false) { (void)wrapX; (void)wrapY; }
+  int16_t textWidth(const char* string, uint8_t font = 1) { (void)font; return (int16_t)(strlen(string) * 6 * _textSize); }
+  int16_t fontHeight(int16_t font = 1) { (void)font; return 8 * _textSize; }
+  int16_t drawString(const char* string, int32_t x, int32_t y, uint8_t font = 1);
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Panel streaming
+  void startWrite(void);
+  void endWrite(void);
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+  void pushColor(uint16_t color);
+  void pushColor(uint16_t color, uint32_t len) { pushBlock(color, len); }
+  void pushColors(uint16_t* data, uint32_t len, bool swap = true);
+  void pushBlock(uint16_t color, uint32_t len);
+  void pushPixels(const void* data, uint32_t len);
+  void setSwapBytes(bool swap) { _swapBytes = swap; }
+  bool getSwapBytes(void) const { return _swapBytes; }
+  void setAttribute(uint8_t id = 0, uint8_t a = 0) { (void)id; (void)a; }
+  uint8_t getAttribute(uint8_t id = 0) { (void)id; return 0; }
+
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data);
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint16_t transparent);
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data, uint16_t transparent);
+
+  bool initDMA(bool ctrl_cs = false) { (void)ctrl_cs; _dma = true; return true; }
+  void deInitDMA(void) { _dma = false; }
+  void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint16_t* buffer = nullptr);
+  void pushPixelsDMA(uint16_t* image, uint32_t len);
+  void dmaWait(void) {}
+  bool dmaBusy(void) { return false; }
+
+  uint16_t readPixel(int32_t x, int32_t y);
+
+  // Host access to the simulated panel contents (native RGB565).
+  const uint16_t* hostFramebuffer() const { return _panel; }
+
+protected:
+  struct CallScope {
+    explicit CallScope(TFT_eSPI* t);
+    ~CallScope();
+    TFT_eSPI* tft;
+    bool outer;
+  };
+
+  virtual void plot(int32_t x, int32_t y, uint16_t color);
+  virtual bool isSprite() const { return false; }
+  void streamPixel(uint16_t color);
+  uint16_t fromBus(uint16_t v) const { return _swapBytes ? v : (uint16_t)((v << 8) | (v >> 8)); }
+
+  int32_t _width, _height;
+  int32_t _initWidth, _initHeight;
+  uint8_t _rotation = 0;
+  uint16_t* _panel = nullptr;
+  int _depth = 0;
+
+  int16_t _cursorX = 0, _cursorY = 0;
+  uint16_t _textColor = TFT_WHITE, _textBg = TFT_WHITE;
+  bool _textFill = false;
+  uint8_t _textSize = 1;
+  uint8_t _textDatum = TL_DATUM;
+
+  bool _swapBytes = false;
+  bool _dma = false;
+  int _writeDepth = 0;
+  int32_t _winX0 = 0, _winY0 = 0, _winX1 = 0, _winY1 = 0, _winX = 0, _winY = 0;
+  int32_t _lastPixelX = -1, _lastPixelY = -1;
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+  explicit TFT_eSprite(TFT_eSPI* tft);
+  ~TFT_eSprite() override;
+
+  void* createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+  void deleteSprite(void);
+  void* frameBuffer(int8_t f);
+  void* getPointer(void) { return _img; }
+  bool created(void) const { return _img != nullptr; }
+  void* setColorDepth(int8_t b) { _bpp = b; return _img; }
+  int8_t getColorDepth(void) const { return _bpp; }
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+  void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) override;
+  void drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye, uint32_t color) override;
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) override;
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) override;
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override;
+  int16_t width(void) override { return _iwidth; }
+  int16_t height(void) override { return _iheight; }
+
+  void fillSprite(uint32_t color);
+  uint16_t readPixel(int32_t x, int32_t y);
+
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint8_t sbpp = 0);
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+
+  void pushSprite(int32_t x, int32_t y);
+  void pushSprite(int32_t x, int32_t y, uint16_t transparent);
+  bool pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
+  bool pushToSprite(TFT_eSprite* dspr, int32_t x, int32_t y);
+  bool pushToSprite(TFT_eSprite* dspr, int32_t x, int32_t y, uint16_t transparent);
+
+protected:
+  void plot(int32_t x, int32_t y, uint16_t color) override;
+  bool isSprite() const override { return true; }
+
+  TFT_eSPI* _tft;
+  uint16_t* _img = nullptr;
+  uint16_t* _img1 = nullptr;
+  uint16_t* _img2 = nullptr;
+  int32_t _iwidth = 0, _iheight = 0;
+  int8_t _bpp = 16;
+};
+
+#endif // HOST_TFT_ESPI_H
@@ -0,0 +1,44 @@
+#include "WiFi.h"
+#include "WiFiUdp.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+wl_status_t WiFiClass::begin(const char*, const char*) {
+  status_ = WL_CONNECTED;
+  return status_;
+}
+
+WiFiUDP::~WiFiUDP() {
+  if (socket_ >= 0) close(socket_);
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+  if (socket_ < 0) {
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) return 0;
+    int on = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)); // The sketch defaults to broadcast
+  }
+  host_ = host;
+  port_ = port;
+  packet_.clear();
+  return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+  packet_.insert(packet_.end(), buffer, buffer + size);
+  return size;
+}
+
+int WiFiUDP::endPacket() {
+  sockaddr_in to = {};
+  to.sin_family = AF_INET;
+  to.sin_port = htons(port_);
+  if (socket_ < 0 || inet_pton(AF_INET, host_.c_str(), &to.sin_addr) != 1) return 0;
+  // Nobody listening is not an error for UDP; a full socket buffer drops the packet as Wi-Fi would
+  return sendto(socket_, packet_.data(), packet_.size(), MSG_DONTWAIT, (sockaddr*)&to, sizeof(to)) >= 0;
+}
@@ -0,0 +1,31 @@
+// Host stand-in for the ESP32 WiFi library: there is no radio to join, so the
+// station is connected as soon as begin() is called.
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+#include <Arduino.h>
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_CONNECTED = 3,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF,
+  WIFI_STA,
+  WIFI_AP,
+  WIFI_AP_STA
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+  bool mode(wifi_mode_t mode) { (void)mode; return true; }
+  wl_status_t begin(const char* ssid, const char* password = nullptr);
+  wl_status_t status() const { return status_; }
+
+private:
+  wl_status_t status_ = WL_IDLE_STATUS;
+};
+
+extern WiFiClass WiFi;
+#endif
@@ -0,0 +1,22 @@
+// Host stand-in for WiFiUDP, sending through a plain POSIX UDP socket.
+// Like the real one, a packet is gathered between beginPacket() and endPacket().
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+class WiFiUDP {
+public:
+  ~WiFiUDP();
+  int beginPacket(const char* host, uint16_t port);
+  size_t write(const uint8_t* buffer, size_t size);
+  int endPacket();
+
+private:
+  int socket_ = -1;
+  std::string host_;
+  uint16_t port_ = 0;
+  std::vector<uint8_t> packet_;
+};
+#endif
@@ -0,0 +1,7 @@
+// Host stand-in for the RTC GPIO driver calls made before deep sleep.
+#ifndef HOST_RTC_IO_H
+#define HOST_RTC_IO_H
+#include <esp_sleep.h>
+inline esp_err_t rtc_gpio_pullup_en(gpio_num_t) { return ESP_OK; }
+inline esp_err_t rtc_gpio_pulldown_dis(gpio_num_t) { return ESP_OK; }
+#endif
@@ -0,0 +1,33 @@
+// Host stand-in for esp_sleep: wake-up causes come from the harness and deep
+// sleep ends the run with an exception.
+#ifndef HOST_ESP_SLEEP_H
+#define HOST_ESP_SLEEP_H
+#include <Arduino.h>
+
+typedef enum {
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_MAX = 40
+} gpio_num_t;
+
+typedef enum {
+  ESP_SLEEP_WAKEUP_UNDEFINED,
+  ESP_SLEEP_WAKEUP_ALL,
+  ESP_SLEEP_WAKEUP_EXT0,
+  ESP_SLEEP_WAKEUP_EXT1,
+  ESP_SLEEP_WAKEUP_TIMER,
+} esp_sleep_wakeup_cause_t;
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level);
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_wakeup_cause_t source);
+esp_err_t esp_light_sleep_start();
+[[noreturn]] void esp_deep_sleep_start();
+
+namespace host {
+  void setWakeupCause(esp_sleep_wakeup_cause_t cause);
+}
+#endif
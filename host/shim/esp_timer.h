@@ -0,0 +1,30 @@
+// Host stand-in for esp_timer. There is no timer service, so periodic timers
+// fail to start and the sketch takes its polling fallbacks.
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+#include "esp_sleep.h"
+
+#define ESP_FAIL -1
+
+typedef struct esp_timer* esp_timer_handle_t;
+
+typedef struct {
+  void (*callback)(void*);
+  void* arg;
+  int dispatch_method;
+  const char* name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+inline int64_t esp_timer_get_time() { return (int64_t)micros(); }
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t*, esp_timer_handle_t* out) {
+  *out = nullptr;
+  return ESP_FAIL;
+}
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t) { return ESP_FAIL; }
+inline esp_err_t esp_timer_stop(esp_timer_handle_t) { return ESP_OK; }
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,127 @@
+#include <Arduino.h>
+#include "freertos/task.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+struct HostTask {
+  int core = 1;
+  uint32_t notify = 0;
+  bool blocked = false;
+};
+
+namespace {
+  // Never destroyed: detached task threads are still parked on them at exit
+  std::mutex& g_lock = *new std::mutex();
+  std::condition_variable& g_turn = *new std::condition_variable();
+  HostTask g_mainTask;
+  std::vector<HostTask*> g_tasks{&g_mainTask};
+  HostTask* g_running = &g_mainTask;
+  thread_local HostTask* t_self = &g_mainTask;
+
+  // Hands control to the next task that can run; returns false if there is none
+  bool passBaton(std::unique_lock<std::mutex>& lk, HostTask* self) {
+    size_t n = g_tasks.size(), start = 0;
+    for (size_t i = 0; i < n; i++) if (g_tasks[i] == self) start = i;
+    for (size_t k = 1; k <= n; k++) {
+      HostTask* t = g_tasks[(start + k) % n];
+      if (t != self && !t->blocked) {
+        g_running = t;
+        g_turn.notify_all();
+        g_turn.wait(lk, [&] { return g_running == self; });
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t, void* arg,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t core) {
+  HostTask* task = new HostTask();
+  task->core = core;
+  {
+    std::lock_guard<std::mutex> lk(g_lock);
+    g_tasks.push_back(task);
+  }
+  std::thread([fn, arg, task] {
+    t_self = task;
+    {
+      std::unique_lock<std::mutex> lk(g_lock);
+      g_turn.wait(lk, [&] { return g_running == task; });
+    }
+    fn(arg);
+  }).detach();
+  if (handle) *handle = task;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, priority, handle, tskNO_AFFINITY);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return t_self; }
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  std::unique_lock<std::mutex> lk(g_lock);
+  HostTask* self = t_self;
+  while (self->notify == 0) {
+    self->blocked = true;
+    bool ran = passBaton(lk, self);
+    self->blocked = false;
+    if (!ran) {
+      if (ticks == portMAX_DELAY) throw std::runtime_error("ulTaskNotifyTake: every task is blocked");
+      return 0;
+    }
+    if (self->notify == 0 && ticks != portMAX_DELAY) return 0;
+  }
+  uint32_t value = self->notify;
+  self->notify = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  std::lock_guard<std::mutex> lk(g_lock);
+  task->notify++;
+  task->blocked = false;
+  return pdPASS;
+}
+
+namespace host {
+  // Lets every other ready task run until it blocks (models the other core working meanwhile)
+  void runOtherTasks() {
+    std::unique_lock<std::mutex> lk(g_lock);
+    HostTask* self = t_self;
+    self->blocked = true;
+    bool others = false;
+    for (HostTask* t : g_tasks) if (t != self && !t->blocked) others = true;
+    if (others) { self->blocked = false; passBaton(lk, self); }
+    self->blocked = false;
+  }
+}
+
+void vTaskDelay(TickType_t ticks) { delay(ticks); host::runOtherTasks(); }
+
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+  TickType_t target = *previousWake + period;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(target - now) > 0) delay(target - now);
+  *previousWake = target;
+  host::runOtherTasks();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+  TickType_t target = *previousWake + period;
+  bool late = (int32_t)(target - xTaskGetTickCount()) <= 0;
+  vTaskDelayUntil(previousWake, period);
+  return late ? pdFALSE : pdTRUE;
+}
+
+BaseType_t xPortGetCoreID() { return t_self->core; }
+
+void vTaskDelete(TaskHandle_t) {}
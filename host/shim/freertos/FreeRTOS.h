@@ -0,0 +1,20 @@
+// Host stand-in for the FreeRTOS types the sketch uses
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+#include <cstdint>
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void*);
+struct HostTask;
+typedef HostTask* TaskHandle_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configTICK_RATE_HZ 1000
+#define tskNO_AFFINITY 0x7FFFFFFF
+#endif
@@ -0,0 +1,81 @@
+#include "png_writer.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+  uint32_t crcTable[256];
+  bool crcReady = false;
+
+  uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0xFFFFFFFFu) {
+    if (!crcReady) {
+      for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[n] = c;
+      }
+      crcReady = true;
+    }
+    for (size_t i = 0; i < len; i++) crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+  }
+
+  void put32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(v >> 24); out.push_back(v >> 16); out.push_back(v >> 8); out.push_back(v);
+  }
+
+  void chunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    put32(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put32(out, crc32(&out[start], out.size() - start) ^ 0xFFFFFFFFu);
+  }
+}
+
+namespace host {
+  bool writePng565(const char* path, const uint16_t* pixels, int width, int height) {
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)(width * 3 + 1) * height);
+    for (int y = 0; y < height; y++) {
+      raw.push_back(0); // filter: none
+      for (int x = 0; x < width; x++) {
+        uint16_t c = pixels[y * width + x];
+        uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        raw.push_back((r << 3) | (r >> 2));
+        raw.push_back((g << 2) | (g >> 4));
+        raw.push_back((b << 3) | (b >> 2));
+      }
+    }
+
+    // zlib stream made of stored (uncompressed) deflate blocks
+    std::vector<uint8_t> z = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (uint8_t v : raw) { a = (a + v) % 65521; b = (b + a) % 65521; }
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+      size_t len = raw.size() - pos > 65535 ? 65535 : raw.size() - pos;
+      bool last = pos + len >= raw.size();
+      z.push_back(last ? 1 : 0);
+      z.push_back(len & 0xFF); z.push_back(len >> 8);
+      z.push_back(~len & 0xFF); z.push_back((~len >> 8) & 0xFF);
+      z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+      pos += len;
+      if (last) break;
+    }
+    put32(z, (b << 16) | a);
+
+    std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> ihdr;
+    put32(ihdr, width); put32(ihdr, height);
+    ihdr.push_back(8); ihdr.push_back(2); ihdr.push_back(0); ihdr.push_back(0); ihdr.push_back(0);
+    chunk(out, "IHDR", ihdr);
+    chunk(out, "IDAT", z);
+    chunk(out, "IEND", {});
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+  }
+}
@@ -0,0 +1,12 @@
+// Minimal dependency-free PNG writer (stored deflate blocks) for frame dumps.
+#ifndef HOST_PNG_WRITER_H
+#define HOST_PNG_WRITER_H
+
+#include <cstdint>
+
+namespace host {
+  // Writes a native-order RGB565 image as a 24-bit PNG. Returns false on I/O error.
+  bool writePng565(const char* path, const uint16_t* pixels, int width, int height);
+}
+
+#endif // HOST_PNG_WRITER_H
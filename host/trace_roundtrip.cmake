@@ -0,0 +1,17 @@
+# Records a session, replays it and checks the replay drew the same frames.
+# usage: cmake -DSIM=<warpdrive_sim> -DTRACE=<file> -P trace_roundtrip.cmake
+foreach(step record replay)
+  execute_process(COMMAND ${SIM} --frames 420 --${step} ${TRACE}
+                  OUTPUT_VARIABLE output RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${step} failed:\n${output}")
+  endif()
+  # Everything but the CPU times must match
+  string(REGEX MATCH "session +[0-9]+ +[0-9.]+ +[0-9.]+ +[0-9.]+ +[0-9.]+" counts "${output}")
+  string(REGEX MATCH "[0-9a-f]+\n*$" hash "${output}")
+  set(${step} "${counts} ${hash}")
+  message(STATUS "${step}: ${${step}}")
+endforeach()
+if(NOT record STREQUAL replay)
+  message(FATAL_ERROR "the replay differs from the recording")
+endif()
@@ -0,0 +1,349 @@
+// Headless desktop build of the sketch. Runs the normal and warp starfields
+// and each celestial object for a number of frames on the host shims, then
+// reports draw calls, panel and sprite pixels, SPI bytes and host CPU time
+// per frame. Optionally dumps frames as PNG.
+//
+// With --record or --replay it runs one session instead: the knob swings
+// between warp and discovery the way a user would, and the sketch records
+// its inputs to a trace, or takes them from one (trace.h). A replayed trace
+// draws the same frames, which the frame hash in the report shows.
+//
+// With --bench it starts the sketch's own benchmark run (bench.h) over serial
+// and runs until it is done; the sketch prints its table, heap column aside.
+//
+// Time is virtual: it only moves when the sketch delays, so a run is the same
+// on every machine for a given seed. The CPU times are real and only good for
+// comparing builds on the same host.
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "png_writer.h"
+
+#include SKETCH_CPP
+
+namespace {
+  const int SCENE_NORMAL = -2;
+  const int SCENE_WARP = -1; // 0.. are CelestialObject values
+
+  struct Options {
+    std::vector<int> scenes;
+    int frames = 300;
+    uint32_t seed = 1;
+    unsigned long startMs = 0;
+    int detail = -1;         // Pin lodDetail, -1 leaves the governor in charge
+    float scale = 1.8f;      // objectScale for the celestial objects on a 128 px panel
+    const char* dumpDir = nullptr;
+    int dumpEvery = 30;
+    bool serial = false;
+    bool bench = false;
+    bool check = false;      // Fail on frames that spill out of band mode or overdraw the panel
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+  };
+
+  const char* sceneName(int scene) {
+    if (scene == SCENE_NORMAL) return "normal";
+    if (scene == SCENE_WARP) return "warp";
+    return CELESTIAL_OBJECT_NAMES[scene];
+  }
+
+  bool parseScene(const std::string& name, std::vector<int>& scenes) {
+    if (name == "all") {
+      for (int scene = SCENE_NORMAL; scene < PROF_OBJECT_TYPES; scene++) scenes.push_back(scene);
+      return true;
+    }
+    for (int scene = SCENE_NORMAL; scene < PROF_OBJECT_TYPES; scene++) {
+      if (name == sceneName(scene)) {
+        scenes.push_back(scene);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void usage() {
+    printf("usage: warpdrive_sim [options]\n"
+           "  --scene NAME    all (default), normal, warp or an object; repeatable\n"
+           "  --frames N      frames per scene (300)\n"
+           "  --seed S        session seed, reset at the start of every scene (1)\n"
+           "  --start-ms T    millis() when the sketch starts (0)\n"
+           "  --detail D      pin the level of detail to 0..255\n"
+           "  --scale F       celestial object scale on a 128 px panel, grows with PANEL_SCALE (1.8)\n"
+           "  --dump DIR      write <scene>_<frame>.png into DIR\n"
+           "  --every K       with --dump, every K-th frame (30)\n"
+           "  --serial        copy the sketch's Serial output to stdout\n"
+           "  --record FILE   run a session and record its input trace to FILE\n"
+           "  --replay FILE   run a session from the input trace in FILE\n"
+           "  --bench         run the sketch's benchmark and print its table\n"
+           "  --check         fail if a frame spills out of band mode or sends more than a screen\n"
+           "scenes:");
+    for (int scene = SCENE_NORMAL; scene < PROF_OBJECT_TYPES; scene++) printf(" %s", sceneName(scene));
+    printf("\n");
+  }
+
+  bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+      if (arg == "--serial") {
+        options.serial = true;
+        continue;
+      }
+      if (arg == "--bench") {
+        options.bench = true;
+        continue;
+      }
+      if (arg == "--check") {
+        options.check = true;
+        continue;
+      }
+      if (!value) return false;
+      i++;
+      if (arg == "--scene") {
+        if (!parseScene(value, options.scenes)) return false;
+      } else if (arg == "--frames") {
+        options.frames = atoi(value);
+      } else if (arg == "--seed") {
+        options.seed = (uint32_t)strtoul(value, nullptr, 0);
+      } else if (arg == "--start-ms") {
+        options.startMs = strtoul(value, nullptr, 0);
+      } else if (arg == "--detail") {
+        options.detail = constrain(atoi(value), 0, LOD_MAX);
+      } else if (arg == "--scale") {
+        options.scale = (float)atof(value);
+      } else if (arg == "--dump") {
+        options.dumpDir = value;
+      } else if (arg == "--every") {
+        options.dumpEvery = std::max(1, atoi(value));
+      } else if (arg == "--record") {
+        options.recordPath = value;
+      } else if (arg == "--replay") {
+        options.replayPath = value;
+      } else {
+        return false;
+      }
+    }
+    if ((options.recordPath != nullptr) + (options.replayPath != nullptr) + options.bench > 1) return false;
+    if (options.scenes.empty()) parseScene("all", options.scenes);
+    return options.frames > 0;
+  }
+
+  /**
+   * Sets the potentiometer and restarts its filter so the new value holds from the first frame
+   */
+  void setPotentiometer(int raw) {
+    host::setAnalogValue(POT_PIN, raw);
+    potSamplerBegin(POT_PIN);
+  }
+
+  /**
+   * Clears whatever the last scene showed and puts the state machine into a scene
+   */
+  void enterScene(int scene, const Options& options) {
+    simStop();
+    if (currentState == State::DISCOVERY && showingCelestialObject) {
+      eraseCelestialObject();
+    }
+    showingCelestialObject = false;
+    rngBegin(options.seed);
+
+    if (scene == SCENE_WARP) {
+      setPotentiometer(0); // The reading is inverted: 0 is full warp
+      currentState = State::WARP;
+      prevShouldWarp = true;
+      return;
+    }
+
+    setPotentiometer(POT_MAX);
+    prevShouldWarp = false;
+    if (scene == SCENE_NORMAL) {
+      currentState = State::NORMAL;
+      return;
+    }
+
+    // Same steps as a discovery in processInput(), with a fixed placement
+    currentState = State::DISCOVERY;
+    currentObject = static_cast<CelestialObject>(scene);
+    objectX = SCREEN_WIDTH / 2;
+    objectY = SCREEN_HEIGHT / 2;
+    objectScale = options.scale * PANEL_SCALE; // As processInput() sizes a discovery
+    arenaReset();
+    const CelestialRenderer& renderer = CELESTIAL_RENDERERS[scene];
+    if (renderer.init) renderer.init();
+    showingCelestialObject = true;
+  }
+
+  struct SceneResult {
+    host::PanelStats stats;
+    std::vector<double> cpuUs; // Host time of each loop(), sorted
+    uint32_t frameHash = 2166136261u; // FNV-1a over every frame shown
+    int spilledFrames = 0;           // Band mode: frames that outgrew the list
+    uint64_t maxFramePixels = 0;     // Panel pixels of the busiest frame
+  };
+
+  /**
+   * Runs loop() once and takes the frame's measurements
+   */
+  void runFrame(const char* name, int frame, const Options& options, SceneResult& result) {
+    if (options.detail >= 0) lodDetail = options.detail;
+
+    uint64_t panelPixels = host::panelStats().panelPixels;
+    auto start = std::chrono::steady_clock::now();
+    loop();
+    auto end = std::chrono::steady_clock::now();
+    result.cpuUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    result.maxFramePixels = std::max(result.maxFramePixels, host::panelStats().panelPixels - panelPixels);
+#if RENDER_MODE == RENDER_BANDED
+    if (frameRecorder.spilledFrame()) result.spilledFrames++;
+#endif
+
+    const uint16_t* pixels = tft.hostFramebuffer();
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+      result.frameHash = (result.frameHash ^ pixels[i]) * 16777619u;
+    }
+
+    if (options.dumpDir && frame % options.dumpEvery == 0) {
+      char path[512];
+      snprintf(path, sizeof(path), "%s/%s_%04d.png", options.dumpDir, name, frame);
+      if (!host::writePng565(path, pixels, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        throw std::runtime_error(std::string("cannot write ") + path);
+      }
+    }
+  }
+
+  SceneResult runScene(int scene, const Options& options) {
+    enterScene(scene, options);
+    host::resetPanelStats();
+
+    SceneResult result;
+    for (int frame = 0; frame < options.frames; frame++) {
+      runFrame(sceneName(scene), frame, options, result);
+    }
+    result.stats = host::panelStats();
+    std::sort(result.cpuUs.begin(), result.cpuUs.end());
+    return result;
+  }
+
+  /**
+   * A session straight from setup(): warp for two seconds, look at whatever was
+   * found for five, and again. A replay leaves the knob alone: the trace has it.
+   */
+  SceneResult runSession(const Options& options) {
+    const int warpFrames = 60;
+    const int discoveryFrames = 150;
+    host::resetPanelStats();
+
+    SceneResult result;
+    for (int frame = 0; frame < options.frames; frame++) {
+      bool warp = frame % (warpFrames + discoveryFrames) < warpFrames;
+      if (!options.replayPath) host::setAnalogValue(POT_PIN, warp ? 0 : POT_MAX);
+      runFrame("session", frame, options, result);
+    }
+    if (options.replayPath && !traceReplaying()) {
+      throw std::runtime_error("the trace ended before the session did");
+    }
+    traceEnd();
+    result.stats = host::panelStats();
+    std::sort(result.cpuUs.begin(), result.cpuUs.end());
+    return result;
+  }
+
+  /**
+   * The sketch's benchmark run, started with 'b' as over serial, until it reports
+   */
+  SceneResult runBench(const Options& options) {
+    host::pushSerialInput("b");
+    host::resetPanelStats();
+
+    SceneResult result;
+    int frame = 0;
+    do {
+      runFrame("bench", frame++, options, result);
+    } while (benchRunning());
+    result.stats = host::panelStats();
+    std::sort(result.cpuUs.begin(), result.cpuUs.end());
+    return result;
+  }
+
+  /**
+   * With --check, false if a frame spilled out of band mode or a buffered
+   * mode sent more than a screen of pixels in one frame
+   */
+  bool checkResult(const char* name, const SceneResult& result, const Options& options) {
+    if (!options.check) return true;
+    bool ok = true;
+    if (result.spilledFrames > 0) {
+      fprintf(stderr, "warpdrive_sim: %s: %d frames outgrew the band list\n", name, result.spilledFrames);
+      ok = false;
+    }
+    if (RENDER_FULL_REDRAW && result.maxFramePixels > (uint64_t)SCREEN_WIDTH * SCREEN_HEIGHT) {
+      fprintf(stderr, "warpdrive_sim: %s: a frame sent %llu pixels, more than the %dx%d screen\n", name,
+              (unsigned long long)result.maxFramePixels, SCREEN_WIDTH, SCREEN_HEIGHT);
+      ok = false;
+    }
+    return ok;
+  }
+
+  void printResult(const char* name, const SceneResult& result, int frames) {
+    const host::PanelStats& s = result.stats;
+    double mean = 0;
+    for (double us : result.cpuUs) mean += us;
+    mean /= frames;
+    printf("%-10s %6d %9.1f %10.1f %10.1f %11.1f %9.1f %9.1f %9.1f  %08x\n", name, frames,
+           (double)s.drawCalls / frames, (double)s.panelPixels / frames, (double)s.panelBytes / frames,
+           (double)s.spritePixels / frames, mean, result.cpuUs[(frames - 1) * 95 / 100], result.cpuUs.back(),
+           result.frameHash);
+  }
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage();
+    return 2;
+  }
+
+  host::setSerialEcho(options.serial || options.bench); // The benchmark reports over serial
+  host::setMillis(options.startMs);
+  host::setRandomSeed(options.seed);
+  host::setAnalogValue(POT_PIN, 0); // Knob turned up, so the intro screen moves on
+  host::setFsRoot(""); // Trace paths are host paths
+  bool session = options.recordPath || options.replayPath;
+  if (session) {
+    traceMode = options.recordPath ? TRACE_RECORD : TRACE_REPLAY;
+    tracePath = options.recordPath ? options.recordPath : options.replayPath;
+  }
+
+  bool passed = true;
+  try {
+    setup();
+    if (session && traceMode == TRACE_OFF) {
+      throw std::runtime_error(std::string("cannot open the trace ") + tracePath);
+    }
+    printf("%-10s %6s %9s %10s %10s %11s %9s %9s %9s  %-8s\n", "scene", "frames", "calls/f", "pixels/f",
+           "spi B/f", "sprite px/f", "cpu us", "p95 us", "max us", "hash");
+    if (session) {
+      SceneResult result = runSession(options);
+      printResult("session", result, options.frames);
+      passed = checkResult("session", result, options);
+    } else if (options.bench) {
+      SceneResult result = runBench(options);
+      printResult("bench", result, (int)result.cpuUs.size());
+      passed = checkResult("bench", result, options);
+    } else {
+      for (int scene : options.scenes) {
+        SceneResult result = runScene(scene, options);
+        printResult(sceneName(scene), result, options.frames);
+        passed = checkResult(sceneName(scene), result, options) && passed;
+      }
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "warpdrive_sim: %s\n", e.what());
+    return 1;
+  }
+  return passed ? 0 : 1;
+}
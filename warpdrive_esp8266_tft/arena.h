@@ -0,0 +1,56 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <Arduino.h>
+
+// Shared arena for celestial object state. Only one object is on screen at a
+// time, so its particle arrays are carved out of one buffer that is reset on
+// every discovery instead of each object keeping its own arrays for good.
+// Each object module defines <OBJECT>_ARENA_BYTES as the sum of ARENA_SIZE()
+// of what its init function allocates; the sketch sizes the buffer to the
+// largest of them.
+
+#define ARENA_ALIGN 8 // Enough for any member, including 64-bit ones
+#define ARENA_SIZE(type, count) ((sizeof(type) * (count) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+// Forward declarations of external variables
+extern uint8_t objectArena[];      // ARENA_ALIGN aligned
+extern const size_t objectArenaSize;
+
+namespace {
+  size_t arenaUsed = 0; // Bytes handed out since the last reset
+}
+
+/**
+ * Larger of two sizes, for sizing the arena at compile time
+ */
+constexpr size_t arenaMax(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+/**
+ * Releases everything handed out, before the next object's init
+ */
+inline void arenaReset() {
+  arenaUsed = 0;
+}
+
+/**
+ * Takes zeroed room for count values of T from the arena. Only plain structs
+ * and arrays go in here: no constructors run and nothing is destroyed.
+ */
+template <typename T>
+T* arenaAlloc(size_t count = 1) {
+  size_t bytes = ARENA_SIZE(T, count);
+  if (arenaUsed + bytes > objectArenaSize) {
+    // The <OBJECT>_ARENA_BYTES of the object does not match its allocations
+    Serial.println("Object arena exhausted");
+    return nullptr;
+  }
+  T* block = reinterpret_cast<T*>(objectArena + arenaUsed);
+  memset(block, 0, bytes);
+  arenaUsed += bytes;
+  return block;
+}
+
+#endif // ARENA_H
@@ -0,0 +1,184 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+#include "profiler.h"
+#include "lod.h"
+#include "render.h"
+#include "trace.h"
+
+// Benchmark run, for comparing builds and boards. It steps through warp at a
+// few fixed warp factors, then every celestial object at the centre of the
+// screen at its smallest and its largest scale, each from the same seed, for
+// BENCH_FRAMES frames. Detail stays at LOD_MAX and the CPU at full speed, so
+// every build does the same work. At the end it prints one row per step: mean
+// and p99 frame work time (everything but the frame delay), SPI bytes per
+// frame and the most heap in use at the end of a frame.
+// Start it by holding the button at power-on, or with 'b' over serial. The
+// SPI column needs the profiler and reads 0 without it.
+
+#define BENCH_SEED 0x42454E43    // "BENC", for rngBegin() at each step
+#define BENCH_FRAMES 120         // Frames measured per step
+#define BENCH_SETTLE_FRAMES 10   // Frames run before measuring, past the object's first-draw setup
+#define BENCH_OBJECTS PROF_OBJECT_TYPES
+
+// processInput() pot readings for warp factors 0.05, 0.25, 0.5 and 1.0
+// (easeInOutCubic of the reading over 4095)
+const uint16_t BENCH_WARP_POTS[] = {950, 1625, 2048, 4095};
+const char* const BENCH_WARP_NAMES[] = {"warp 0.05", "warp 0.25", "warp 0.50", "warp 1.00"};
+#define BENCH_WARP_STEPS (sizeof(BENCH_WARP_POTS) / sizeof(BENCH_WARP_POTS[0]))
+#define BENCH_STEPS (BENCH_WARP_STEPS + 2 * BENCH_OBJECTS)
+
+/**
+ * One step of the run: warp at a pot reading, or an object at one end of its scale range
+ */
+struct BenchStep {
+  bool warp;
+  uint16_t pot;      // Warp only
+  uint8_t object;    // CelestialObject value, object steps only
+  bool largest;      // Object at its largest scale rather than its smallest
+};
+
+struct BenchResult {
+  uint32_t meanUs;
+  uint32_t p99Us;
+  uint32_t spiBytes;  // Per frame
+  uint32_t heapBytes; // Most in use at the end of a frame
+};
+
+namespace {
+  bool benchActive = false;
+  uint8_t benchIndex = 0;           // Step running
+  uint16_t benchFrame = 0;          // Frames run in this step
+  uint32_t benchSamples[BENCH_FRAMES];
+  uint64_t benchSpiBytes = 0;
+  uint32_t benchHeapBytes = 0;
+  BenchResult benchResults[BENCH_STEPS];
+}
+
+/**
+ * True while a benchmark run is in progress
+ */
+inline bool benchRunning() {
+  return benchActive;
+}
+
+/**
+ * Starts a run from its first step, or restarts one in progress
+ */
+void benchStart() {
+  if (traceMode != TRACE_OFF) {
+    Serial.println("Benchmark: not while a trace records or replays");
+    return;
+  }
+  benchActive = true;
+  benchIndex = 0;
+  benchFrame = 0;
+  Serial.printf("Benchmark: %u steps of %u frames\n", (unsigned)BENCH_STEPS, (unsigned)BENCH_FRAMES);
+}
+
+/**
+ * The step running
+ */
+BenchStep benchStep() {
+  BenchStep step = {};
+  if (benchIndex < BENCH_WARP_STEPS) {
+    step.warp = true;
+    step.pot = BENCH_WARP_POTS[benchIndex];
+  } else {
+    step.object = (benchIndex - BENCH_WARP_STEPS) / 2;
+    step.largest = (benchIndex - BENCH_WARP_STEPS) % 2;
+  }
+  return step;
+}
+
+/**
+ * True on the first frame of a step, before its input: the caller sets the scene up
+ */
+inline bool benchStepBegins() {
+  return benchActive && benchFrame == 0;
+}
+
+/**
+ * Pot reading for processInput(): the step's while running, the live one otherwise
+ */
+inline int benchPot(int live) {
+  if (!benchActive) return live;
+  BenchStep step = benchStep();
+  return step.warp ? step.pot : 0;
+}
+
+/**
+ * Detail level for the frame: pinned to LOD_MAX while running
+ */
+inline uint8_t benchDetail(uint8_t live) {
+  return benchActive ? LOD_MAX : live;
+}
+
+/**
+ * Closes the step's samples into its result
+ */
+void benchFinishStep() {
+  uint32_t sorted[BENCH_FRAMES];
+  uint64_t total = 0;
+  for (int i = 0; i < BENCH_FRAMES; i++) {
+    uint32_t value = benchSamples[i];
+    total += value;
+    int j = i;
+    while (j > 0 && sorted[j - 1] > value) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  BenchResult& result = benchResults[benchIndex];
+  result.meanUs = (uint32_t)(total / BENCH_FRAMES);
+  result.p99Us = sorted[(BENCH_FRAMES - 1) * 99 / 100];
+  result.spiBytes = (uint32_t)(benchSpiBytes / BENCH_FRAMES);
+  result.heapBytes = benchHeapBytes;
+}
+
+/**
+ * Books a frame's work time, after profEndFrame(). Returns true when that
+ * frame ended the run; benchReport() prints it.
+ */
+bool benchRecord(uint32_t workUs) {
+  if (!benchActive) return false;
+  if (benchFrame == BENCH_SETTLE_FRAMES) {
+    benchSpiBytes = 0;
+    benchHeapBytes = 0;
+  }
+  if (benchFrame >= BENCH_SETTLE_FRAMES) {
+    benchSamples[benchFrame - BENCH_SETTLE_FRAMES] = workUs;
+    benchSpiBytes += profLatestCount(PROF_PANEL_BYTES);
+    benchHeapBytes = max(benchHeapBytes, (uint32_t)(ESP.getHeapSize() - ESP.getFreeHeap()));
+  }
+  if (++benchFrame < BENCH_SETTLE_FRAMES + BENCH_FRAMES) return false;
+
+  benchFinishStep();
+  benchFrame = 0;
+  if (++benchIndex < BENCH_STEPS) return false;
+  benchActive = false;
+  return true;
+}
+
+/**
+ * Prints the results of the last run, one row per step.
+ * objectNames holds BENCH_OBJECTS names in CelestialObject order.
+ */
+void benchReport(const char* const* objectNames) {
+  Serial.printf("Benchmark: render mode %d, %dx%d, %u frames per step\n", RENDER_MODE, SCREEN_WIDTH, SCREEN_HEIGHT,
+                (unsigned)BENCH_FRAMES);
+  Serial.printf("  %-16s %-5s %8s %8s %9s %9s\n", "step", "scale", "mean us", "p99 us", "spi B/f", "heap B");
+  for (int i = 0; i < (int)BENCH_STEPS; i++) {
+    const BenchResult& result = benchResults[i];
+    bool warp = i < (int)BENCH_WARP_STEPS;
+    const char* name = warp ? BENCH_WARP_NAMES[i] : objectNames[(i - BENCH_WARP_STEPS) / 2];
+    const char* scale = warp ? "" : ((i - BENCH_WARP_STEPS) % 2 ? "max" : "min");
+    Serial.printf("  %-16s %-5s %8lu %8lu %9lu %9lu\n", name, scale, (unsigned long)result.meanUs,
+                  (unsigned long)result.p99Us, (unsigned long)result.spiBytes, (unsigned long)result.heapBytes);
+  }
+  Serial.println("Benchmark: done");
+}
+
+#endif // BENCH_H
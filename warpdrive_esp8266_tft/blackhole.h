@@ -4,6 +4,13 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
 #include <SPI.h>
+#include "render.h"
+#include "simulation.h"
+#include "fixedpoint.h"
+#include "palette.h"
+#include "arena.h"
+#include "rng.h"
+#include "lens.h"
 
 // Color extraction functions (keep as they are)
 inline int red(uint16_t color) { return ((color >> 11) & 0x1F) << 3; }
@@ -14,48 +21,67 @@ inline int blue(uint16_t color) { return (color & 0x1F) << 3; }
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
 #define MAX_ACCRETION_PARTICLES 450
+#define MIN_ACCRETION_PARTICLES 150 // Disk particles kept at the lowest detail level
 #define MAX_FALLING_STARS 6
+#define MAX_FALLING_STAR_TRAIL 10   // Head plus stretch points per falling star
+#define FALLING_STAR_TRAIL_MS 600   // How long a consumed star keeps its trail
+#define BH_TRAIL_RING 512           // Trail pixels drawn per frame, power of two
+#define BH_NO_POS SCREEN_NO_COORD   // Packed coordinate for "not on screen"
+#define BH_HORIZON_RADIUS 14        // Event horizon radius at objectScale 1
+#define BH_MAX_SCALE (1.8f * PANEL_SCALE) // Largest objectScale processInput() picks for a black hole
 
-// Structs (keep as they are)
-struct AccretionParticle {
-  float angle;
-  float distance;
-  float speed;
-  int brightness;
-  int size; // Kept for compatibility, but not used in pixel drawing
-  int prevX, prevY;
-  uint16_t color;
-  bool active;
-  bool hasTrail;
-  float relativistic_factor;  // Add this for relativistic effects
-  float doppler_shift;       // Add this for color shifting
-  unsigned long trailStartTime;
-  unsigned long trailLifetime;
-  int trailX[8]; // Increase array size from 5 to 8 for longer trails
-  int trailY[8];
-  uint16_t trailColors[8]; // Add colors for each trail segment
-  int trailLength;
+// Particle state is kept as structure-of-arrays with packed screen coordinates
+// (bytes up to 254 px). The orbit update only walks the hot arrays.
+
+/**
+ * Accretion disk particles
+ */
+struct AccretionDisk {
+  // Hot: stepped every frame
+  fx_angle angle[MAX_ACCRETION_PARTICLES];   // Orbit angle (binary angle, wraps by itself)
+  q16_16 distance[MAX_ACCRETION_PARTICLES];  // Orbit radius in pixels
+  q16_16 speed[MAX_ACCRETION_PARTICLES];     // Binary-angle units per 1/60 s at the inner edge
+  // Cold: only read when drawing
+  uint16_t color[MAX_ACCRETION_PARTICLES];
+  screen_coord x[MAX_ACCRETION_PARTICLES];   // Last drawn position, BH_NO_POS if off-screen
+  screen_coord y[MAX_ACCRETION_PARTICLES];
+};
+
+/**
+ * Stars pulled in from the edges of the screen
+ */
+struct FallingStars {
+  float x[MAX_FALLING_STARS], y[MAX_FALLING_STARS];
+  float vx[MAX_FALLING_STARS], vy[MAX_FALLING_STARS];
+  float spinFactor[MAX_FALLING_STARS];
+  unsigned long startTime[MAX_FALLING_STARS];
+  uint8_t brightness[MAX_FALLING_STARS];
+  screen_coord drawX[MAX_FALLING_STARS];     // Head position, BH_NO_POS if off-screen
+  screen_coord drawY[MAX_FALLING_STARS];
+  uint8_t trailLength[MAX_FALLING_STARS];    // Trail pixels drawn this frame
+  bool active[MAX_FALLING_STARS];
+  bool hasTrail[MAX_FALLING_STARS];
 };
 
-struct FallingStar {
-  float x, y;
-  float vx, vy;
-  float distance;
-  int brightness;
-  int prevX, prevY;
-  bool active;
-  float spinFactor;
-  unsigned long startTime;
-  bool hasTrail;
-  unsigned long trailLifetime;
+/**
+ * Trail pixels drawn this frame by any particle, erased at the start of the next.
+ * Points are appended at head; frameStart marks the first one of the current frame.
+ */
+struct TrailRing {
+  screen_coord x[BH_TRAIL_RING];
+  screen_coord y[BH_TRAIL_RING];
+  uint16_t head;
+  uint16_t frameStart;
 };
 
+#define BLACK_HOLE_ARENA_BYTES (ARENA_SIZE(AccretionDisk, 1) + ARENA_SIZE(FallingStars, 1) + \
+                                ARENA_SIZE(TrailRing, 1) + LENS_BYTES(BH_HORIZON_RADIUS * BH_MAX_SCALE))
+
 // Function prototypes
 void initializeAccretionParticle(int index, int centerX, int centerY);
-void calculateTrailColors(AccretionParticle &particle);
 
 // Global variables for black hole animation
-extern TFT_eSPI tft;
+extern TFT_eSPI& canvas; // Draw target for erasing, see render.h
 extern uint16_t BG_COLOR; // Assuming this is your background color (e.g., black)
 
 // Object position and scale
@@ -69,59 +95,88 @@ float diskOuterRadius;
 int prevBlackHoleX = -1000, prevBlackHoleY = -1000; // Initialize off-screen
 float previousEventHorizonRadius = 0; // Use float for radius comparison
 bool blackHoleInitialized = false;
-unsigned long blackHoleLastUpdateTime;
-
-// Global arrays
-AccretionParticle accretionDisk[MAX_ACCRETION_PARTICLES];
-FallingStar fallingStars[MAX_FALLING_STARS];
-
-// Lens tracking
-int previousLensPoints[60][2];
-// Falling star trails tracking (moved to global scope for persistence)
-int prevTrailX[10][MAX_FALLING_STARS];
-int prevTrailY[10][MAX_FALLING_STARS];
-int trailLen[MAX_FALLING_STARS];
+
+// Particle state, taken from the object arena by initBlackHole()
+AccretionDisk* accretionDisk = nullptr;
+int accretionLive = 0; // Disk particles stepped last frame; the rest are off screen
+FallingStars* fallingStars = nullptr;
+TrailRing* bhTrail = nullptr;
+
 // Inner particle tracking (moved to global scope)
 int prevInnerParticleX[4] = {-1, -1, -1, -1};
 int prevInnerParticleY[4] = {-1, -1, -1, -1};
 
+/**
+ * Packs a screen coordinate, BH_NO_POS if it is off-screen
+ */
+inline screen_coord packScreenCoord(int v, int limit) {
+    return (v >= 0 && v < limit) ? v : BH_NO_POS;
+}
+
+/**
+ * Records an on-screen trail pixel so it can be erased next frame.
+ * Returns false if the ring is full; the pixel must not be drawn then.
+ */
+inline bool pushTrailPoint(int x, int y) {
+    uint16_t next = (bhTrail->head + 1) & (BH_TRAIL_RING - 1);
+    if (next == bhTrail->frameStart) return false;
+    bhTrail->x[bhTrail->head] = x;
+    bhTrail->y[bhTrail->head] = y;
+    bhTrail->head = next;
+    return true;
+}
+
+/**
+ * Accretion disk particles to simulate and draw at a detail level (see lod.h)
+ */
+int blackHoleDetailBudget(uint8_t detail) {
+    return lodBudget(detail, MIN_ACCRETION_PARTICLES, MAX_ACCRETION_PARTICLES);
+}
+
+/**
+ * Takes the particle state from the object arena, the first draw fills it in,
+ * and builds the lens for the horizon; it only depends on objectScale, so it
+ * stays valid for the whole discovery
+ */
+void initBlackHole() {
+    accretionDisk = arenaAlloc<AccretionDisk>();
+    fallingStars = arenaAlloc<FallingStars>();
+    bhTrail = arenaAlloc<TrailRing>();
+    lensBuild(BH_HORIZON_RADIUS * objectScale);
+    blackHoleInitialized = false;
+}
 
 void drawBlackHole() {
     int centerX = objectX;
     int centerY = objectY;
     float scale = objectScale;
-    unsigned long currentTime = millis();
+    unsigned long currentTime = simInputs.clock.timeMs;
+    const int activeParticles = blackHoleDetailBudget(simInputs.detail);
 
     // Calculate radii based on scale for this frame
-    blackHoleRadius = 14 * scale;  // Event horizon radius
+    blackHoleRadius = BH_HORIZON_RADIUS * scale;  // Event horizon radius
     diskInnerRadius = blackHoleRadius * 1.2;
     diskOuterRadius = blackHoleRadius * 2.0; // Adjusted slightly
 
     // Initialize black hole system on first run
     if (!blackHoleInitialized) {
-        // Initialize accretion disk particles
+        // Initialize accretion disk particles, orbit angles first
+        objectRng.fill(accretionDisk->angle, MAX_ACCRETION_PARTICLES, 0, 65536);
         for (int i = 0; i < MAX_ACCRETION_PARTICLES; i++) {
             initializeAccretionParticle(i, centerX, centerY);
         }
+        accretionLive = 0;
 
         // Initialize falling stars (inactive at first)
         for (int i = 0; i < MAX_FALLING_STARS; i++) {
-            fallingStars[i].active = false;
-            fallingStars[i].hasTrail = false;
-            fallingStars[i].prevX = -1;
-            fallingStars[i].prevY = -1;
-            trailLen[i] = 0; // Initialize trail length
-            for(int t=0; t<10; ++t) { // Initialize trail arrays
-                prevTrailX[t][i] = -1;
-                prevTrailY[t][i] = -1;
-            }
-        }
-
-        // Initialize lens tracking array
-        for (int i = 0; i < 60; i++) {
-            previousLensPoints[i][0] = -1;
-            previousLensPoints[i][1] = -1;
+            fallingStars->active[i] = false;
+            fallingStars->hasTrail[i] = false;
+            fallingStars->drawX[i] = BH_NO_POS;
+            fallingStars->drawY[i] = BH_NO_POS;
+            fallingStars->trailLength[i] = 0;
         }
+        bhTrail->head = 0;
+        bhTrail->frameStart = 0;
 
         // Initialize inner particle tracking
         for(int i=0; i<4; ++i) {
@@ -134,18 +189,18 @@ void drawBlackHole() {
         prevBlackHoleY = centerY;
         previousEventHorizonRadius = blackHoleRadius;
 
-        blackHoleLastUpdateTime = currentTime;
         blackHoleInitialized = true;
     }
 
-    float deltaTime = (currentTime - blackHoleLastUpdateTime) / 1000.0f;
+    float deltaTime = simInputs.clock.deltaUs / 1000000.0f;
     if (deltaTime > 0.1f) deltaTime = 0.1f; // Cap to avoid huge jumps
-    if (deltaTime <= 0) deltaTime = 0.016; // Prevent division by zero or negative time if millis() wraps or glitches
-    blackHoleLastUpdateTime = currentTime;
 
     // --- Erasing Section ---
+    // With a full redraw the frame starts empty, so only the per-frame trail
+    // resets below are kept.
 
-    // Erase old black hole center and lens points ONLY if it moved or size changed significantly
+#if !RENDER_FULL_REDRAW
+    // Erase old black hole center ONLY if it moved or size changed significantly
     bool blackHoleMovedOrResized = (centerX != prevBlackHoleX || centerY != prevBlackHoleY ||
                                    abs(blackHoleRadius - previousEventHorizonRadius) > 0.5); // Check float difference threshold
 
@@ -153,184 +208,105 @@ void drawBlackHole() {
         // Erase the old event horizon position and photon rings area
         // Make erase radius slightly larger to catch photon rings and potential artifacts
         float eraseRadius = previousEventHorizonRadius + 4;
-        tft.fillCircle(prevBlackHoleX, prevBlackHoleY, eraseRadius, BG_COLOR);
-
-        // Erase old lens points when black hole moves/resizes
-        for (int i = 0; i < 60; i++) {
-            if (previousLensPoints[i][0] >= 0) {
-                tft.drawPixel(previousLensPoints[i][0], previousLensPoints[i][1], BG_COLOR);
-                previousLensPoints[i][0] = -1; // Mark as erased
-            }
-        }
+        simFillCircle(prevBlackHoleX, prevBlackHoleY, eraseRadius, BG_COLOR);
     }
+#endif
 
-    // Erase previous accretion disk particles (both halves) and trails
-    for (int i = 0; i < MAX_ACCRETION_PARTICLES; i++) {
-        if (accretionDisk[i].prevX >= 0) { // Check if it had a valid previous position
-            tft.drawPixel(accretionDisk[i].prevX, accretionDisk[i].prevY, BG_COLOR);
-        }
-        // Erase previous trails regardless of prevX validity (for fading trails)
-        for (int t = 0; t < accretionDisk[i].trailLength; t++) {
-             if (accretionDisk[i].trailX[t] >= 0) {
-                 tft.drawPixel(accretionDisk[i].trailX[t], accretionDisk[i].trailY[t], BG_COLOR);
-             }
-        }
-        // Clear the trail positions for the next frame *after* erasing
-        accretionDisk[i].trailLength = 0;
-        for(int t=0; t<8; ++t) {
-            accretionDisk[i].trailX[t] = -1;
-            accretionDisk[i].trailY[t] = -1;
+#if !RENDER_FULL_REDRAW
+    // Erase previous accretion disk particles (both halves); only last frame's were drawn
+    for (int i = 0; i < accretionLive; i++) {
+        if (accretionDisk->x[i] != BH_NO_POS) { // Check if it had a valid previous position
+            simCanvas.drawPixel(accretionDisk->x[i], accretionDisk->y[i], BG_COLOR);
         }
     }
 
-
-    // Erase previous falling stars and their trails
+    // Erase last frame's trails (disk inner edge and falling stars, heads included)
+    for (uint16_t t = bhTrail->frameStart; t != bhTrail->head; t = (t + 1) & (BH_TRAIL_RING - 1)) {
+        simCanvas.drawPixel(bhTrail->x[t], bhTrail->y[t], BG_COLOR);
+    }
+#endif
+    bhTrail->frameStart = bhTrail->head;
     for (int i = 0; i < MAX_FALLING_STARS; i++) {
-        // Erase all previous trail points for this star (includes head at index 0 if trailLen > 0)
-        for (int t = 0; t < trailLen[i]; t++) {
-            if (prevTrailX[t][i] >= 0) {
-                tft.drawPixel(prevTrailX[t][i], prevTrailY[t][i], BG_COLOR);
-            }
-             // Clear the specific trail point after erasing
-            prevTrailX[t][i] = -1;
-            prevTrailY[t][i] = -1;
-        }
-         trailLen[i] = 0; // Reset trail length after erasing all points
+        fallingStars->trailLength[i] = 0; // Reset trail length after erasing all points
     }
 
+#if !RENDER_FULL_REDRAW
     // Erase previous inner particles
     for (int i = 0; i < 4; i++) {
         if (prevInnerParticleX[i] >= 0) {
-            tft.drawPixel(prevInnerParticleX[i], prevInnerParticleY[i], BG_COLOR);
+            simCanvas.drawPixel(prevInnerParticleX[i], prevInnerParticleY[i], BG_COLOR);
              prevInnerParticleX[i] = -1; // Mark as erased
              prevInnerParticleY[i] = -1;
         }
     }
+#endif
     // --- End Erasing Section ---
 
 
     // --- Update Section (Physics and Logic) ---
 
-    // Update Accretion Disk particles
-    for (int i = 0; i < MAX_ACCRETION_PARTICLES; i++) {
-        // Store previous position *before* updating, if it was valid
-        int lastValidX = accretionDisk[i].prevX;
-        int lastValidY = accretionDisk[i].prevY;
-        accretionDisk[i].prevX = -1; // Assume invalid until new position is calculated
-
-        if (!accretionDisk[i].active) {
-            // Handle fading trail for inactive particles
-            if (accretionDisk[i].hasTrail) {
-                if (millis() - accretionDisk[i].trailStartTime > accretionDisk[i].trailLifetime) {
-                    accretionDisk[i].hasTrail = false;
-                    // Reinitialize the particle once trail fades
-                    initializeAccretionParticle(i, centerX, centerY);
-                } else {
-                    // Keep the last position for trail rendering (if needed, but erase handles cleanup)
-                     accretionDisk[i].prevX = lastValidX;
-                     accretionDisk[i].prevY = lastValidY;
-                }
-            } else { // Inactive and no trail
-                 initializeAccretionParticle(i, centerX, centerY);
-            }
-            continue; // Skip active processing for inactive/fading particles
-        }
+    // Per-frame constants for the fixed-point particle loop
+    float currentDiskInnerRadius = max(1.0f, blackHoleRadius * 1.2f); // Ensure non-zero radius
+    const q16_16 innerRadiusFx = fxFromFloat(currentDiskInnerRadius);
+    const q16_16 sqrtInnerRadius = fxSqrt(innerRadiusFx);
+    const q16_16 minSpinDistance = innerRadiusFx / 2;  // Prevent extreme speed very close in
+    const q16_16 minDistance = innerRadiusFx / 10;     // Prevent going too close if BH shrinks rapidly
+    const q16_16 maxDistance = fxFromFloat(diskOuterRadius * 1.1f);
+    const q16_16 frameSteps = fxFromFloat(deltaTime * 60); // Speeds are per 1/60 s
+    const q16_16 originX = FX_FROM_INT(centerX);
+    const q16_16 originY = FX_FROM_INT(centerY);
 
-        // Update angle (Keplerian motion)
-        float currentDiskInnerRadius = max(1.0f, blackHoleRadius * 1.2f); // Ensure non-zero radius
-        float spinFactor = sqrt(currentDiskInnerRadius / max(accretionDisk[i].distance, currentDiskInnerRadius * 0.5f)); // Prevent extreme speed/div by zero very close in
-        accretionDisk[i].angle += accretionDisk[i].speed * spinFactor * deltaTime * 60; // Scale speed with deltaTime
-        accretionDisk[i].angle = fmod(accretionDisk[i].angle, 2.0f * PI); // Keep angle in range [0, 2*PI)
-        if (accretionDisk[i].angle < 0) accretionDisk[i].angle += 2.0f * PI;
+    // Update Accretion Disk particles
+    accretionLive = activeParticles;
+    for (int i = 0; i < activeParticles; i++) {
+        // Update angle (Keplerian motion): spin = sqrt(inner / distance)
+        q16_16 distance = accretionDisk->distance[i];
+        q16_16 spinFactor = fxDivSqrt(sqrtInnerRadius, max(distance, minSpinDistance));
+        fx_angle angle = accretionDisk->angle[i] + (fxMul(fxMul(accretionDisk->speed[i], spinFactor), frameSteps) >> FX_SHIFT);
+        accretionDisk->angle[i] = angle;
 
         // Update distance (inward spiral) - COMMENTED OUT FOR ENDLESS ROTATION
         /*
         float currentDiskOuterRadius = max(currentDiskInnerRadius + 1.0f, blackHoleRadius * 2.0f);
         float distRange = currentDiskOuterRadius - currentDiskInnerRadius;
-        float distanceRatio = (distRange > 0.1f) ? (accretionDisk[i].distance - currentDiskInnerRadius) / distRange : 0.0f;
+        float distanceRatio = (distRange > 0.1f) ? (fxToFloat(accretionDisk->distance[i]) - currentDiskInnerRadius) / distRange : 0.0f;
         distanceRatio = constrain(distanceRatio, 0.0f, 1.0f);
         float inwardForce = 0.01f + (1.0f - distanceRatio) * 0.03f; // Slower base inward pull
-        accretionDisk[i].distance *= (1.0f - inwardForce * deltaTime * 5); // Scale inward pull with deltaTime, reduced factor
+        distance = fxMul(distance, fxFromFloat(1.0f - inwardForce * deltaTime * 5)); // Scale inward pull with deltaTime, reduced factor
         */
 
         // Ensure distance doesn't go below a minimum or too far out (can happen with large deltaTime steps)
         // Keep this check slightly, but maybe adjust the lower bound if not consuming
-        accretionDisk[i].distance = max(accretionDisk[i].distance, currentDiskInnerRadius * 0.1f); // Prevent going too close if BH shrinks rapidly
-        accretionDisk[i].distance = min(accretionDisk[i].distance, diskOuterRadius * 1.1f); // Use calculated outer radius
+        distance = max(distance, minDistance);
+        distance = min(distance, maxDistance); // Use calculated outer radius
+        accretionDisk->distance[i] = distance;
 
-        // Calculate relativistic factor (near horizon particles move faster)
-        float distRatio = max(0.1f, (accretionDisk[i].distance - diskInnerRadius) / max(1.0f, (diskOuterRadius - diskInnerRadius)));
-        accretionDisk[i].relativistic_factor = 0.8f + (1.0f - distRatio) * 2.0f; // Higher near inner edge
-        
         // Calculate new position...
-        float angle = accretionDisk[i].angle;
-        float distance = accretionDisk[i].distance;
-        float verticalCompression = 0.5f - 0.3f * cos(angle); // Perspective effect
-        float floatX = centerX + cos(angle) * distance;
-        float floatY = centerY + sin(angle) * distance * verticalCompression;
-
-        // Round coordinates for drawing and storing previous position
-        int x = round(floatX);
-        int y = round(floatY);
-
-        // Trail calculation - shift existing trail points
-        if (accretionDisk[i].active) {
-            // Create a trail based on velocity
-            if (accretionDisk[i].prevX >= 0) { // Has valid previous position
-                // Only add new trail point if we've moved enough
-                float dist = sqrt(sq(x - accretionDisk[i].prevX) + sq(y - accretionDisk[i].prevY));
-                
-                if (dist > (0.5f + accretionDisk[i].relativistic_factor * 0.5f)) {
-                    // Shift existing trail points
-                    for (int t = 7; t > 0; t--) {
-                        accretionDisk[i].trailX[t] = accretionDisk[i].trailX[t-1];
-                        accretionDisk[i].trailY[t] = accretionDisk[i].trailY[t-1];
-                    }
-                    
-                    // Add new position to trail
-                    accretionDisk[i].trailX[0] = accretionDisk[i].prevX;
-                    accretionDisk[i].trailY[0] = accretionDisk[i].prevY;
-                    
-                    // Calculate colors for trail segments
-                    calculateTrailColors(accretionDisk[i]);
-                    
-                    // Update trail length, capped at array size
-                    accretionDisk[i].trailLength = min(8, accretionDisk[i].trailLength + 1);
-                }
-            }
-        }
-        
-        // Store current position for next frame's erase & trail
-        accretionDisk[i].prevX = x;
-        accretionDisk[i].prevY = y;
+        q16_16 cosAngle = fxCos(angle);
+        q16_16 verticalCompression = FX_HALF - fxMul(FX_CONST(0.3), cosAngle); // Perspective effect
+        int x = fxRound(originX + fxMul(cosAngle, distance));
+        int y = fxRound(originY + fxMul(fxMul(fxSin(angle), distance), verticalCompression));
+
+        // Store current position for next frame's erase
+        bool onScreen = x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT;
+        accretionDisk->x[i] = onScreen ? x : BH_NO_POS;
+        accretionDisk->y[i] = onScreen ? y : BH_NO_POS;
     }
 
 
     // Update Falling Stars
     for (int i = 0; i < MAX_FALLING_STARS; i++) {
-         // Store previous position *before* updating
-        int lastValidX = fallingStars[i].prevX;
-        int lastValidY = fallingStars[i].prevY;
-        fallingStars[i].prevX = -1; // Assume invalid until new calculation
-
-         if (!fallingStars[i].active) {
-             if (fallingStars[i].hasTrail) {
-                 if (millis() - fallingStars[i].startTime > fallingStars[i].trailLifetime) {
-                     fallingStars[i].hasTrail = false; // Trail faded completely
-                 } else {
-                     // Keep last valid position if trail is still fading (for erase logic)
-                     fallingStars[i].prevX = lastValidX;
-                     fallingStars[i].prevY = lastValidY;
-                 }
+         if (!fallingStars->active[i]) {
+             if (fallingStars->hasTrail[i] && currentTime - fallingStars->startTime[i] > FALLING_STAR_TRAIL_MS) {
+                 fallingStars->hasTrail[i] = false; // Trail faded completely
              }
              continue; // Skip inactive stars
          }
 
-        float dx = centerX - fallingStars[i].x;
-        float dy = centerY - fallingStars[i].y;
+        float dx = centerX - fallingStars->x[i];
+        float dy = centerY - fallingStars->y[i];
         float distSq = dx*dx + dy*dy;
         float dist = sqrt(distSq);
-        fallingStars[i].distance = dist;
 
         if (dist > 0.1f) { // Avoid division by zero
             // Gravity (1/r^2)
@@ -345,105 +321,98 @@ void drawBlackHole() {
                 float perpY = dx / dist;
                 float spinRadius = blackHoleRadius * 4.0f;
                 float effectiveDist = max(dist, spinRadius * 0.1f); // Avoid extreme strength very close
-                float spinStrength = fallingStars[i].spinFactor * 1.5f * (spinRadius / effectiveDist); // Tuned spin strength
+                float spinStrength = fallingStars->spinFactor[i] * 1.5f * (spinRadius / effectiveDist); // Tuned spin strength
                 spinStrength = min(spinStrength, 8.0f); // Cap spin strength
                 accX += perpX * spinStrength; // Add tangential acceleration
                 accY += perpY * spinStrength;
             }
 
              // Update velocity using acceleration and deltaTime
-            fallingStars[i].vx += accX * deltaTime;
-            fallingStars[i].vy += accY * deltaTime;
+            fallingStars->vx[i] += accX * deltaTime;
+            fallingStars->vy[i] += accY * deltaTime;
 
              // Optional: Limit maximum speed to prevent instability
-             float speedSq = fallingStars[i].vx * fallingStars[i].vx + fallingStars[i].vy * fallingStars[i].vy;
+             float speedSq = fallingStars->vx[i] * fallingStars->vx[i] + fallingStars->vy[i] * fallingStars->vy[i];
              float maxSpeedSq = 400.0f; // Max speed squared (e.g., 20 pixels per frame equiv)
              if (speedSq > maxSpeedSq) {
                  float speedScale = sqrt(maxSpeedSq / speedSq);
-                 fallingStars[i].vx *= speedScale;
-                 fallingStars[i].vy *= speedScale;
+                 fallingStars->vx[i] *= speedScale;
+                 fallingStars->vy[i] *= speedScale;
              }
 
         }
 
         // Update position using velocity and deltaTime
-        fallingStars[i].x += fallingStars[i].vx * deltaTime;
-        fallingStars[i].y += fallingStars[i].vy * deltaTime;
+        fallingStars->x[i] += fallingStars->vx[i] * deltaTime;
+        fallingStars->y[i] += fallingStars->vy[i] * deltaTime;
 
-        int x = round(fallingStars[i].x);
-        int y = round(fallingStars[i].y);
+        int x = round(fallingStars->x[i]);
+        int y = round(fallingStars->y[i]);
 
         // Check for consumption or out of bounds
         // Use distance calculated from float position for accuracy
         if (dist <= blackHoleRadius || x < -10 || x >= SCREEN_WIDTH + 10 || y < -10 || y >= SCREEN_HEIGHT + 10) { // Wider bounds check
-            fallingStars[i].active = false;
+            fallingStars->active[i] = false;
 
             // If star was consumed (close enough), trigger consumption effect and trail fade
              if (dist <= blackHoleRadius * 1.5f) { // Only flash if consumed near BH
                 // Instantaneous flash effect (draw immediately)
-                float consumptionAngle = atan2(fallingStars[i].y - centerY, fallingStars[i].x - centerX);
+                float consumptionAngle = atan2(fallingStars->y[i] - centerY, fallingStars->x[i] - centerX);
                 for (int r = 0; r <= 2; r++) {
                     for (int j = 0; j < 8; j++) {
                          float angle = j * PI / 4.0f;
                          int flashX = round(centerX + cos(angle) * (blackHoleRadius + r));
                          int flashY = round(centerY + sin(angle) * (blackHoleRadius + r));
                          if (flashX >= 0 && flashX < SCREEN_WIDTH && flashY >= 0 && flashY < SCREEN_HEIGHT) {
-                             tft.drawPixel(flashX, flashY, TFT_WHITE); // Simple white flash
+                             simCanvas.drawPixel(flashX, flashY, TFT_WHITE); // Simple white flash
                          }
                     }
                 }
                 // Start trail fade
-                fallingStars[i].hasTrail = true;
-                fallingStars[i].trailLifetime = 600;
-                fallingStars[i].startTime = millis(); // Reset timer for trail fade
+                fallingStars->hasTrail[i] = true;
+                fallingStars->startTime[i] = currentTime; // Reset timer for trail fade
              } else {
                  // If star just went out of bounds far away, don't necessarily start a trail fade
-                 fallingStars[i].hasTrail = false;
+                 fallingStars->hasTrail[i] = false;
              }
-             // Keep the last valid position for erase/trail logic
-             fallingStars[i].prevX = lastValidX;
-             fallingStars[i].prevY = lastValidY;
              continue; // Stop processing this star
         }
 
-        // Store current calculated position for next frame's erase & this frame's draw
-        fallingStars[i].prevX = x;
-        fallingStars[i].prevY = y;
+        // Store current calculated position for this frame's draw
+        fallingStars->drawX[i] = packScreenCoord(x, SCREEN_WIDTH);
+        fallingStars->drawY[i] = packScreenCoord(y, SCREEN_HEIGHT);
     }
 
 
     // Randomly create new falling stars
-    if (random(100) < 4) { // Reduced frequency
+    if (objectRng.below(100) < 4) { // Reduced frequency
         for (int i = 0; i < MAX_FALLING_STARS; i++) {
-            if (!fallingStars[i].active && !fallingStars[i].hasTrail) { // Only activate if truly inactive
-                fallingStars[i].active = true;
-                fallingStars[i].hasTrail = false;
-                fallingStars[i].startTime = currentTime;
-                fallingStars[i].brightness = random(180, 256);
-                fallingStars[i].spinFactor = random(50, 200) / 100.0f; // Reduced max spin slightly
-
-                int edge = random(4);
+            if (!fallingStars->active[i] && !fallingStars->hasTrail[i]) { // Only activate if truly inactive
+                fallingStars->active[i] = true;
+                fallingStars->hasTrail[i] = false;
+                fallingStars->startTime[i] = currentTime;
+                fallingStars->brightness[i] = objectRng.range(180, 256);
+                fallingStars->spinFactor[i] = objectRng.range(50, 200) / 100.0f; // Reduced max spin slightly
+
+                int edge = objectRng.below(4);
                 switch (edge) {
-                     case 0: fallingStars[i].x = random(SCREEN_WIDTH); fallingStars[i].y = -5; break; // Start slightly off screen
-                     case 1: fallingStars[i].x = SCREEN_WIDTH + 4; fallingStars[i].y = random(SCREEN_HEIGHT); break;
-                     case 2: fallingStars[i].x = random(SCREEN_WIDTH); fallingStars[i].y = SCREEN_HEIGHT + 4; break;
-                     case 3: fallingStars[i].x = -5; fallingStars[i].y = random(SCREEN_HEIGHT); break;
+                     case 0: fallingStars->x[i] = objectRng.below(SCREEN_WIDTH); fallingStars->y[i] = -5; break; // Start slightly off screen
+                     case 1: fallingStars->x[i] = SCREEN_WIDTH + 4; fallingStars->y[i] = objectRng.below(SCREEN_HEIGHT); break;
+                     case 2: fallingStars->x[i] = objectRng.below(SCREEN_WIDTH); fallingStars->y[i] = SCREEN_HEIGHT + 4; break;
+                     case 3: fallingStars->x[i] = -5; fallingStars->y[i] = objectRng.below(SCREEN_HEIGHT); break;
                 }
 
-                float dx = centerX - fallingStars[i].x;
-                float dy = centerY - fallingStars[i].y;
-                float dist = sqrt(dx*dx + dy*dy);
-                fallingStars[i].distance = dist;
+                float dx = centerX - fallingStars->x[i];
+                float dy = centerY - fallingStars->y[i];
                 float angle_to_center = atan2(dy, dx);
-                float angle_offset = (random(-10, 10) * PI / 180.0f); // Smaller offset
+                float angle_offset = (objectRng.range(-10, 10) * PI / 180.0f); // Smaller offset
                 float initial_angle = angle_to_center + angle_offset;
 
-                float initialSpeed = random(4, 10) / 10.0f; // Slower start speed
-                fallingStars[i].vx = cos(initial_angle) * initialSpeed;
-                fallingStars[i].vy = sin(initial_angle) * initialSpeed;
-                fallingStars[i].prevX = -1; // Initialize prev position as invalid
-                fallingStars[i].prevY = -1;
-                trailLen[i] = 0; // Reset trail length for new star
+                float initialSpeed = objectRng.range(4, 10) / 10.0f; // Slower start speed
+                fallingStars->vx[i] = cos(initial_angle) * initialSpeed;
+                fallingStars->vy[i] = sin(initial_angle) * initialSpeed;
+                fallingStars->drawX[i] = BH_NO_POS; // Initialize position as invalid
+                fallingStars->drawY[i] = BH_NO_POS;
                 break; // Activate only one star per check
             }
         }
@@ -454,76 +423,79 @@ void drawBlackHole() {
 
     // --- Drawing Section (Reordered) ---
 
+    // Squared radii for the per-pixel horizon and boost tests
+    const int horizonRadius = round(blackHoleRadius);
+    const int horizonSq = sq(horizonRadius); // Use sq(round(...)) for consistency with fillCircle
+    const q16_16 boostRadius = fxFromFloat(blackHoleRadius * 1.6f);
+    const q16_16 innerTrailRadius = fxFromFloat(blackHoleRadius * 1.4f);
+    const q16_16 horizonFx = fxFromFloat(blackHoleRadius);
+    const q16_16 invBoostWidth = (blackHoleRadius > 0) ? fxFromFloat(1.0f / (blackHoleRadius * 0.6f)) : 0;
+
    // 1. Draw Back Half of Accretion Disk (Top half, sin(angle) <= 0)
-for (int i = 0; i < MAX_ACCRETION_PARTICLES; i++) {
-    if (!accretionDisk[i].active || accretionDisk[i].prevX < 0) continue; // Skip inactive or invalid position
-    if (sin(accretionDisk[i].angle) > 0) continue; // Skip front half
+for (int i = 0; i < activeParticles; i++) {
+    if (accretionDisk->x[i] == BH_NO_POS) continue; // Skip off-screen particles
+    q16_16 sinAngle = fxSin(accretionDisk->angle[i]);
+    if (sinAngle > 0) continue; // Skip front half
 
-    int x = accretionDisk[i].prevX; // Use the calculated position from the update phase
-    int y = accretionDisk[i].prevY;
+    int x = accretionDisk->x[i]; // Use the calculated position from the update phase
+    int y = accretionDisk->y[i];
 
-    // Check bounds again before drawing
-    if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
+    {
+#if !BH_LENS
         // *** Add check: Don't draw back-half pixels inside the event horizon ***
-        float distSqFromCenter = sq(x - centerX) + sq(y - centerY);
-        if (distSqFromCenter <= sq(round(blackHoleRadius))) { // Use sq(round(...)) for consistency with fillCircle
+        // (with the lens they are kept: it bends them around the horizon, which covers the rest)
+        int distSqFromCenter = sq(x - centerX) + sq(y - centerY);
+        if (distSqFromCenter <= horizonSq) {
             continue; // Skip drawing this pixel, it's inside/on the horizon edge
         }
+#endif
 
         // UNIFIED Visibility Factor calculated here (or could be calculated once before both loops if preferred)
-        float visibilityFactor = 0.8f + 0.4f * sin(accretionDisk[i].angle); // Ranges from 0.4 (back) to 0.8 (sides)
-        visibilityFactor = max(0.1f, visibilityFactor); // Ensure minimum visibility
+        q8_8 visibilityFactor = FX8_CONST(0.8) + (fxMul(FX_CONST(0.4), sinAngle) >> 8); // Ranges from 0.4 (back) to 0.8 (sides)
+        visibilityFactor = max(visibilityFactor, FX8_CONST(0.1)); // Ensure minimum visibility
 
-        uint16_t baseColor = accretionDisk[i].color;
-        int r = red(baseColor) * visibilityFactor;
-        int g = green(baseColor) * visibilityFactor;
-        int b = blue(baseColor) * visibilityFactor;
+        uint16_t baseColor = accretionDisk->color[i];
+        int r = fx8Scale(red(baseColor), visibilityFactor);
+        int g = fx8Scale(green(baseColor), visibilityFactor);
+        int b = fx8Scale(blue(baseColor), visibilityFactor);
 
         // Maybe add a slight ambient minimum brightness if particles become too dim at the back
         r = max(r, 30); // Adjust minimum thresholds as needed
         g = max(g, 25);
         b = max(b, 20);
 
-        uint16_t finalColor = tft.color565(r, g, b);
-        tft.drawPixel(x, y, finalColor);
-
-        // Draw the trail for this particle (no changes needed here)
-        for (int t = 0; t < accretionDisk[i].trailLength; t++) {
-            int trailX = accretionDisk[i].trailX[t];
-            int trailY = accretionDisk[i].trailY[t];
-
-            if (trailX < 0 || trailY < 0 || trailX >= SCREEN_WIDTH || trailY >= SCREEN_HEIGHT) continue;
-
-            float trailDistSq = sq(trailX - centerX) + sq(trailY - centerY);
-            if (trailDistSq <= sq(round(blackHoleRadius))) continue;
-
-            tft.drawPixel(trailX, trailY, accretionDisk[i].trailColors[t]);
-        }
+        uint16_t finalColor = simCanvas.color565(r, g, b);
+        simCanvas.drawPixel(x, y, finalColor);
     }
 }
 
 
-    // 2. Draw the Black Hole Event Horizon (Black Center)
+    // 2. Bend the starfield and the back of the disk around the hole (lens.h);
+    // everything drawn from here on is in front of it
+    simApplyLens(centerX, centerY);
+
+    // 3. Draw the Black Hole Event Horizon (Black Center)
     if (blackHoleRadius >= 0.5) { // Draw if radius is at least half a pixel
          // Use TFT_BLACK directly for the event horizon singularity
-        tft.fillCircle(centerX, centerY, round(blackHoleRadius), TFT_BLACK);
+        simFillCircle(centerX, centerY, horizonRadius, TFT_BLACK);
     }
 
-    // 3. Draw Inner swirling particles (on top of black hole, behind stars/front disk)
+    // 4. Draw Inner swirling particles (on top of black hole, behind stars/front disk)
+    const fx_angle swirlAngle = fxAngleFromRadians(fmodf(currentTime / 90.0f, 2.0f * PI)); // Slower swirl
     for (int i = 0; i < 4; i++) {
-        float innerAngle = fmod((currentTime / 90.0f) + i * (PI/2.0f), 2.0f * PI); // Slower swirl, ensure range
+        fx_angle innerAngle = swirlAngle + i * FX_QUARTER_TURN;
         float distanceFactor = 0.15f + 0.6f * (float)i/4.0f; // Start closer to center
         // Ensure distance factor doesn't go beyond 1 inside the radius
         distanceFactor = min(distanceFactor, 0.9f);
-        int innerX = round(centerX + cos(innerAngle) * blackHoleRadius * distanceFactor);
-        int innerY = round(centerY + sin(innerAngle) * blackHoleRadius * distanceFactor);
+        q16_16 innerRadius = fxFromFloat(blackHoleRadius * distanceFactor);
+        int innerX = fxRound(originX + fxMul(fxCos(innerAngle), innerRadius));
+        int innerY = fxRound(originY + fxMul(fxSin(innerAngle), innerRadius));
 
         // Check bounds before drawing
         if (innerX >= 0 && innerX < SCREEN_WIDTH && innerY >= 0 && innerY < SCREEN_HEIGHT) {
             int brightness = 50 - 12 * i; // Fainter overall
             brightness = max(10, brightness); // Minimum brightness
-            uint16_t innerColor = tft.color565(brightness, brightness, brightness);
-            tft.drawPixel(innerX, innerY, innerColor);
+            simCanvas.drawPixel(innerX, innerY, PAL_GREY.v[brightness]);
             prevInnerParticleX[i] = innerX; // Store for next erase
             prevInnerParticleY[i] = innerY;
         } else {
@@ -533,103 +505,61 @@ for (int i = 0; i < MAX_ACCRETION_PARTICLES; i++) {
         }
     }
 
-    // 4. Draw Photon Ring (on top of black hole, inner swirls)
+    // 5. Draw Photon Ring (on top of black hole, inner swirls)
     if (blackHoleRadius >= 0.5) {
-        int r_bh = round(blackHoleRadius);
+        int r_bh = horizonRadius;
         // Primary ring (brightest)
-        uint16_t photonRingColor = tft.color565(255, 230, 180);
-        tft.drawCircle(centerX, centerY, r_bh, photonRingColor);
+        uint16_t photonRingColor = simCanvas.color565(255, 230, 180);
+        simDrawCircle(centerX, centerY, r_bh, photonRingColor);
         // Highlight at the front (bottom side, appears brighter due to Doppler/viewing angle)
-        for (float angle = PI * 0.75f; angle < PI * 1.25f; angle += 0.04f) { // Adjusted angle range/step
-            int x = round(centerX + r_bh * cos(angle));
-            int y = round(centerY + r_bh * sin(angle));
+        const fx_angle highlightStep = 417; // ~0.04 rad
+        for (fx_angle angle = 0x6000; angle < 0xA000; angle += highlightStep) { // 0.75 pi to 1.25 pi
+            int x = fxRound(originX + fxCos(angle) * r_bh);
+            int y = fxRound(originY + fxSin(angle) * r_bh);
             if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                tft.drawPixel(x, y, TFT_WHITE);
+                simCanvas.drawPixel(x, y, TFT_WHITE);
             }
         }
         // Secondary ring (fainter) - draw only if radius permits
         if (r_bh + 1 < min(SCREEN_WIDTH, SCREEN_HEIGHT) / 2) { // Basic check to avoid huge circles
-             uint16_t secondRingColor = tft.color565(200, 180, 150);
-             tft.drawCircle(centerX, centerY, r_bh + 1, secondRingColor);
+             uint16_t secondRingColor = simCanvas.color565(200, 180, 150);
+             simDrawCircle(centerX, centerY, r_bh + 1, secondRingColor);
         }
         // Tertiary ring (faintest) - draw only if radius permits
         if (r_bh + 2 < min(SCREEN_WIDTH, SCREEN_HEIGHT) / 2) {
-             uint16_t thirdRingColor = tft.color565(150, 140, 120);
-             tft.drawCircle(centerX, centerY, r_bh + 2, thirdRingColor);
+             uint16_t thirdRingColor = simCanvas.color565(150, 140, 120);
+             simDrawCircle(centerX, centerY, r_bh + 2, thirdRingColor);
         }
     }
 
-    /** 5. Draw Gravitational Lensing (appears behind the front disk/stars but over back disk/horizon)
-    float lensRadius = blackHoleRadius * 1.8; // Slightly reduced lens effect radius
-    for (int i = 0; i < 60; i++) {
-        float angle = i * 6 * PI / 180.0f;
-        // Distortion effect - stronger lensing effect "behind" the black hole (top part)
-        float distortion = 0.9f + 0.5f * (1.0f - sin(angle)) / 2.0f; // Sin range adjusted
-        float adjustedRadius = lensRadius * distortion;
-        int x = round(centerX + cos(angle) * adjustedRadius);
-        int y = round(centerY + sin(angle) * adjustedRadius);
-
-        // Check bounds before drawing
-        if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-            // Color based on simulated Doppler shift (red/blue shift)
-            float doppler = (1.0f + sin(angle)) / 2.0f; // 0=top(red), 1=bottom(blue)
-            uint16_t color;
-            if (doppler > 0.75f) color = tft.color565(180, 200, 255); // More subtle Blue shift
-            else if (doppler < 0.25f) color = tft.color565(255, 180, 150); // More subtle Red shift
-            else color = tft.color565(230, 200 + (doppler * 30), 200 + (doppler * 50)); // Smoother transition
-
-            // Draw new lens pixel
-            tft.drawPixel(x, y, color);
-            // Store current position for next frame's erase
-            previousLensPoints[i][0] = x;
-            previousLensPoints[i][1] = y;
-        } else {
-            // Mark previous point as needing erase if it was on screen
-            if(previousLensPoints[i][0] >= 0) {
-               // Erase logic at top handles actual erasing if BH moved/resized
-               // Marking invalid ensures it doesn't get drawn again if BH *didn't* move
-               // but this point moved off screen.
-               // Let erase logic handle it based on prev position.
-               // No action needed here unless we want immediate erase.
-            }
-             previousLensPoints[i][0] = -1; // Mark current point as off-screen
-             previousLensPoints[i][1] = -1;
-        }
-    }
-**/
     // 6. Draw Falling Stars (and their spaghettification/trails)
-    // Drawn after lensing but before the front disk half
+    // Drawn after lensing, so in front of it, but before the front disk half
     for (int i = 0; i < MAX_FALLING_STARS; i++) {
         // Draw active stars or fading trails
-        if (!fallingStars[i].active && !fallingStars[i].hasTrail) continue;
-
-        // Use the position calculated and stored in prevX/Y during the update phase
-        int x = fallingStars[i].prevX;
-        int y = fallingStars[i].prevY;
-
         // If only trail is fading, don't draw the head, just let erase handle cleanup
-        if (!fallingStars[i].active && fallingStars[i].hasTrail) continue;
+        if (!fallingStars->active[i]) continue;
+
+        // Use the position calculated and stored in drawX/Y during the update phase
+        int x = fallingStars->drawX[i];
+        int y = fallingStars->drawY[i];
 
         // Check bounds before drawing star head
-        if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
+        if (x != BH_NO_POS && y != BH_NO_POS) {
             // Recalculate distance/gravity for brightness/effects based on *current* float position
-            float current_dx = centerX - fallingStars[i].x;
-            float current_dy = centerY - fallingStars[i].y;
+            float current_dx = centerX - fallingStars->x[i];
+            float current_dy = centerY - fallingStars->y[i];
             float current_distSq = current_dx*current_dx + current_dy*current_dy;
             float current_dist = sqrt(current_distSq);
 
             float gravityFactor = min(3.0f, (float)(blackHoleRadius * 20.0f / max(current_distSq, 1.0f)));
-            int starBrightness = min(255, fallingStars[i].brightness + (int)(200 * gravityFactor));
+            int starBrightness = min(255, fallingStars->brightness[i] + (int)(200 * gravityFactor));
             starBrightness = max(20, starBrightness); // Ensure minimum brightness
-            uint16_t starColor = tft.color565(starBrightness, starBrightness, starBrightness);
-
-            // Draw the main star head
-            tft.drawPixel(x, y, starColor);
-            // Store head position as the start of the trail for erasing next frame
-            if (trailLen[i] < 10) {
-                prevTrailX[trailLen[i]][i] = x;
-                prevTrailY[trailLen[i]][i] = y;
-                trailLen[i]++;
+            uint16_t starColor = PAL_GREY.v[starBrightness];
+
+            // Draw the main star head, stored as the start of the trail for erasing next frame
+            if (pushTrailPoint(x, y)) {
+                simCanvas.drawPixel(x, y, starColor);
+                fallingStars->trailLength[i]++;
             }
 
             // Draw Spaghettification/Tidal Effects if close enough
@@ -641,7 +571,7 @@ if (current_dist < blackHoleRadius * 2.0f) {
     float stretchFactor = min(6.0f, tidalForce); // Cap the stretch factor
 
     int numStretchPoints = max(1, (int)stretchFactor);
-    for (int j = 1; j <= numStretchPoints && trailLen[i] < 10; j++) {
+    for (int j = 1; j <= numStretchPoints && fallingStars->trailLength[i] < MAX_FALLING_STAR_TRAIL; j++) {
         // Stretch points along the line connecting star and center
         float spacing = j * (0.4f + j * 0.05f); // Adjust spacing logic
 
@@ -655,121 +585,103 @@ if (current_dist < blackHoleRadius * 2.0f) {
 
         // Check bounds and ensure point is outside event horizon before drawing
         if (aheadX >= 0 && aheadX < SCREEN_WIDTH && aheadY >= 0 && aheadY < SCREEN_HEIGHT &&
-            sqrt(sq(aheadX-centerX) + sq(aheadY-centerY)) > blackHoleRadius) {
+            sqrt(sq(aheadX-centerX) + sq(aheadY-centerY)) > blackHoleRadius &&
+            pushTrailPoint(aheadX, aheadY)) {
             float intensityFactor = 1.0f / (j * 0.7f + 1.0f); // Fade further points more
-            uint16_t aheadColor = tft.color565(
+            uint16_t aheadColor = simCanvas.color565(
                 min(255, (int)(starBrightness * 1.2f * intensityFactor)), // Increased brightness
                 min(255, (int)(starBrightness * 1.1f * intensityFactor)), // Slightly increased brightness
                 min(255, (int)(starBrightness * intensityFactor))
             );
-            tft.drawPixel(aheadX, aheadY, aheadColor);
-            prevTrailX[trailLen[i]][i] = aheadX;
-            prevTrailY[trailLen[i]][i] = aheadY;
-            trailLen[i]++;
+            simCanvas.drawPixel(aheadX, aheadY, aheadColor);
+            fallingStars->trailLength[i]++;
         }
 
-        if (behindX >= 0 && behindX < SCREEN_WIDTH && behindY >= 0 && behindY < SCREEN_HEIGHT && trailLen[i] < 10) {
+        if (behindX >= 0 && behindX < SCREEN_WIDTH && behindY >= 0 && behindY < SCREEN_HEIGHT &&
+            fallingStars->trailLength[i] < MAX_FALLING_STAR_TRAIL && pushTrailPoint(behindX, behindY)) {
             float tailFactor = 1.0f / (j * 1.0f + 1.0f); // Fade further points more
-            uint16_t behindColor = tft.color565(
+            uint16_t behindColor = simCanvas.color565(
                 min(255, (int)(starBrightness * 1.1f * tailFactor)), // Increased brightness
                 min(255, (int)(starBrightness * 0.8f * tailFactor)), // Reduced green component for redder tint
                 min(255, (int)(starBrightness * 0.6f * tailFactor)) // Reduced blue component for redder tint
             );
-            tft.drawPixel(behindX, behindY, behindColor);
-            prevTrailX[trailLen[i]][i] = behindX;
-            prevTrailY[trailLen[i]][i] = behindY;
-            trailLen[i]++;
+            simCanvas.drawPixel(behindX, behindY, behindColor);
+            fallingStars->trailLength[i]++;
         }
     }
 }
 
         } else {
              // If star head is off screen, ensure its trail points are still potentially processed by erase logic
-             // The trailLen reset in the erase section handles cleanup
+             // The trail ring is reset in the erase section, nothing to clean up here
         }
     }
 
   // 7. Draw Front Half of Accretion Disk (Bottom half, sin(angle) > 0)
 // This part is drawn last, so it appears on top of everything else near the center
-for (int i = 0; i < MAX_ACCRETION_PARTICLES; i++) {
-    if (!accretionDisk[i].active || accretionDisk[i].prevX < 0) continue; // Skip inactive or invalid position
-    if (sin(accretionDisk[i].angle) <= 0) continue; // Skip back half
+for (int i = 0; i < activeParticles; i++) {
+    if (accretionDisk->x[i] == BH_NO_POS) continue; // Skip off-screen particles
+    q16_16 sinAngle = fxSin(accretionDisk->angle[i]);
+    if (sinAngle <= 0) continue; // Skip back half
 
-    int x = accretionDisk[i].prevX; // Use position calculated in update phase
-    int y = accretionDisk[i].prevY;
+    int x = accretionDisk->x[i]; // Use position calculated in update phase
+    int y = accretionDisk->y[i];
 
-    // Check bounds again before drawing
-    if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
+    {
 
          // UNIFIED Visibility Factor calculated using the SAME formula as the back half
-        float visibilityFactor = 0.8f + 0.4f * sin(accretionDisk[i].angle); // Ranges from 0.8 (sides) to 1.2 (front)
+        q8_8 visibilityFactor = FX8_CONST(0.8) + (fxMul(FX_CONST(0.4), sinAngle) >> 8); // Ranges from 0.8 (sides) to 1.2 (front)
         // No need for a max(0.1f, ...) here as sin() is positive, but keep it if you unify outside the loop
 
-        uint16_t baseColor = accretionDisk[i].color;
+        uint16_t baseColor = accretionDisk->color[i];
         int r_base = red(baseColor);
         int g_base = green(baseColor);
         int b_base = blue(baseColor);
 
         // Calculate distance to center using drawn coordinates for effects
-        float distToCenter = sqrt(sq(x - centerX) + sq(y - centerY));
+        int dx = x - centerX;
+        int dy = y - centerY;
+        q16_16 distSqToCenter = FX_FROM_INT(min(dx * dx + dy * dy, 32767));
+        q16_16 distToCenter = fxSqrt(distSqToCenter);
 
         // Brighten particles very close to the event horizon (heating/energy)
-        float boostFactor = 1.0f; // Initialize boost factor
-        if (distToCenter < blackHoleRadius * 1.6f && blackHoleRadius > 0) {
+        if (distToCenter < boostRadius && blackHoleRadius > 0) {
             // Boost increases sharply near horizon
-            boostFactor = 1.0f + max(0.0f, (blackHoleRadius * 1.6f - distToCenter) / (blackHoleRadius * 0.6f)) * 0.9f;
+            q16_16 boostFactor = FX_ONE + fxMul(fxMul(boostRadius - distToCenter, invBoostWidth), FX_CONST(0.9));
             // Apply boost BEFORE visibility factor for better effect control
-            r_base = min(255, (int)(r_base * boostFactor));
-            g_base = min(255, (int)(g_base * boostFactor));
-            b_base = min(255, (int)(b_base * boostFactor));
+            r_base = min(255, (int)fxMul(FX_FROM_INT(r_base), boostFactor) >> FX_SHIFT);
+            g_base = min(255, (int)fxMul(FX_FROM_INT(g_base), boostFactor) >> FX_SHIFT);
+            b_base = min(255, (int)fxMul(FX_FROM_INT(b_base), boostFactor) >> FX_SHIFT);
         }
 
         // Apply base visibility factor
-        r_base = constrain((int)(r_base * visibilityFactor), 0, 255);
-        g_base = constrain((int)(g_base * visibilityFactor), 0, 255);
-        b_base = constrain((int)(b_base * visibilityFactor), 0, 255);
+        r_base = constrain(fx8Scale(r_base, visibilityFactor), 0, 255);
+        g_base = constrain(fx8Scale(g_base, visibilityFactor), 0, 255);
+        b_base = constrain(fx8Scale(b_base, visibilityFactor), 0, 255);
 
-        uint16_t finalColor = tft.color565(r_base, g_base, b_base);
+        uint16_t finalColor = simCanvas.color565(r_base, g_base, b_base);
 
         // Draw main particle
-        tft.drawPixel(x, y, finalColor);
-
-        // Draw the trail for this particle (no changes needed here)
-        for (int t = 0; t < accretionDisk[i].trailLength; t++) {
-            int trailX = accretionDisk[i].trailX[t];
-            int trailY = accretionDisk[i].trailY[t];
-
-            if (trailX < 0 || trailY < 0 || trailX >= SCREEN_WIDTH || trailY >= SCREEN_HEIGHT) continue;
-
-            float trailDistSq = sq(trailX - centerX) + sq(trailY - centerY);
-            if (trailDistSq <= sq(round(blackHoleRadius))) continue;
-
-            tft.drawPixel(trailX, trailY, accretionDisk[i].trailColors[t]);
-        }
+        simCanvas.drawPixel(x, y, finalColor);
 
         // Optional: Draw subtle bright trail for inner edge of front disk (Keep as is, or adjust brightness based on new r_base etc)
-        if (distToCenter < blackHoleRadius * 1.4f && distToCenter > blackHoleRadius) {
-             float trailAngle = atan2(y - centerY, x - centerX);
+        if (distToCenter < innerTrailRadius && distToCenter > horizonFx) {
+             // Unit vector from the center, instead of atan2 + cos/sin
+             q16_16 outX = fxDivSqrt(FX_FROM_INT(dx), distSqToCenter);
+             q16_16 outY = fxDivSqrt(FX_FROM_INT(dy), distSqToCenter);
              for (int t = 1; t <= 1; t++) { // Simplified trail (1 point)
-                 int trailX = round(x - t * cos(trailAngle) * 0.6f); // Closer trail point
-                 int trailY = round(y - t * sin(trailAngle) * 0.6f);
-                 if (trailX >= 0 && trailX < SCREEN_WIDTH && trailY >= 0 && trailY < SCREEN_HEIGHT) {
-                     float trailFactor = 0.6f / t; // Fainter trail
+                 int trailX = fxRound(FX_FROM_INT(x) - t * fxMul(outX, FX_CONST(0.6))); // Closer trail point
+                 int trailY = fxRound(FX_FROM_INT(y) - t * fxMul(outY, FX_CONST(0.6)));
+                 if (trailX >= 0 && trailX < SCREEN_WIDTH && trailY >= 0 && trailY < SCREEN_HEIGHT &&
+                     pushTrailPoint(trailX, trailY)) { // Remember it for next frame's erase
+                     q8_8 trailFactor = FX8_CONST(0.6) / t; // Fainter trail
                      // Use the calculated r_base, g_base, b_base for consistency
-                     uint16_t trailColor = tft.color565(
-                        min(255, (int)(r_base * trailFactor * 1.2f)), // Slightly brighter trail color base
-                        min(255, (int)(g_base * trailFactor * 1.1f)),
-                        min(255, (int)(b_base * trailFactor))
+                     uint16_t trailColor = simCanvas.color565(
+                        min(255, fx8Scale(r_base, trailFactor * 6 / 5)), // Slightly brighter trail color base
+                        min(255, fx8Scale(g_base, trailFactor * 11 / 10)),
+                        min(255, fx8Scale(b_base, trailFactor))
                      );
-                     tft.drawPixel(trailX, trailY, trailColor);
-                     // Store trail points (No change needed)
-                     if (accretionDisk[i].trailLength < 8) {
-                        accretionDisk[i].trailX[accretionDisk[i].trailLength] = trailX;
-                        accretionDisk[i].trailY[accretionDisk[i].trailLength] = trailY;
-                        // Trail color calculation might need adjustment here if calculateTrailColors used old logic
-                        accretionDisk[i].trailColors[accretionDisk[i].trailLength] = trailColor; // Or recalculate faded color
-                        accretionDisk[i].trailLength++;
-                     }
+                     simCanvas.drawPixel(trailX, trailY, trailColor);
                  }
              }
          }
@@ -794,25 +706,24 @@ void initializeAccretionParticle(int index, int centerX, int centerY) {
     float currentDiskOuterRadius = max(currentDiskInnerRadius + 1.0f, blackHoleRadius * 2.5f); // Slightly larger disk
     float diskWidth = currentDiskOuterRadius - currentDiskInnerRadius;
 
-    accretionDisk[index].angle = random(0, 3600) * PI / 1800.0f;
+    float angle = accretionDisk->angle[index] * (2.0f * PI / 65536.0f);
 
     // More realistic particle distribution using Shakura-Sunyaev model
-    float randFactor = random(0, 1000) / 1000.0f;
+    float randFactor = objectRng.range(0, 1000) / 1000.0f;
     float distanceFactor = pow(randFactor, 2.0f); // Steeper power law for density
-    accretionDisk[index].distance = currentDiskInnerRadius + (distanceFactor * diskWidth);
+    float distance = currentDiskInnerRadius + (distanceFactor * diskWidth);
+    accretionDisk->distance[index] = fxFromFloat(distance);
 
     // Relativistic orbital velocity (simplified)
-    float orbital_velocity = sqrt(blackHoleRadius / accretionDisk[index].distance);
-    accretionDisk[index].relativistic_factor = min(orbital_velocity, 0.9f); // Cap at 0.9c
+    float orbital_velocity = sqrt(blackHoleRadius / distance);
+    float relativistic_factor = min(orbital_velocity, 0.9f); // Cap at 0.9c
 
     // Calculate Doppler shift including relativistic beaming
-    float sin_angle = sin(accretionDisk[index].angle);
-    float cos_angle = cos(accretionDisk[index].angle);
-    float doppler = 1.0f / (1.0f - accretionDisk[index].relativistic_factor * sin_angle);
-    accretionDisk[index].doppler_shift = doppler;
+    float sin_angle = sin(angle);
+    float doppler = 1.0f / (1.0f - relativistic_factor * sin_angle);
 
     // Temperature based on distance (T ~ r^(-3/4) for thin accretion disks)
-    float temp_factor = pow(currentDiskInnerRadius / accretionDisk[index].distance, 0.75f);
+    float temp_factor = pow(currentDiskInnerRadius / distance, 0.75f);
     
     // Base color calculation using blackbody approximation
     float temp_ratio = temp_factor * doppler; // Include Doppler effect on temperature
@@ -844,44 +755,15 @@ void initializeAccretionParticle(int index, int centerX, int centerY) {
     g = constrain((int)(g * intensity), 0, 255);
     b = constrain((int)(b * intensity), 0, 255);
 
-    accretionDisk[index].color = tft.color565(r, g, b);
-    accretionDisk[index].brightness = constrain((int)(255 * intensity), 50, 255);
-
-    // Initialize other properties
-    accretionDisk[index].prevX = -1;
-    accretionDisk[index].prevY = -1;
-    accretionDisk[index].active = true;
-    accretionDisk[index].hasTrail = true;
-    accretionDisk[index].trailLength = 0;
-    for (int t = 0; t < 8; t++) {
-        accretionDisk[index].trailX[t] = -1;
-        accretionDisk[index].trailY[t] = -1;
-    }
-    
-    // Calculate Keplerian orbital speed
-    float orbitRatio = sqrt(currentDiskInnerRadius / accretionDisk[index].distance);
-    accretionDisk[index].speed = 0.04f * orbitRatio;
+    accretionDisk->color[index] = simCanvas.color565(r, g, b);
 
-    // Calculate initial trail colors in case they're needed immediately
-    calculateTrailColors(accretionDisk[index]);
-}
+    // Not drawn yet
+    accretionDisk->x[index] = BH_NO_POS;
+    accretionDisk->y[index] = BH_NO_POS;
 
-// Add this helper function
-void calculateTrailColors(AccretionParticle &particle) {
-    uint16_t baseColor = particle.color;
-    int r = red(baseColor);
-    int g = green(baseColor);
-    int b = blue(baseColor);
-    
-    // Store particle colors with gradual fade
-    for (int i = 0; i < 8; i++) {
-        float fadeRatio = 1.0f - (i * 0.12f); // Fade out along trail
-        particle.trailColors[i] = tft.color565(
-            max(0, (int)(r * fadeRatio)),
-            max(0, (int)(g * fadeRatio)),
-            max(0, (int)(b * fadeRatio))
-        );
-    }
+    // Calculate Keplerian orbital speed
+    float orbitRatio = sqrt(currentDiskInnerRadius / distance);
+    accretionDisk->speed[index] = fxFromFloat(0.04f * orbitRatio * (65536.0f / (2.0f * PI))); // rad -> binary angle
 }
 
 /**
@@ -891,10 +773,12 @@ void eraseBlackHole() {
     if (blackHoleInitialized) {
         // Erase a sufficiently large area around the last known position
         // Calculate based on outer disk radius for safety
+#if !RENDER_FULL_REDRAW
         float eraseRadius = (previousEventHorizonRadius > 0)
                             ? max(previousEventHorizonRadius * 2.5f, diskOuterRadius * 1.1f) + 5.0f
                             : 60.0f; // Default if no radius known
-        tft.fillCircle(prevBlackHoleX, prevBlackHoleY, round(eraseRadius), BG_COLOR);
+        canvasFillCircle(prevBlackHoleX, prevBlackHoleY, round(eraseRadius), BG_COLOR);
+#endif
 
         // Reset state variables
         blackHoleInitialized = false;
@@ -902,8 +786,7 @@ void eraseBlackHole() {
         prevBlackHoleY = -1000;
         previousEventHorizonRadius = 0;
         // Also clear potentially persistent arrays if needed
-         for (int i = 0; i < 60; i++) previousLensPoints[i][0] = -1;
-         for (int i = 0; i < MAX_FALLING_STARS; i++) trailLen[i] = 0;
+         bhTrail->frameStart = bhTrail->head;
          for (int i = 0; i < 4; i++) prevInnerParticleX[i] = -1;
     }
 }
@@ -0,0 +1,114 @@
+#ifndef BLEND_H
+#define BLEND_H
+
+#include <stdint.h>
+
+// RGB565 compositing in integer maths. A colour is spread over a 32-bit word
+// with the mask 0x07E0F81F: red and blue stay in the low half, green moves up
+// to bits 21-26, and each channel gets at least five spare bits above it. One
+// multiply then scales all three channels at once without them running into
+// each other, and one shift divides them. The same mask, and its complement
+// on a word shifted down by five, blends two neighbouring pixels of a frame
+// buffer in two multiplies.
+// Alpha goes from 0 to BLEND_ALPHA_MAX (32), which is finer than the 5-bit
+// channels and as fine as 6-bit green needs for a fade.
+
+#define BLEND_ALPHA_MAX 32
+#define BLEND_MASK 0x07E0F81Fu   // One pixel, or the low pixel's red and blue with the high pixel's green
+#define BLEND_MASK_HI 0xF81F07E0u // The other channels of a pixel pair
+
+/**
+ * 8-bit alpha (255 = opaque) to 0..BLEND_ALPHA_MAX
+ */
+inline uint8_t blendAlpha(uint8_t alpha8) {
+  return (alpha8 + 4) >> 3;
+}
+
+/**
+ * Float alpha, clamped to 0.0..1.0, to 0..BLEND_ALPHA_MAX; for one-off colours, not per pixel
+ */
+inline uint8_t blendAlphaFloat(float alpha) {
+  if (alpha <= 0.0f) return 0;
+  if (alpha >= 1.0f) return BLEND_ALPHA_MAX;
+  return (uint8_t)(alpha * BLEND_ALPHA_MAX + 0.5f);
+}
+
+/**
+ * Spreads an RGB565 colour over a word as ---GGGGGG-----RRRRR------BBBBB
+ */
+inline uint32_t blendSpread(uint16_t color) {
+  return (color | ((uint32_t)color << 16)) & BLEND_MASK;
+}
+
+/**
+ * Folds a spread colour back into RGB565
+ */
+inline uint16_t blendFold(uint32_t spread) {
+  spread &= BLEND_MASK;
+  return (uint16_t)(spread | (spread >> 16));
+}
+
+/**
+ * Moves an RGB565 colour towards another; alpha 0 keeps from, BLEND_ALPHA_MAX gives to
+ */
+inline uint16_t blend565(uint16_t from, uint16_t to, uint8_t alpha) {
+  uint32_t a = blendSpread(from);
+  uint32_t b = blendSpread(to);
+  return blendFold((a * (BLEND_ALPHA_MAX - alpha) + b * alpha) >> 5);
+}
+
+/**
+ * Darkens an RGB565 colour; alpha BLEND_ALPHA_MAX keeps it as is
+ */
+inline uint16_t scale565(uint16_t color, uint8_t alpha) {
+  return blendFold((blendSpread(color) * alpha) >> 5);
+}
+
+/**
+ * Adds two RGB565 colours, each channel saturating at full, for light on light
+ */
+inline uint16_t add565(uint16_t a, uint16_t b) {
+  uint32_t sum = blendSpread(a) + blendSpread(b);
+  // A channel that overflowed set the bit above it; turn that bit into all ones
+  uint32_t carryRB = sum & 0x00010020u; // Above blue (bit 5) and red (bit 16)
+  uint32_t carryG = sum & 0x08000000u;  // Above green (bit 27)
+  sum |= (carryRB - (carryRB >> 5)) | (carryG - (carryG >> 6));
+  return blendFold(sum);
+}
+
+/**
+ * Blends two pixel pairs packed in words the same way blend565() blends one pixel
+ */
+inline uint32_t blend565x2(uint32_t from, uint32_t to, uint8_t alpha) {
+  uint8_t keep = BLEND_ALPHA_MAX - alpha;
+  uint32_t lo = (((from & BLEND_MASK) * keep + (to & BLEND_MASK) * alpha) >> 5) & BLEND_MASK;
+  uint32_t hi = (((from & BLEND_MASK_HI) >> 5) * keep + ((to & BLEND_MASK_HI) >> 5) * alpha) & BLEND_MASK_HI;
+  return lo | hi;
+}
+
+/**
+ * Swaps the bytes of both pixels in a word, between panel byte order and RGB565
+ */
+inline uint32_t blendSwap2(uint32_t pair) {
+  return ((pair & 0x00FF00FFu) << 8) | ((pair >> 8) & 0x00FF00FFu);
+}
+
+/**
+ * Blends count pixels of from over dst in place, both in panel byte order:
+ * alpha 0 keeps dst, BLEND_ALPHA_MAX replaces it with from. Both buffers must
+ * be 4-byte aligned, as sprite frame buffers are.
+ */
+inline void blendFrame(uint16_t* dst, const uint16_t* from, uint32_t count, uint8_t alpha) {
+  uint32_t* out = (uint32_t*)dst;
+  const uint32_t* in = (const uint32_t*)from;
+  for (uint32_t i = 0; i < count / 2; i++) {
+    out[i] = blendSwap2(blend565x2(blendSwap2(out[i]), blendSwap2(in[i]), alpha));
+  }
+  if (count & 1) {
+    uint16_t a = dst[count - 1], b = from[count - 1];
+    uint16_t mixed = blend565((a >> 8) | (a << 8), (b >> 8) | (b << 8), alpha);
+    dst[count - 1] = (mixed >> 8) | (mixed << 8);
+  }
+}
+
+#endif // BLEND_H
@@ -0,0 +1,27 @@
+#ifndef CELESTIAL_H
+#define CELESTIAL_H
+
+#include <Arduino.h>
+#include "arena.h"
+
+// Every CelestialObject is driven through one CelestialRenderer. The sketch
+// keeps a table of them in enum order; drawCelestialObject() and
+// eraseCelestialObject() dispatch through it. Adding an object type means
+// writing its functions and adding a row, nothing else.
+
+/**
+ * What the main loop needs to know about one kind of celestial object
+ */
+struct CelestialRenderer {
+  const char* label;            // Shown under the object
+  void (*init)();               // Takes state from the object arena on discovery, may be null
+  void (*draw)();               // Steps the animation and draws one frame
+  void (*erase)();              // Clears the object and marks it for a fresh start
+  int (*detailBudget)(uint8_t); // Particles used at a detail level (lod.h), null if fixed
+  bool simCore;                 // draw() runs on the sim core through simRun()
+};
+
+// Forward declarations of external variables
+extern const CelestialRenderer CELESTIAL_RENDERERS[];
+
+#endif // CELESTIAL_H
@@ -2,9 +2,18 @@
 #define COMET_H
 
 #include <TFT_eSPI.h>
+#include "render.h"
+#include "simulation.h"
+#include "fixedpoint.h"
+#include "palette.h"
+#include "arena.h"
+#include "rng.h"
+#include "glow.h"
+#include "particles.h"
+#include "blend.h"
 
 // Forward declarations of external variables and constants
-extern TFT_eSPI tft;
+extern TFT_eSPI& canvas; // Draw target for erasing, see render.h
 extern uint16_t BG_COLOR;
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
@@ -13,15 +22,75 @@ extern float objectScale;
 
 // Comet parameters
 #define MAX_COMET_TAIL 500 // Increased number of particles
+#define MIN_COMET_TAIL 40  // Tail particles kept at the lowest detail level
+#define COMET_TAIL_LIFE_MS 2000    // A tail particle fades out over this long
+#define COMET_SPAWN_INTERVAL_MS 5  // At most one tail particle per frame, this far apart
 
 // Struct for comet tail particles with velocity
 struct CometParticle {
-  float x, y;           // Position
-  float vx, vy;         // Velocity
-  int brightness;       // Brightness (0-255)
+  q16_16 x, y;          // Position (16.16 fixed point)
+  q16_16 vx, vy;        // Velocity (16.16 fixed point)
+  uint8_t brightness;   // Brightness at spawn (0-255)
   unsigned long spawnTime;  // When this particle was created
 };
 
+/**
+ * Tail particles drift away from the nucleus and fade out
+ */
+struct CometTailTraits {
+  struct Context {
+    unsigned long timeMs;
+    int steps;
+  };
+
+  static bool onScreen(int x, int y) {
+    return x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT;
+  }
+
+  static bool update(CometParticle& p, Context& context) {
+#if !RENDER_FULL_REDRAW
+    int prevX = fxRound(p.x);
+    int prevY = fxRound(p.y);
+#endif
+
+    // Update position with velocity and slightly accelerate, once per step
+    for (int step = 0; step < context.steps; step++) {
+      p.x += p.vx;
+      p.y += p.vy;
+      p.vx += p.vx >> 10; // slightly accelerate in the initial direction (~1.001x)
+      p.vy += p.vy >> 10;
+    }
+    bool alive = context.timeMs - p.spawnTime <= COMET_TAIL_LIFE_MS;
+
+#if !RENDER_FULL_REDRAW
+    // Erase only if the particle moved or is gone
+    if ((!alive || prevX != fxRound(p.x) || prevY != fxRound(p.y)) && onScreen(prevX, prevY)) {
+      simCanvas.drawPixel(prevX, prevY, BG_COLOR);
+    }
+#endif
+    return alive;
+  }
+
+  static void draw(const CometParticle& p, Context& context) {
+    int x = fxRound(p.x);
+    int y = fxRound(p.y);
+    if (!onScreen(x, y)) return;
+    int age = context.timeMs - p.spawnTime;
+    int brightness = p.brightness * (COMET_TAIL_LIFE_MS - age) / COMET_TAIL_LIFE_MS;
+    simCanvas.drawPixel(x, y, PAL_COMET_TAIL.v[brightness]);
+  }
+
+  static void erase(const CometParticle& p, Context& context) {
+    int x = fxRound(p.x);
+    int y = fxRound(p.y);
+    if (onScreen(x, y)) simCanvas.drawPixel(x, y, BG_COLOR);
+  }
+};
+
+typedef ParticleSystem<CometParticle, MAX_COMET_TAIL, CometTailTraits> CometTail;
+
+#define COMET_ARENA_BYTES (ARENA_SIZE(CometTail, 1) + GLOW_BYTES((int)(2 * GLOW_MAX_SCALE)))
+
 // Module-private variables
 namespace {
   bool cometInitialized = false;
@@ -29,10 +98,36 @@ namespace {
   float cometVx = 0, cometVy = 0;     // Comet velocity
   int cometRadius = 0;                // Comet nucleus radius
   int prevCometX = 0, prevCometY = 0; // Previous comet position for erasing
-  CometParticle cometTail[MAX_COMET_TAIL];
+  CometTail* cometTail = nullptr;     // From the object arena
   unsigned long cometLastParticleTime = 0;
 }
 
+/**
+ * Tail particles that may be alive at once at a detail level (see lod.h)
+ */
+int cometDetailBudget(uint8_t detail) {
+  return lodBudget(detail, MIN_COMET_TAIL, MAX_COMET_TAIL);
+}
+
+/**
+ * Takes the tail from the object arena and renders the nucleus into the glow
+ * atlas; the first draw sets the comet on its way
+ */
+void initComet() {
+  cometTail = arenaAlloc<CometTail>();
+  cometInitialized = false;
+
+  int radius = 2 * objectScale;
+  uint16_t coma = canvas.color565(255, 255, 204);
+  // Additive, so the nucleus brightens the tail it sits in
+  glowCreate(GLOW_COMET_HEAD, radius, [=](int dx, int dy) -> uint16_t {
+    if (glowInDisc(dx, dy, radius / 2)) return TFT_WHITE;
+    int r = glowRing(dx, dy);
+    if (r > radius) return 0;
+    return scale565(coma, blendAlpha((uint8_t)map(r, 0, radius, 100, 255)));
+  }, true);
+}
+
 /**
  * Draws a comet with a glowing head and realistic particle tail
  */
@@ -40,52 +135,45 @@ void drawComet() {
   int centerX = objectX;
   int centerY = objectY;
   float scale = objectScale;
-  unsigned long currentTime = millis();
+  const FrameTime& clock = simInputs.clock;
+  unsigned long currentTime = clock.timeMs;
 
   if (!cometInitialized) {
     // Initialize comet at a random edge
-    int side = random(4); // 0=top, 1=right, 2=bottom, 3=left
+    int side = objectRng.below(4); // 0=top, 1=right, 2=bottom, 3=left
     switch (side) {
       case 0: // Top
-        cometX = random(SCREEN_WIDTH);
+        cometX = objectRng.below(SCREEN_WIDTH);
         cometY = 0;
         break;
       case 1: // Right
         cometX = SCREEN_WIDTH - 1;
-        cometY = random(SCREEN_HEIGHT);
+        cometY = objectRng.below(SCREEN_HEIGHT);
         break;
       case 2: // Bottom
-        cometX = random(SCREEN_WIDTH);
+        cometX = objectRng.below(SCREEN_WIDTH);
         cometY = SCREEN_HEIGHT - 1;
         break;
       case 3: // Left
         cometX = 0;
-        cometY = random(SCREEN_HEIGHT);
+        cometY = objectRng.below(SCREEN_HEIGHT);
         break;
     }
 
     // Set velocity toward center with randomness
-    float targetX = centerX + random(-20, 21);
-    float targetY = centerY + random(-20, 21);
+    float targetX = centerX + objectRng.range(-20, 21);
+    float targetY = centerY + objectRng.range(-20, 21);
     float dx = targetX - cometX;
     float dy = targetY - cometY;
     float dist = sqrt(dx * dx + dy * dy);
-    float speed = (0.3f + random(0, 100) / 500.0f) * scale;
+    float speed = (0.3f + objectRng.range(0, 100) / 500.0f) * scale;
     cometVx = dx / dist * speed;
     cometVy = dy / dist * speed;
 
     // Set comet size
     cometRadius = 2 * scale;
 
-    // Initialize tail particles (inactive)
-    for (int i = 0; i < MAX_COMET_TAIL; i++) {
-      cometTail[i].brightness = 0;
-      cometTail[i].x = cometX;
-      cometTail[i].y = cometY;
-      cometTail[i].vx = 0;
-      cometTail[i].vy = 0;
-      cometTail[i].spawnTime = 0;
-    }
+    cometTail->clear();
 
     prevCometX = round(cometX);
     prevCometY = round(cometY);
@@ -93,114 +181,66 @@ void drawComet() {
     cometInitialized = true;
   }
 
-  // Update comet position
-  cometX += cometVx;
-  cometY += cometVy;
+  // Update comet position, velocities are per simulation step
+  cometX += cometVx * clock.steps;
+  cometY += cometVy * clock.steps;
 
-  // Draw comet nucleus
-  int x = round(cometX);
-  int y = round(cometY);
+  // Draw comet nucleus between its last two steps
+  float behind = 1.0f - fxToFloat(clock.alpha);
+  int x = round(cometX - cometVx * behind);
+  int y = round(cometY - cometVy * behind);
 
+#if !RENDER_FULL_REDRAW
   // Erase previous nucleus
   if (prevCometX >= 0 && prevCometX < SCREEN_WIDTH &&
       prevCometY >= 0 && prevCometY < SCREEN_HEIGHT) {
-    tft.fillCircle(prevCometX, prevCometY, cometRadius + 1, BG_COLOR);
+    simFillCircle(prevCometX, prevCometY, cometRadius + 1, BG_COLOR);
   }
+#endif
 
   // Draw nucleus with glow
   if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-    for (int r = cometRadius; r > 0; r--) {
-      uint8_t brightness = map(r, 0, cometRadius, 100, 255);
-      uint16_t glowColor = tft.color565(brightness, brightness, brightness * 0.8);
-      tft.drawCircle(x, y, r, glowColor);
-    }
-    tft.fillCircle(x, y, cometRadius / 2, TFT_WHITE);
+    simDrawGlow(GLOW_COMET_HEAD, x, y);
     prevCometX = x;
     prevCometY = y;
   }
 
-  // Spawn new tail particles at a faster rate
-  if (currentTime - cometLastParticleTime > 5) {
-    for (int i = 0; i < MAX_COMET_TAIL; i++) {
-      if (cometTail[i].brightness == 0) {
-        cometTail[i].x = cometX + random(-1, 2);
-        cometTail[i].y = cometY + random(-1, 2);
-        float angle = atan2(-cometVy, -cometVx);
-        float angleDeviation = random(-30, 30) * PI / 180.0f;
-        float speedFactor = 0.05f + random(0, 100) / 500.0f;
-        cometTail[i].vx = cos(angle + angleDeviation) * speedFactor * scale;
-        cometTail[i].vy = sin(angle + angleDeviation) * speedFactor * scale;
-        cometTail[i].brightness = 150 + random(0, 106);
-        cometTail[i].spawnTime = currentTime;
-        cometLastParticleTime = currentTime;
-        break;
-      }
-    }
+  // Spawn new tail particles at a faster rate. The detail level caps how many
+  // are alive; while over the cap, no new ones are spawned until enough fade.
+  CometTailTraits::Context tailContext = {currentTime, clock.steps};
+  cometTail->beginSpawns(currentTime - cometLastParticleTime > COMET_SPAWN_INTERVAL_MS ? 1 : 0);
+  if (CometParticle* p = cometTail->spawn(cometDetailBudget(simInputs.detail))) {
+    p->x = fxFromFloat(cometX + objectRng.range(-1, 2));
+    p->y = fxFromFloat(cometY + objectRng.range(-1, 2));
+    float angle = atan2(-cometVy, -cometVx);
+    float angleDeviation = objectRng.range(-30, 30) * PI / 180.0f;
+    float speedFactor = 0.05f + objectRng.range(0, 100) / 500.0f;
+    p->vx = fxFromFloat(cos(angle + angleDeviation) * speedFactor * scale);
+    p->vy = fxFromFloat(sin(angle + angleDeviation) * speedFactor * scale);
+    p->brightness = 150 + objectRng.range(0, 106);
+    p->spawnTime = currentTime;
+    cometLastParticleTime = currentTime;
   }
 
-  // Update and draw tail particles
-  for (int i = 0; i < MAX_COMET_TAIL; i++) {
-    if (cometTail[i].brightness > 0) {
-      int prevParticleX = round(cometTail[i].x);
-      int prevParticleY = round(cometTail[i].y);
-
-      // Update position with velocity and slightly accelerate
-      cometTail[i].x += cometTail[i].vx;
-      cometTail[i].y += cometTail[i].vy;
-      cometTail[i].vx *= 1.001; // slightly accelerate in the initial direction
-      cometTail[i].vy *= 1.001;
-
-      int particleX = round(cometTail[i].x);
-      int particleY = round(cometTail[i].y);
-
-      // Erase only if position changed
-      if (prevParticleX != particleX || prevParticleY != particleY) {
-        if (prevParticleX >= 0 && prevParticleX < SCREEN_WIDTH &&
-            prevParticleY >= 0 && prevParticleY < SCREEN_HEIGHT) {
-          tft.drawPixel(prevParticleX, prevParticleY, BG_COLOR);
-        }
-      }
-
-      // Age and fade particle
-      unsigned long particleAge = currentTime - cometTail[i].spawnTime;
-      if (particleAge > 2000) {
-        cometTail[i].brightness = 0;
-      } else {
-        float fadeFactor = 1.0f - (float)particleAge / 2000.0f;
-        int newBrightness = cometTail[i].brightness * fadeFactor;
-        if (particleX >= 0 && particleX < SCREEN_WIDTH &&
-            particleY >= 0 && particleY < SCREEN_HEIGHT) {
-          uint16_t tailColor = tft.color565(
-            newBrightness * 0.5,  
-            newBrightness * 0.8,
-            newBrightness
-          );
-          tft.drawPixel(particleX, particleY, tailColor);
-        }
-      }
-    }
-  }
+  // Update the tail, then draw it; erasing first keeps one particle from wiping out another
+  cometTail->update(tailContext);
+  cometTail->draw(tailContext);
 
   // Handle comet exiting screen
   if (x < -cometRadius || x > SCREEN_WIDTH + cometRadius ||
       y < -cometRadius || y > SCREEN_HEIGHT + cometRadius) {
+#if !RENDER_FULL_REDRAW
     // Erase nucleus
     if (prevCometX >= 0 && prevCometX < SCREEN_WIDTH &&
         prevCometY >= 0 && prevCometY < SCREEN_HEIGHT) {
-      tft.fillCircle(prevCometX, prevCometY, cometRadius + 1, BG_COLOR);
+      simFillCircle(prevCometX, prevCometY, cometRadius + 1, BG_COLOR);
     }
+#endif
     // Erase tail
-    for (int i = 0; i < MAX_COMET_TAIL; i++) {
-      if (cometTail[i].brightness > 0) {
-        int particleX = round(cometTail[i].x);
-        int particleY = round(cometTail[i].y);
-        if (particleX >= 0 && particleX < SCREEN_WIDTH &&
-            particleY >= 0 && particleY < SCREEN_HEIGHT) {
-          tft.drawPixel(particleX, particleY, BG_COLOR);
-        }
-        cometTail[i].brightness = 0;
-      }
-    }
+#if !RENDER_FULL_REDRAW
+    cometTail->erase(tailContext);
+#endif
+    cometTail->clear();
     cometInitialized = false;
   }
 }
@@ -208,22 +248,21 @@ void drawComet() {
 // Erase function remains the same
 void eraseComet() {
   if (cometInitialized) {
+#if !RENDER_FULL_REDRAW
     // Erase nucleus
     if (prevCometX >= 0 && prevCometX < SCREEN_WIDTH &&
         prevCometY >= 0 && prevCometY < SCREEN_HEIGHT) {
-      tft.fillCircle(prevCometX, prevCometY, cometRadius + 1, BG_COLOR);
+      canvasFillCircle(prevCometX, prevCometY, cometRadius + 1, BG_COLOR);
     }
     // Erase tail
-    for (int i = 0; i < MAX_COMET_TAIL; i++) {
-      if (cometTail[i].brightness > 0) {
-        int particleX = round(cometTail[i].x);
-        int particleY = round(cometTail[i].y);
-        if (particleX >= 0 && particleX < SCREEN_WIDTH &&
-            particleY >= 0 && particleY < SCREEN_HEIGHT) {
-          tft.drawPixel(particleX, particleY, BG_COLOR);
-        }
+    for (uint16_t i = 0; i < cometTail->live(); i++) {
+      int particleX = fxRound((*cometTail)[i].x);
+      int particleY = fxRound((*cometTail)[i].y);
+      if (CometTailTraits::onScreen(particleX, particleY)) {
+        canvas.drawPixel(particleX, particleY, BG_COLOR);
       }
     }
+#endif
     cometInitialized = false;
   }
 }
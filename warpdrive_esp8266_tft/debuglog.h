@@ -0,0 +1,19 @@
+#ifndef DEBUGLOG_H
+#define DEBUGLOG_H
+
+#include <Arduino.h>
+
+// Serial debug output, filtered at compile time with -DDEBUG_VERBOSITY=...
+// At 9600 baud a full UART FIFO blocks the caller, so nothing per frame is
+// printed unless asked for.
+#define DEBUG_QUIET 0   // Errors only (printed unconditionally elsewhere)
+#define DEBUG_EVENTS 1  // State changes: objects selected, button presses, sleep
+#define DEBUG_FRAMES 2  // Per-frame values such as the potentiometer reading
+
+#ifndef DEBUG_VERBOSITY
+#define DEBUG_VERBOSITY DEBUG_EVENTS
+#endif
+
+#define DEBUG_LOG(level, ...) do { if (DEBUG_VERBOSITY >= (level)) Serial.printf(__VA_ARGS__); } while (0)
+
+#endif // DEBUGLOG_H
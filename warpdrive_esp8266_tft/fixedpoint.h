@@ -0,0 +1,208 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <stdint.h>
+
+// Fixed-point formats used by the particle loops
+typedef int32_t q16_16;    // 16.16: positions, velocities, radii (range +-32767)
+typedef int16_t q8_8;      // 8.8: brightness and colour factors (256 = 1.0)
+typedef uint16_t fx_angle; // Binary angle, 65536 = one full turn, wraps for free
+
+#define FX_SHIFT 16
+#define FX_ONE (1 << FX_SHIFT)
+#define FX_HALF (1 << (FX_SHIFT - 1))
+#define FX8_ONE 256
+
+#define FX_QUARTER_TURN 0x4000
+#define FX_HALF_TURN 0x8000
+
+// Compile-time conversions for constants
+#define FX_FROM_INT(i) ((q16_16)(i) * FX_ONE)
+#define FX_CONST(f) ((q16_16)((f) * FX_ONE + ((f) >= 0 ? 0.5 : -0.5)))
+#define FX8_CONST(f) ((q8_8)((f) * FX8_ONE + ((f) >= 0 ? 0.5 : -0.5)))
+
+// Table sizes
+#define FX_SIN_STEPS 256      // Entries per quarter turn
+#define FX_INVSQRT_STEPS 96   // Entries over the normalised range [1, 4)
+#define FX_FALLOFF_STEPS 128  // Entries over [0, 1)
+
+// ---- Table generation -------------------------------------------------------
+// Everything below is evaluated by the compiler; the tables end up in flash
+// (.rodata) and nothing runs at start-up. Written C++11-style (one return per
+// constexpr function) so it builds with every ESP32 core.
+
+// 0..N-1 as a parameter pack. Built by halving, so template depth is log2(N)
+// and tables can be bigger than the compiler's 900-level recursion limit.
+template <int... I> struct FxIndexList { typedef FxIndexList type; };
+template <typename A, typename B> struct FxJoinIndexList;
+template <int... A, int... B> struct FxJoinIndexList<FxIndexList<A...>, FxIndexList<B...> > {
+  typedef FxIndexList<A..., (int)sizeof...(A) + B...> type;
+};
+template <int N> struct FxMakeIndexList
+    : FxJoinIndexList<typename FxMakeIndexList<N / 2>::type, typename FxMakeIndexList<N - N / 2>::type> {};
+template <> struct FxMakeIndexList<0> { typedef FxIndexList<> type; };
+template <> struct FxMakeIndexList<1> { typedef FxIndexList<0> type; };
+
+template <typename T, int N> struct FxTable { T v[N]; };
+
+constexpr double fxConstSinSeries(double x, double term, double sum, int k) {
+  return k > 12 ? sum
+                : fxConstSinSeries(x, -term * x * x / ((2 * k) * (2 * k + 1)), sum + term, k + 1);
+}
+
+/**
+ * Taylor series sine, good to ~1e-12 on [0, pi/2 + one step]
+ */
+constexpr double fxConstSin(double x) {
+  return fxConstSinSeries(x, x, 0.0, 1);
+}
+
+constexpr double fxConstSqrtNewton(double x, double guess, int n) {
+  return n == 0 ? guess : fxConstSqrtNewton(x, 0.5 * (guess + x / guess), n - 1);
+}
+
+constexpr double fxConstSqrt(double x) {
+  return fxConstSqrtNewton(x, x > 1.0 ? x : 1.0, 24);
+}
+
+// sin() over one quarter turn in Q1.14, plus two guard entries for interpolation
+constexpr int16_t fxSinEntry(int i) {
+  return (int16_t)(fxConstSin(i * 3.14159265358979323846 / (2 * FX_SIN_STEPS)) * 16384.0 + 0.5);
+}
+
+// 1/sqrt(m) for m = 1 + i/32 in [1, 4], Q1.15 (32768 = 1.0)
+constexpr uint16_t fxInvSqrtEntry(int i) {
+  return (uint16_t)(32768.0 / fxConstSqrt(1.0 + i / 32.0) + 0.5);
+}
+
+// 1 - d^2 brightness falloff, 255 at the centre (the pulsar beam profile)
+constexpr uint8_t fxFalloffEntry(int i) {
+  return (uint8_t)(255.0 * (1.0 - ((double)i / FX_FALLOFF_STEPS) * ((double)i / FX_FALLOFF_STEPS)));
+}
+
+template <int... I>
+constexpr FxTable<int16_t, sizeof...(I)> fxMakeSinTable(FxIndexList<I...>) {
+  return {{ fxSinEntry(I)... }};
+}
+
+template <int... I>
+constexpr FxTable<uint16_t, sizeof...(I)> fxMakeInvSqrtTable(FxIndexList<I...>) {
+  return {{ fxInvSqrtEntry(I)... }};
+}
+
+template <int... I>
+constexpr FxTable<uint8_t, sizeof...(I)> fxMakeFalloffTable(FxIndexList<I...>) {
+  return {{ fxFalloffEntry(I)... }};
+}
+
+namespace {
+  constexpr FxTable<int16_t, FX_SIN_STEPS + 2> FX_SIN_TABLE =
+      fxMakeSinTable(FxMakeIndexList<FX_SIN_STEPS + 2>::type());
+  constexpr FxTable<uint16_t, FX_INVSQRT_STEPS + 1> FX_INVSQRT_TABLE =
+      fxMakeInvSqrtTable(FxMakeIndexList<FX_INVSQRT_STEPS + 1>::type());
+  constexpr FxTable<uint8_t, FX_FALLOFF_STEPS> FX_FALLOFF_TABLE =
+      fxMakeFalloffTable(FxMakeIndexList<FX_FALLOFF_STEPS>::type());
+}
+
+static_assert(FX_SIN_TABLE.v[FX_SIN_STEPS] == 16384, "sin(pi/2) must be exactly 1.0");
+static_assert(FX_INVSQRT_TABLE.v[0] == 32768, "1/sqrt(1) must be exactly 1.0");
+
+// ---- Arithmetic -------------------------------------------------------------
+
+inline q16_16 fxFromFloat(float f) { return (q16_16)(f * FX_ONE); }
+inline float fxToFloat(q16_16 v) { return v * (1.0f / FX_ONE); }
+
+/**
+ * Rounds to the nearest integer (halves go up)
+ */
+inline int fxRound(q16_16 v) { return (v + FX_HALF) >> FX_SHIFT; }
+
+inline q16_16 fxMul(q16_16 a, q16_16 b) { return (q16_16)(((int64_t)a * b) >> FX_SHIFT); }
+
+/**
+ * 64-bit divide; keep it out of per-particle loops
+ */
+inline q16_16 fxDiv(q16_16 a, q16_16 b) { return (q16_16)(((int64_t)a * FX_ONE) / b); }
+
+/**
+ * Scales an integer (e.g. a colour channel) by a Q8.8 factor
+ */
+inline int fx8Scale(int value, q8_8 factor) { return (value * factor) >> 8; }
+
+inline fx_angle fxAngleFromRadians(float radians) {
+  return (fx_angle)(int32_t)(radians * (65536.0f / 6.28318530718f));
+}
+
+// ---- Trig and roots ---------------------------------------------------------
+
+/**
+ * sin() of a binary angle in Q16.16, interpolated from the quarter-wave table
+ */
+inline q16_16 fxSin(fx_angle a) {
+  uint16_t p = a & (FX_QUARTER_TURN - 1);
+  if (a & FX_QUARTER_TURN) p = FX_QUARTER_TURN - p; // Second and fourth quarters run backwards
+  int i = p >> 6;
+  int f = p & 63;
+  int32_t v = FX_SIN_TABLE.v[i] + (((FX_SIN_TABLE.v[i + 1] - FX_SIN_TABLE.v[i]) * f) >> 6);
+  v <<= 2; // Q1.14 -> Q16.16
+  return (a & FX_HALF_TURN) ? -v : v;
+}
+
+inline q16_16 fxCos(fx_angle a) { return fxSin(a + FX_QUARTER_TURN); }
+
+/**
+ * Looks up 1/sqrt(x) for x > 0 as t * 2^(half - 6), t in Q1.15.
+ * x is normalised by an even power of two into [1, 4) first.
+ */
+inline int32_t fxInvSqrtMantissa(q16_16 x, int& half) {
+  int msb = 31 - __builtin_clz((uint32_t)x);
+  int s = (29 - msb) & ~1; // Even shift that puts the top bit at 28 or 29
+  uint32_t u = (s >= 0) ? ((uint32_t)x << s) : ((uint32_t)x >> -s);
+  half = s / 2;
+
+  int i = (u >> 23) - 32;
+  int f = (u >> 15) & 255;
+  return FX_INVSQRT_TABLE.v[i] - (((FX_INVSQRT_TABLE.v[i] - FX_INVSQRT_TABLE.v[i + 1]) * f) >> 8);
+}
+
+/**
+ * 1/sqrt(x) in Q16.16 for x > 0 (returns 0 otherwise)
+ */
+inline q16_16 fxInvSqrt(q16_16 x) {
+  if (x <= 0) return 0;
+  int half;
+  int32_t t = fxInvSqrtMantissa(x, half);
+  int shift = half - 5;
+  return (shift >= 0) ? (t << shift) : (t >> -shift);
+}
+
+/**
+ * a / sqrt(x) in Q16.16 for x > 0, e.g. normalising a vector by its squared length.
+ * The inverse is not rounded on its own, so this keeps precision for large x.
+ */
+inline q16_16 fxDivSqrt(q16_16 a, q16_16 x) {
+  if (x <= 0) return 0;
+  int half;
+  int32_t t = fxInvSqrtMantissa(x, half);
+  return (q16_16)(((int64_t)a * t) >> (21 - half));
+}
+
+inline q16_16 fxSqrt(q16_16 x) { return fxDivSqrt(x, x); }
+
+/**
+ * Length of (dx, dy), of at least 1, and the unit vector along it in dirX, dirY.
+ * The squared length only fits Q16.16 below 181, so it is summed in 64 bits and
+ * brought into range by an even shift, which the vector takes half of.
+ */
+inline q16_16 fxNormalize(q16_16 dx, q16_16 dy, q16_16& dirX, q16_16& dirY) {
+  int64_t lengthSq = (((int64_t)dx * dx) >> FX_SHIFT) + (((int64_t)dy * dy) >> FX_SHIFT);
+  if (lengthSq < FX_ONE) lengthSq = FX_ONE;
+  int shift = 0;
+  while ((lengthSq >> (2 * shift)) > INT32_MAX) shift++;
+  q16_16 x = (q16_16)(lengthSq >> (2 * shift));
+  dirX = fxDivSqrt(dx >> shift, x);
+  dirY = fxDivSqrt(dy >> shift, x);
+  return fxSqrt(x) << shift;
+}
+
+#endif // FIXEDPOINT_H
@@ -0,0 +1,112 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "fixedpoint.h"
+#include "trace.h"
+
+// Central frame clock. Simulation time advances in fixed SIM_STEP_US steps; each
+// frame banks the real time that passed and runs as many whole steps as fit,
+// and the leftover says how far between the last two steps the frame is drawn.
+// - Animations that are a function of time read timeMs.
+// - Integrators that move things by a fixed amount per update run that update
+//   once per step, so their speed no longer depends on the frame rate.
+// - Integrators written in seconds (deltaTime) use deltaUs.
+// loop() ticks the clock once per frame and paces itself with frameClockSleep().
+
+#define SIM_STEP_US 33333      // Fixed simulation step: 30 Hz, the warp frame rate the speeds were tuned at
+#define SIM_MAX_STEPS 4        // Most steps run in one frame; time beyond that is dropped, not caught up
+
+/**
+ * The clock as seen by one frame
+ */
+struct FrameTime {
+  uint32_t timeMs;   // Render time, use in place of millis() in animations
+  uint32_t deltaUs;  // Render time passed since the previous frame
+  uint8_t steps;     // Fixed steps to run this frame, may be 0
+  q16_16 alpha;      // Render time between the previous and the last step, 0..FX_ONE
+};
+
+namespace {
+  FrameTime frameClock = {0, 0, 0, 0};  // Current frame, only written by loop()
+  int64_t clockLastUs = -1;             // Real time of the previous tick, -1 before the first
+  int64_t clockSimUs = 0;               // Simulation time after the last step
+  int64_t clockRenderUs = 0;            // Render time of the previous tick
+  uint32_t clockAccumulatorUs = 0;      // Real time not yet turned into steps
+  TickType_t clockWakeTick = 0;         // Last wake-up of frameClockSleep()
+}
+
+/**
+ * Advances the clock to now; call once at the start of every frame
+ */
+void frameClockTick() {
+  int64_t now = traceClock(esp_timer_get_time()); // The recorded time while a trace replays
+  if (clockLastUs < 0) {
+    clockLastUs = now;
+    clockSimUs = now;
+    clockRenderUs = now - SIM_STEP_US;
+    clockAccumulatorUs = 0;
+    clockWakeTick = xTaskGetTickCount();
+  }
+  // Clamped at 0 as well: the live clock can be behind a replayed one when the trace ends
+  clockAccumulatorUs += (uint32_t)constrain(now - clockLastUs, (int64_t)0, (int64_t)SIM_STEP_US * (SIM_MAX_STEPS + 1));
+  clockLastUs = now;
+
+  uint8_t steps = 0;
+  while (clockAccumulatorUs >= SIM_STEP_US && steps < SIM_MAX_STEPS) {
+    clockAccumulatorUs -= SIM_STEP_US;
+    clockSimUs += SIM_STEP_US;
+    steps++;
+  }
+  clockAccumulatorUs %= SIM_STEP_US; // Still behind after SIM_MAX_STEPS: drop the rest
+
+  // Drawn between the previous and the last step, so stepped positions can be interpolated
+  int64_t renderUs = clockSimUs - SIM_STEP_US + clockAccumulatorUs;
+  frameClock.timeMs = (uint32_t)(renderUs / 1000);
+  frameClock.deltaUs = (uint32_t)(renderUs - clockRenderUs);
+  frameClock.steps = steps;
+  frameClock.alpha = (q16_16)(((int64_t)clockAccumulatorUs << FX_SHIFT) / SIM_STEP_US);
+  clockRenderUs = renderUs;
+}
+
+/**
+ * Sleeps until frameMs after the previous wake-up. A frame that already took
+ * longer does not sleep, and the schedule restarts from now instead of
+ * rushing the next frames to catch up.
+ */
+void frameClockSleep(uint32_t frameMs) {
+  TickType_t period = pdMS_TO_TICKS(frameMs);
+  if (xTaskGetTickCount() - clockWakeTick >= period) {
+    clockWakeTick = xTaskGetTickCount();
+    return;
+  }
+  vTaskDelayUntil(&clockWakeTick, period);
+}
+
+/**
+ * Time left until frameClockSleep(frameMs) would wake up, 0 if the frame is late
+ */
+uint32_t frameClockRemainingUs(uint32_t frameMs) {
+  TickType_t period = pdMS_TO_TICKS(frameMs);
+  TickType_t elapsed = xTaskGetTickCount() - clockWakeTick;
+  return elapsed >= period ? 0 : (period - elapsed) * portTICK_PERIOD_MS * 1000;
+}
+
+/**
+ * Starts the next frame's schedule from now, for a caller that waited on its own.
+ * The tick count may not have moved while the chip slept, so the wait is not
+ * added on top.
+ */
+void frameClockRestart() {
+  clockWakeTick = xTaskGetTickCount();
+}
+
+/**
+ * Interpolates a stepped position between its value one step ago and now
+ */
+inline q16_16 frameLerp(q16_16 previous, q16_16 current, q16_16 alpha) {
+  return previous + fxMul(current - previous, alpha);
+}
+
+#endif // FRAMECLOCK_H
@@ -0,0 +1,143 @@
+#ifndef GLOW_H
+#define GLOW_H
+
+#include <TFT_eSPI.h>
+#include "render.h"
+#include "arena.h"
+#include "blend.h"
+
+// Glow atlas. The star, the pulsar core, the binary stars and the comet head
+// look the same in every frame of a discovery. Their init functions render
+// them once, at the object's scale, into bitmaps taken from the object arena,
+// and each frame blits a bitmap instead of drawing dozens of circles and
+// single pixels. Black is transparent, so whatever is below shows through.
+// A bitmap is square with an odd side, and its centre pixel lands on (x, y).
+// An additive bitmap is light: it adds to what is below (blend.h add565)
+// instead of covering it, so overlapping glows brighten each other. The
+// buffered render modes can do that; direct mode cannot read the panel back
+// and draws it like any other.
+
+#define GLOW_MAX_SCALE (2.4f * PANEL_SCALE) // Largest objectScale processInput() picks, for sizing the arena
+#define GLOW_BYTES(half) ARENA_SIZE(uint16_t, (2 * (half) + 1) * (2 * (half) + 1))
+
+/**
+ * One bitmap per kind of glow; only the slots of the object on screen are valid
+ */
+enum GlowSlot : uint8_t {
+  GLOW_STAR,
+  GLOW_PULSAR_CORE,
+  GLOW_BINARY_PRIMARY,
+  GLOW_BINARY_COMPANION,
+  GLOW_COMET_HEAD,
+  GLOW_SLOTS
+};
+
+struct GlowSprite {
+  uint16_t* pixels; // Panel byte order, row by row; 0 is transparent
+  int16_t half;     // Pixels either side of the centre
+  bool additive;    // Added to the frame instead of copied over it
+};
+
+namespace {
+  GlowSprite glowAtlas[GLOW_SLOTS] = {};
+}
+
+/**
+ * Distance from the centre rounded to whole pixels, the ring drawCircle() would put it on
+ */
+inline int glowRing(int dx, int dy) {
+  return (int)(sqrtf((float)(dx * dx + dy * dy)) + 0.5f);
+}
+
+/**
+ * True if fillCircle() with radius r would cover the offset
+ */
+inline bool glowInDisc(int dx, int dy, int r) {
+  return dx * dx + dy * dy <= r * r + r;
+}
+
+/**
+ * Renders the bitmap of a slot; colorAt(dx, dy) gives the RGB565 colour at an
+ * offset from the centre, 0 where there is nothing. Call from an init
+ * function, after arenaReset(). Returns false if the arena is full.
+ */
+template <typename ColorAt>
+bool glowCreate(uint8_t slot, int half, ColorAt colorAt, bool additive = false) {
+  GlowSprite& sprite = glowAtlas[slot];
+  int side = 2 * half + 1;
+  sprite.pixels = arenaAlloc<uint16_t>(side * side);
+  sprite.half = half;
+  sprite.additive = additive;
+  if (!sprite.pixels) return false;
+
+  uint16_t* out = sprite.pixels;
+  for (int dy = -half; dy <= half; dy++) {
+    for (int dx = -half; dx <= half; dx++) {
+      uint16_t color = colorAt(dx, dy);
+      *out++ = (color >> 8) | (color << 8);
+    }
+  }
+  return true;
+}
+
+/**
+ * Copies (or, for an additive slot, adds) a slot's bitmap centred on (x, y)
+ * into a frame in panel byte order, clipped to its width x height
+ */
+void glowCopy(uint8_t slot, uint16_t* frame, int width, int height, int x, int y) {
+  const GlowSprite& sprite = glowAtlas[slot];
+  if (!sprite.pixels || !frame) return;
+  int side = 2 * sprite.half + 1;
+  int x0 = x - sprite.half;
+  int y0 = y - sprite.half;
+  int left = max(x0, 0);
+  int top = max(y0, 0);
+  int right = min(x0 + side, width);
+  int bottom = min(y0 + side, height);
+  if (left >= right || top >= bottom) return;
+
+  for (int py = top; py < bottom; py++) {
+    const uint16_t* in = sprite.pixels + (py - y0) * side + (left - x0);
+    uint16_t* out = frame + py * width + left;
+    if (sprite.additive) {
+      for (int px = left; px < right; px++, in++, out++) {
+        if (!*in) continue;
+        uint16_t sum = add565((*in >> 8) | (*in << 8), (*out >> 8) | (*out << 8));
+        *out = (sum >> 8) | (sum << 8);
+      }
+      continue;
+    }
+    for (int px = left; px < right; px++, in++, out++) {
+      if (*in) *out = *in;
+    }
+  }
+}
+
+/**
+ * Draws a slot's bitmap centred on (x, y), clipped to the screen
+ */
+void glowBlit(uint8_t slot, int x, int y) {
+  const GlowSprite& sprite = glowAtlas[slot];
+  if (!sprite.pixels) return;
+  int side = 2 * sprite.half + 1;
+  int x0 = x - sprite.half;
+  int y0 = y - sprite.half;
+
+#if RENDER_MODE == RENDER_DIRECT
+  // Sent as one window per run of visible pixels on each row
+#if PIXEL_BATCH
+  pixelBatch.flush();
+#endif
+  tft.pushImage(x0, y0, side, side, sprite.pixels, (uint16_t)0);
+#elif RENDER_MODE == RENDER_BANDED
+  frameRecorder.recordGlow(slot, x, y, sprite.half, sprite.pixels);
+#else
+  // Straight into the back buffer, which is in panel byte order as well
+  glowCopy(slot, (uint16_t*)backBuffer.getPointer(), SCREEN_WIDTH, SCREEN_HEIGHT, x, y);
+#if RENDER_MODE == RENDER_TILED
+  backBuffer.markTiles(x0, y0, side, side);
+#endif
+#endif
+}
+
+#endif // GLOW_H
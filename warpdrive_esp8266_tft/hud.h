@@ -0,0 +1,223 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <TFT_eSPI.h>
+#include "render.h"
+
+// Retained HUD. Every overlay element (the name of the object on screen, and
+// with HUD_GAUGES a warp gauge and a frame rate counter) is rendered into its
+// own rows of a small atlas sprite, and only rendered again when what it
+// shows changes. The buffered render modes copy the visible elements over
+// each frame once the scene is drawn, which is a short loop per element and,
+// in tiled mode, no SPI while they stay the same. Direct mode cannot compose:
+// it pushes an element when it changes, and again every HUD_REFRESH_FRAMES
+// frames to mend whatever the scene drew across it. A hidden element is
+// cleared from the panel once. Black is transparent, as in the glow atlas.
+
+#ifndef HUD_GAUGES
+#define HUD_GAUGES 0 // 1 adds the warp gauge and the frame rate counter
+#endif
+
+#define HUD_TEXT_CHARS 16                    // Longest text an element holds
+#define HUD_ATLAS_WIDTH (HUD_TEXT_CHARS * 6) // GLCD font cells are 6 pixels wide
+#define HUD_TEXT_ROWS 8
+#define HUD_GAUGE_WIDTH 32
+#define HUD_GAUGE_ROWS 3
+#define HUD_MARGIN 2               // Gauge and counter distance from the screen edge
+#define HUD_REFRESH_FRAMES 15      // Direct mode: frames between pushes of an unchanged element
+#define HUD_FPS_INTERVAL_MS 500    // The frame rate counter changes at most this often
+
+enum HudSlot : uint8_t {
+  HUD_LABEL,      // Name of the object on screen, bottom centre
+  HUD_WARP_GAUGE, // Warp factor while in warp, top left
+  HUD_FPS,        // Frames per second, top right
+  HUD_SLOTS
+};
+
+struct HudElement {
+  int16_t atlasY;   // First atlas row
+  int16_t x, y;     // Top left on screen
+  int16_t w, h;     // Size of what is rendered; the atlas rows are transparent past w
+  uint32_t shows;   // Hash of what is rendered, so the same value is not rendered again
+  bool rendered;
+  bool visible;
+  bool changed;     // Direct mode: rendered again since the last push
+  bool onPanel;     // Direct mode: pushed at panelX..panelX + panelW and not cleared since
+  int16_t panelX, panelW;
+};
+
+extern TFT_eSprite hudAtlas;
+
+namespace {
+  HudElement hudElements[HUD_SLOTS] = {};
+  bool hudReady = false;
+  uint8_t hudFrame = 0;        // Direct mode refresh counter
+  int32_t hudFrameUs = 0;      // Smoothed frame time for the counter
+  uint32_t hudFpsMs = 0;       // When the counter last changed
+}
+
+/**
+ * Lays out the elements and takes the atlas from the heap; call once the
+ * display is up. Without room for the atlas there is no HUD.
+ */
+void hudBegin() {
+  if (hudReady) return;
+  const int16_t rows[HUD_SLOTS] = {HUD_TEXT_ROWS, HUD_GAUGE_ROWS, HUD_TEXT_ROWS};
+  int atlasRows = 0;
+  for (int i = 0; i < HUD_SLOTS; i++) {
+    hudElements[i].atlasY = atlasRows;
+    hudElements[i].h = rows[i];
+    atlasRows += rows[i];
+  }
+  hudElements[HUD_LABEL].y = SCREEN_HEIGHT - 10;
+  hudElements[HUD_WARP_GAUGE].x = HUD_MARGIN;
+  hudElements[HUD_WARP_GAUGE].y = HUD_MARGIN;
+  hudElements[HUD_FPS].y = HUD_MARGIN;
+
+  hudAtlas.setColorDepth(16);
+  hudReady = hudAtlas.createSprite(HUD_ATLAS_WIDTH, atlasRows) != nullptr;
+  if (!hudReady) {
+    Serial.println("HUD: atlas allocation failed, no overlay");
+    return;
+  }
+  hudAtlas.fillSprite(0);
+  hudAtlas.setTextWrap(false);
+  hudAtlas.setTextSize(1);
+}
+
+/**
+ * Starts rendering an element again if it does not show key yet; true if it has to be
+ */
+bool hudRender(HudElement& element, uint32_t key) {
+  element.visible = true;
+  if (!hudReady || (element.rendered && element.shows == key)) return false;
+  element.shows = key;
+  element.rendered = true;
+  element.changed = true;
+  hudAtlas.fillRect(0, element.atlasY, HUD_ATLAS_WIDTH, element.h, 0);
+  return true;
+}
+
+/**
+ * Shows text in an element, rendering it only if it differs from what the
+ * element holds. The label is centred, the counter right aligned.
+ */
+void hudSetText(uint8_t slot, const char* text, uint16_t color) {
+  HudElement& element = hudElements[slot];
+  uint32_t key = 2166136261u ^ color; // FNV-1a over the text
+  for (const char* c = text; *c; c++) key = (key ^ (uint8_t)*c) * 16777619u;
+  if (!hudRender(element, key)) return;
+
+  hudAtlas.setTextColor(color);
+  hudAtlas.setCursor(0, element.atlasY);
+  hudAtlas.print(text);
+  element.w = min((int)hudAtlas.textWidth(text), HUD_ATLAS_WIDTH);
+  element.x = slot == HUD_FPS ? SCREEN_WIDTH - HUD_MARGIN - element.w : (SCREEN_WIDTH - element.w) / 2;
+}
+
+/**
+ * Shows a bar filled to level (0..1) in an element
+ */
+void hudSetGauge(uint8_t slot, float level, uint16_t color) {
+  HudElement& element = hudElements[slot];
+  int filled = constrain((int)(level * HUD_GAUGE_WIDTH + 0.5f), 0, HUD_GAUGE_WIDTH);
+  if (!hudRender(element, filled ^ (uint32_t)color << 8)) return;
+
+  hudAtlas.drawRect(0, element.atlasY, HUD_GAUGE_WIDTH, element.h, TFT_DARKGREY);
+  if (filled > 0) hudAtlas.fillRect(0, element.atlasY, filled, element.h, color);
+  element.w = HUD_GAUGE_WIDTH;
+}
+
+/**
+ * Takes an element off the screen; what it holds is kept for when it comes back
+ */
+inline void hudHide(uint8_t slot) {
+  hudElements[slot].visible = false;
+}
+
+/**
+ * Feeds the gauge and the counter, once per frame; does nothing without HUD_GAUGES
+ */
+void hudUpdateGauges(bool warp, float warpFactor, uint32_t deltaUs, uint32_t timeMs) {
+#if HUD_GAUGES
+  if (warp) {
+    hudSetGauge(HUD_WARP_GAUGE, warpFactor, TFT_CYAN);
+  } else {
+    hudHide(HUD_WARP_GAUGE);
+  }
+
+  hudFrameUs = hudFrameUs == 0 ? deltaUs : hudFrameUs + (((int32_t)deltaUs - hudFrameUs) >> 3);
+  if (!hudElements[HUD_FPS].rendered || timeMs - hudFpsMs >= HUD_FPS_INTERVAL_MS) {
+    hudFpsMs = timeMs;
+    char text[HUD_TEXT_CHARS + 1];
+    snprintf(text, sizeof(text), "%d FPS", hudFrameUs > 0 ? (int)((1000000 + hudFrameUs / 2) / hudFrameUs) : 0);
+    hudSetText(HUD_FPS, text, TFT_DARKGREY);
+  }
+#endif
+}
+
+/**
+ * Copies an element over a frame in panel byte order, clipped to its width x
+ * height; (x, y) is the element's top left in the frame
+ */
+void hudCopy(uint8_t slot, uint16_t* frame, int width, int height, int x, int y) {
+  const HudElement& element = hudElements[slot];
+  if (!hudReady || !frame) return;
+  const uint16_t* atlas = (const uint16_t*)hudAtlas.getPointer();
+  int left = max(x, 0);
+  int top = max(y, 0);
+  int right = min(x + element.w, width);
+  int bottom = min(y + element.h, height);
+  for (int py = top; py < bottom; py++) {
+    const uint16_t* in = atlas + (element.atlasY + py - y) * HUD_ATLAS_WIDTH + (left - x);
+    uint16_t* out = frame + py * width + left;
+    for (int px = left; px < right; px++, in++, out++) {
+      if (*in) *out = *in;
+    }
+  }
+}
+
+/**
+ * Puts the visible elements over the frame; call after the scene, before presentFrame()
+ */
+void hudDraw() {
+  if (!hudReady) return;
+  hudFrame = (hudFrame + 1) % HUD_REFRESH_FRAMES;
+  for (int slot = 0; slot < HUD_SLOTS; slot++) {
+    HudElement& element = hudElements[slot];
+#if RENDER_MODE == RENDER_DIRECT
+    if (element.onPanel && (!element.visible || element.changed)) {
+      canvas.fillRect(element.panelX, element.y, element.panelW, element.h, BG_COLOR);
+      element.onPanel = false;
+    }
+    if (!element.visible || (element.onPanel && hudFrame != 0)) continue;
+
+#if PIXEL_BATCH
+    pixelBatch.flush();
+#endif
+    // Row by row, since an element is narrower than its atlas rows
+    const uint16_t* atlas = (const uint16_t*)hudAtlas.getPointer();
+    for (int row = 0; row < element.h; row++) {
+      tft.pushImage(element.x, element.y + row, element.w, 1,
+                    (uint16_t*)atlas + (element.atlasY + row) * HUD_ATLAS_WIDTH, (uint16_t)0);
+    }
+    element.panelX = element.x;
+    element.panelW = element.w;
+    element.onPanel = true;
+    element.changed = false;
+#else
+    if (!element.visible) continue;
+#if RENDER_MODE == RENDER_BANDED
+    frameRecorder.recordHud(slot, element.x, element.y, element.w, element.h,
+                            (uint16_t*)hudAtlas.getPointer() + element.atlasY * HUD_ATLAS_WIDTH, HUD_ATLAS_WIDTH);
+#else
+    hudCopy(slot, (uint16_t*)backBuffer.getPointer(), SCREEN_WIDTH, SCREEN_HEIGHT, element.x, element.y);
+#if RENDER_MODE == RENDER_TILED
+    backBuffer.markTiles(element.x, element.y, element.w, element.h);
+#endif
+#endif
+#endif
+  }
+}
+
+#endif // HUD_H
@@ -0,0 +1,121 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include "debuglog.h"
+
+// Potentiometer sampling off the render loop. A periodic esp_timer reads the
+// ADC once per tick, averages POT_OVERSAMPLE ticks, takes the median of the
+// last three averages and smooths that with an IIR filter. The result is
+// published in potValue, which loop() only reads.
+// If the timer cannot be started, readPotentiometer() samples inline instead.
+
+#define POT_SAMPLE_PERIOD_US 1000  // One ADC read per millisecond
+#define POT_OVERSAMPLE 4           // Reads averaged into one filter input
+#define POT_IIR_SHIFT 2            // Smoothing: each input moves the output 1/4 of the way
+#define POT_FILTER_FRACTION 4      // Extra bits of precision kept by the IIR state
+#define POT_MAX 4095               // 12-bit ADC
+#define POT_WARP_HYSTERESIS 24     // Either side of the warp threshold in processInput()
+
+// Forward declarations of external variables
+extern std::atomic<int> potValue;
+
+/**
+ * Filter state, only touched by whoever is sampling (the timer, or loop() as fallback)
+ */
+struct PotFilter {
+  uint8_t pin;
+  int sum;          // Reads so far towards the next average
+  uint8_t reads;
+  int history[3];   // Last three averages, for the median
+  bool primed;      // Filter has been started on a first average
+  int32_t smoothed; // IIR output << POT_FILTER_FRACTION
+};
+
+namespace {
+  PotFilter potFilter = {};
+  esp_timer_handle_t potTimer = nullptr;
+  bool potSamplerRunning = false;
+}
+
+/**
+ * Median of three
+ */
+inline int potMedian3(int a, int b, int c) {
+  return max(min(a, b), min(max(a, b), c));
+}
+
+/**
+ * Feeds one ADC read through the filter and publishes a new value once per average
+ */
+void potFilterSample(int raw) {
+  potFilter.sum += POT_MAX - raw; // Inverted to reverse the potentiometer direction
+  if (++potFilter.reads < POT_OVERSAMPLE) return;
+
+  int average = potFilter.sum / POT_OVERSAMPLE;
+  potFilter.sum = 0;
+  potFilter.reads = 0;
+
+  potFilter.history[0] = potFilter.history[1];
+  potFilter.history[1] = potFilter.history[2];
+  potFilter.history[2] = average;
+  if (!potFilter.primed) {
+    // No history for a median yet, start the filter on the first average
+    potFilter.history[0] = potFilter.history[1] = average;
+    potFilter.smoothed = (int32_t)average << POT_FILTER_FRACTION;
+    potFilter.primed = true;
+  }
+
+  int median = potMedian3(potFilter.history[0], potFilter.history[1], potFilter.history[2]);
+  potFilter.smoothed += (((int32_t)median << POT_FILTER_FRACTION) - potFilter.smoothed) >> POT_IIR_SHIFT;
+  potValue.store(potFilter.smoothed >> POT_FILTER_FRACTION, std::memory_order_relaxed);
+}
+
+/**
+ * Timer callback: runs in the esp_timer task, not an ISR, so analogRead() is allowed
+ */
+void potTimerTick(void*) {
+  potFilterSample(analogRead(potFilter.pin));
+}
+
+/**
+ * Starts background sampling of a potentiometer pin
+ */
+void potSamplerBegin(uint8_t pin) {
+  potFilter = PotFilter();
+  potFilter.pin = pin;
+
+  // Prime the filter so potValue is valid before the first tick
+  for (int i = 0; i < POT_OVERSAMPLE; i++) {
+    potFilterSample(analogRead(pin));
+  }
+
+  if (potTimer == nullptr) {
+    esp_timer_create_args_t args = {};
+    args.callback = potTimerTick;
+    args.name = "pot";
+    if (esp_timer_create(&args, &potTimer) != ESP_OK) {
+      potTimer = nullptr;
+      Serial.println("Pot sampler: no timer, sampling in the render loop");
+      return;
+    }
+  }
+  potSamplerRunning = esp_timer_start_periodic(potTimer, POT_SAMPLE_PERIOD_US) == ESP_OK;
+  if (!potSamplerRunning) {
+    Serial.println("Pot sampler: timer did not start, sampling in the render loop");
+  }
+}
+
+/**
+ * Stops background sampling (e.g. before deep sleep)
+ */
+void potSamplerEnd() {
+  if (potSamplerRunning) {
+    esp_timer_stop(potTimer);
+    potSamplerRunning = false;
+  }
+}
+
+#endif // INPUT_H
@@ -0,0 +1,177 @@
+#ifndef LENS_H
+#define LENS_H
+
+#include <TFT_eSPI.h>
+#include "render.h"
+#include "arena.h"
+
+// Gravitational lensing for the black hole. The frame drawn so far (the
+// starfield and the back of the accretion disk) is remapped in place around
+// the event horizon the way a point mass bends light: a pixel at distance t
+// from the centre shows what was at t - E^2 / t, E being the Einstein radius.
+// Stars near E are stretched into arcs of the Einstein ring, and between the
+// horizon and E the sky from the far side of the hole shows up mirrored. The
+// bend fades out towards the edge of the lens so it joins the rest of the frame.
+//
+// The source offset of every pixel comes from a map built once per discovery
+// for the horizon radius, one quadrant of it since the lens is round. Applying
+// it costs the same per pixel every frame. Pixels that read outwards (the
+// mirrored ones inside E) are gathered first. All others read towards the
+// centre and are written from the edge inwards, so each reads its source
+// before that is overwritten.
+//
+// It needs the whole frame in memory, so it only works in sprite and tiled
+// mode; elsewhere lensApply() does nothing.
+
+#ifndef BH_LENS
+#define BH_LENS (RENDER_MODE == RENDER_SPRITE || RENDER_MODE == RENDER_TILED)
+#endif
+
+#define LENS_EINSTEIN 1.5f // Einstein radius in horizon radii
+#define LENS_REACH 3.0f    // The bend is gone this many horizon radii out
+#define LENS_REACH_MAX 127 // Offsets are stored in a signed byte
+#define LENS_SKIP -128     // Map entry for a pixel the lens leaves alone
+
+/**
+ * Lens map size for the largest horizon radius, for sizing the object arena.
+ * The mirrored pixels lie in the ring between the horizon and E.
+ */
+#define LENS_REACH_FOR(horizon) ((int)((horizon) * LENS_REACH) < LENS_REACH_MAX ? (int)((horizon) * LENS_REACH) : LENS_REACH_MAX)
+#define LENS_BYTES(horizon) (ARENA_SIZE(LensOffset, (LENS_REACH_FOR(horizon) + 1) * (LENS_REACH_FOR(horizon) + 1)) + \
+                             ARENA_SIZE(uint16_t, (int)(3.1416f * (((horizon) * LENS_EINSTEIN + 1) * ((horizon) * LENS_EINSTEIN + 1) - \
+                                                                   ((horizon) - 1) * ((horizon) - 1)))))
+
+/**
+ * Where a pixel of the quadrant right of and below the centre reads from,
+ * relative to the centre; LENS_SKIP in x for a pixel left as it is
+ */
+struct LensOffset {
+  int8_t x, y;
+};
+
+struct LensMap {
+  LensOffset* offsets; // [reach + 1][reach + 1], row by row
+  uint16_t* mirrored;  // Scratch for the pixels that read outwards
+  int16_t reach;
+};
+
+namespace {
+  LensMap lensMap = {};
+}
+
+/**
+ * True for a map entry that reads from the far side of the centre
+ */
+inline bool lensMirrored(const LensOffset& offset) {
+  return offset.x < 0 || offset.y < 0;
+}
+
+/**
+ * Builds the lens map for a horizon radius from the object arena. Call from
+ * an init function, after arenaReset(). Returns false if the arena is full;
+ * lensApply() then does nothing.
+ */
+bool lensBuild(float horizon) {
+  lensMap = {};
+#if BH_LENS
+  int reach = LENS_REACH_FOR(horizon);
+  if (reach < 2) return false;
+  int side = reach + 1;
+  LensOffset* offsets = arenaAlloc<LensOffset>(side * side);
+  if (!offsets) return false;
+
+  float einsteinSq = sq(horizon * LENS_EINSTEIN);
+  int horizonSq = sq((int)round(horizon));
+  int count = 0; // Mirrored pixels in the whole disc
+  for (int dy = 0; dy <= reach; dy++) {
+    for (int dx = 0; dx <= reach; dx++) {
+      LensOffset& offset = offsets[dy * side + dx];
+      offset.x = LENS_SKIP;
+      int distSq = dx * dx + dy * dy;
+      if (distSq <= horizonSq || distSq >= reach * reach) continue; // Covered by the horizon, or past the lens
+
+      // Point-mass deflection, faded out towards the reach but nearly whole close in
+      float fade = 1.0f - sq(distSq / (float)(reach * reach));
+      float k = 1.0f - fade * einsteinSq / distSq; // Source distance over pixel distance
+      int sx = constrain((int)round(dx * k), -LENS_REACH_MAX, LENS_REACH_MAX);
+      int sy = constrain((int)round(dy * k), -LENS_REACH_MAX, LENS_REACH_MAX);
+      if (sx == dx && sy == dy) continue;
+      offset.x = sx;
+      offset.y = sy;
+      if (lensMirrored(offset)) count += (dx ? 2 : 1) * (dy ? 2 : 1);
+    }
+  }
+
+  uint16_t* mirrored = arenaAlloc<uint16_t>(count);
+  if (count && !mirrored) return false;
+  lensMap.offsets = offsets;
+  lensMap.mirrored = mirrored;
+  lensMap.reach = reach;
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Calls visit(dest, source) for the on-screen pixels of the lens centred on
+ * (cx, cy) whose entries are (mirrored) or are not (!mirrored), from the edge
+ * inwards; both are indices into the frame. A source off screen reads the
+ * pixel itself.
+ */
+template <typename Visit>
+void lensVisit(int cx, int cy, bool mirrored, Visit visit) {
+  const LensMap& map = lensMap;
+  int side = map.reach + 1;
+  for (int dy = map.reach; dy >= 0; dy--) {
+    const LensOffset* row = map.offsets + dy * side;
+    for (int dx = map.reach; dx >= 0; dx--) {
+      const LensOffset& offset = row[dx];
+      if (offset.x == LENS_SKIP || lensMirrored(offset) != mirrored) continue;
+      // The four mirror images of the entry; pixels on an axis only once
+      for (int quadrant = 0; quadrant < 4; quadrant++) {
+        if ((quadrant & 1) && dx == 0) continue;
+        if ((quadrant & 2) && dy == 0) continue;
+        int fx = (quadrant & 1) ? -1 : 1;
+        int fy = (quadrant & 2) ? -1 : 1;
+        int x = cx + fx * dx, y = cy + fy * dy;
+        if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) continue;
+        int sx = cx + fx * offset.x, sy = cy + fy * offset.y;
+        int dest = y * SCREEN_WIDTH + x;
+        bool onScreen = sx >= 0 && sy >= 0 && sx < SCREEN_WIDTH && sy < SCREEN_HEIGHT;
+        visit(dest, onScreen ? sy * SCREEN_WIDTH + sx : dest);
+      }
+    }
+  }
+}
+
+/**
+ * Bends what the frame shows around (cx, cy) through the lens map
+ */
+void lensApply(int cx, int cy) {
+#if BH_LENS
+  if (!lensMap.offsets) return;
+  if (cx + lensMap.reach < 0 || cy + lensMap.reach < 0 ||
+      cx - lensMap.reach >= SCREEN_WIDTH || cy - lensMap.reach >= SCREEN_HEIGHT) return;
+#if RENDER_MODE == RENDER_SPRITE
+  if (backBufferFrames == 0) return;
+#else
+  if (!backBufferReady) return;
+#endif
+  uint16_t* frame = (uint16_t*)backBuffer.getPointer();
+  uint16_t* mirrored = lensMap.mirrored;
+
+  // The mirrored pixels read from anywhere in the disc, so take their sources first
+  int count = 0;
+  lensVisit(cx, cy, true, [&](int, int source) { mirrored[count++] = frame[source]; });
+  lensVisit(cx, cy, false, [&](int dest, int source) { frame[dest] = frame[source]; });
+  count = 0;
+  lensVisit(cx, cy, true, [&](int dest, int) { frame[dest] = mirrored[count++]; });
+
+#if RENDER_MODE == RENDER_TILED
+  backBuffer.markTiles(cx - lensMap.reach, cy - lensMap.reach, 2 * lensMap.reach + 1, 2 * lensMap.reach + 1);
+#endif
+#endif
+}
+
+#endif // LENS_H
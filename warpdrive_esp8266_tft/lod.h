@@ -0,0 +1,57 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <Arduino.h>
+
+// Level-of-detail governor: compares the measured frame time with the frame
+// budget and moves a global detail level (0 = cheapest, LOD_MAX = full) down
+// quickly when frames run long and back up slowly when there is headroom.
+// Objects turn the level into their own budgets with lodBudget(), through a
+// <object>DetailBudget() hook next to their particle limits.
+
+#define LOD_MAX 255
+#define LOD_STEP_DOWN 32         // Detail dropped when over budget
+#define LOD_STEP_UP 8            // Detail regained when well under budget
+#define LOD_HEADROOM_PERCENT 75  // "Well under" means below this share of the budget
+#define LOD_SETTLE_FRAMES 10     // Frames to let the average catch up after a change
+#define LOD_AVERAGE_SHIFT 3      // Frame time average: each frame moves it 1/8 of the way
+
+namespace {
+  uint8_t lodDetail = LOD_MAX;  // Current detail level, only written by loop()
+  int32_t lodAverageUs = 0;     // Smoothed frame work time
+  uint8_t lodSettle = 0;        // Frames left before the next adjustment
+}
+
+/**
+ * Scales a count between its cheapest and full value by a detail level
+ */
+inline int lodBudget(uint8_t detail, int minCount, int maxCount) {
+  return minCount + (maxCount - minCount) * detail / LOD_MAX;
+}
+
+/**
+ * Feeds one frame's work time (everything but the frame delay) to the governor
+ */
+void lodUpdate(uint32_t workUs, uint32_t targetUs) {
+  if (lodAverageUs == 0) {
+    lodAverageUs = workUs;
+  } else {
+    lodAverageUs += ((int32_t)workUs - lodAverageUs) >> LOD_AVERAGE_SHIFT;
+  }
+
+  if (lodSettle > 0) {
+    lodSettle--;
+    return;
+  }
+
+  // The gap between the two thresholds is the hysteresis band: nothing changes in it
+  if (lodAverageUs > (int32_t)targetUs && lodDetail > 0) {
+    lodDetail = max(0, lodDetail - LOD_STEP_DOWN);
+    lodSettle = LOD_SETTLE_FRAMES;
+  } else if (lodAverageUs < (int32_t)(targetUs * LOD_HEADROOM_PERCENT / 100) && lodDetail < LOD_MAX) {
+    lodDetail = min(LOD_MAX, lodDetail + LOD_STEP_UP);
+    lodSettle = LOD_SETTLE_FRAMES;
+  }
+}
+
+#endif // LOD_H
@@ -0,0 +1,308 @@
+#ifndef MIRROR_H
+#define MIRROR_H
+
+#include <Arduino.h>
+#include "render.h"
+#include "profiler.h"
+#include "lod.h"
+#include "simulation.h"
+
+// Network mirror: streams what the panel shows, plus telemetry, to a viewer
+// over UDP (host/mirror_viewer.py). Off unless built with -DNET_MIRROR=1.
+//
+// After each frame, loop() copies tiles the panel was sent into packets,
+// run-length encoded where that is smaller. A low-priority task on the other
+// core sends them. Packets come from a fixed pool and travel through the same
+// lock-free queues as the sim pipeline. When the pool is empty, the tiles
+// stay marked and go out with a later frame, so the render loop never waits
+// on the network. UDP may still lose packets, so every tile is sent again
+// every MIRROR_REFRESH_MS.
+//
+// Packets start with a MirrorHeader. Pixels are RGB565 in panel byte order
+// (high byte first). A RLE tile is a list of [count - 1][pixel] runs.
+// Everything else is little-endian.
+// The mirror needs the tiled back buffer (RENDER_TILED), which tracks changed tiles.
+
+#ifndef NET_MIRROR
+#define NET_MIRROR 0
+#endif
+
+#if NET_MIRROR
+#if RENDER_MODE != RENDER_TILED
+#error "NET_MIRROR needs RENDER_MODE == RENDER_TILED"
+#endif
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifndef MIRROR_SSID
+#define MIRROR_SSID ""               // Network to join, e.g. -DMIRROR_SSID=\"lab\"
+#endif
+#ifndef MIRROR_PASSWORD
+#define MIRROR_PASSWORD ""
+#endif
+#ifndef MIRROR_HOST
+#define MIRROR_HOST "255.255.255.255" // Viewer address; broadcast reaches a viewer anywhere on the network
+#endif
+#ifndef MIRROR_PORT
+#define MIRROR_PORT 5005
+#endif
+
+#define MIRROR_MAGIC 0x4D57              // "WM" in the first two bytes
+#define MIRROR_RUN_TILES 8               // Tiles of one row per packet
+#define MIRROR_TILES_PER_FRAME 64        // Tiles encoded per frame at most
+#define MIRROR_PACKETS 12                // Packets in flight
+#define MIRROR_REFRESH_MS 2000           // Every tile is sent again this often
+#define MIRROR_TELEMETRY_MS 250
+#define MIRROR_RETRY_MS 500              // Wi-Fi status poll while the link is down
+#define MIRROR_TASK_CORE 0               // Same core as the sim task, below its priority
+#define MIRROR_TASK_PRIORITY 0
+#define MIRROR_TASK_STACK 4096
+#define MIRROR_RUN_PIXELS (MIRROR_RUN_TILES * TILE_SIZE * TILE_SIZE)
+
+enum MirrorPacketType : uint8_t {
+  MIRROR_TILE_RAW,
+  MIRROR_TILE_RLE,
+  MIRROR_TELEMETRY
+};
+
+struct MirrorHeader {
+  uint16_t magic;
+  uint8_t type;
+  uint8_t reserved;
+  uint32_t frame;    // Frames since boot
+};
+
+/**
+ * A rectangle of pixels; raw holds w * h pixels, RLE as many runs as fit the length
+ */
+struct MirrorTile {
+  MirrorHeader header;
+  uint16_t x, y;
+  uint16_t w, h;
+};
+
+/**
+ * The last sample of each main loop section (see profiler.h), then the state
+ */
+struct MirrorTelemetry {
+  MirrorHeader header;
+  uint16_t panelWidth, panelHeight;
+  uint16_t pot;
+  uint8_t state;        // State, in declaration order
+  uint8_t object;       // CelestialObject, or 0xFF when none is shown
+  uint8_t detail;
+  uint8_t reserved[3];
+  uint32_t skippedTiles; // Tiles put off to a later frame because no packet was free
+  uint32_t sectionUs[PROF_OBJECT_DRAW];
+  uint32_t panelPixels;
+  uint32_t panelBytes;
+};
+
+struct MirrorPacket {
+  uint16_t length;
+  uint8_t data[sizeof(MirrorTile) + MIRROR_RUN_PIXELS * sizeof(uint16_t)];
+};
+
+static_assert(sizeof(MirrorTelemetry) <= sizeof(MirrorPacket::data), "Telemetry must fit a packet");
+
+namespace {
+  MirrorPacket mirrorPackets[MIRROR_PACKETS];
+  SpscQueue<MirrorPacket*, MIRROR_PACKETS + 1> mirrorFreePackets;   // Sender task -> loop()
+  SpscQueue<MirrorPacket*, MIRROR_PACKETS + 1> mirrorFilledPackets; // loop() -> sender task
+  std::atomic<bool> mirrorLinkUp{false};
+  TaskHandle_t mirrorTask = nullptr;
+  WiFiUDP mirrorUdp;
+
+  // Only touched by loop()
+  bool mirrorReady = false;
+  bool mirrorWasLinked = false;
+  tile_mask mirrorStale[TILE_ROWS];  // Tiles the viewer has an old copy of
+  uint8_t mirrorRow = 0;             // Row the next frame starts encoding from
+  uint32_t mirrorFrameCount = 0;
+  uint32_t mirrorSkipped = 0;
+  unsigned long mirrorLastRefresh = 0;
+  unsigned long mirrorLastTelemetry = 0;
+}
+
+/**
+ * Sender task: joins the network, then sends packets as loop() fills them
+ */
+void mirrorTaskMain(void*) {
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(MIRROR_SSID, MIRROR_PASSWORD);
+  for (;;) {
+    if (WiFi.status() != WL_CONNECTED) {
+      mirrorLinkUp = false;
+      vTaskDelay(pdMS_TO_TICKS(MIRROR_RETRY_MS));
+      continue;
+    }
+    mirrorLinkUp = true;
+
+    MirrorPacket* packet;
+    if (!mirrorFilledPackets.pop(packet)) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MIRROR_TELEMETRY_MS));
+      continue;
+    }
+    mirrorUdp.beginPacket(MIRROR_HOST, MIRROR_PORT);
+    mirrorUdp.write(packet->data, packet->length);
+    mirrorUdp.endPacket(); // A lost packet is healed by the next refresh
+    mirrorFreePackets.push(packet);
+  }
+}
+
+/**
+ * Starts the sender task; the mirror stays off if it cannot
+ */
+void mirrorBegin() {
+  for (int i = 0; i < MIRROR_PACKETS; i++) {
+    mirrorFreePackets.push(&mirrorPackets[i]);
+  }
+  if (xTaskCreatePinnedToCore(mirrorTaskMain, "mirror", MIRROR_TASK_STACK, nullptr,
+                              MIRROR_TASK_PRIORITY, &mirrorTask, MIRROR_TASK_CORE) != pdPASS) {
+    Serial.println("Mirror: could not start the sender task, mirror off");
+    return;
+  }
+  mirrorReady = true;
+  Serial.printf("Mirror: sending to %s:%d once %s is joined\n", MIRROR_HOST, MIRROR_PORT, MIRROR_SSID);
+}
+
+inline void mirrorHeader(MirrorHeader& header, uint8_t type) {
+  header.magic = MIRROR_MAGIC;
+  header.type = type;
+  header.reserved = 0;
+  header.frame = mirrorFrameCount;
+}
+
+/**
+ * Copies tiles col0..col1 of a row into a packet, as runs if that is smaller
+ */
+void mirrorEncodeRun(MirrorPacket& packet, int row, int col0, int col1) {
+  const uint16_t* img = (const uint16_t*)backBuffer.getPointer();
+  MirrorTile tile;
+  tile.x = col0 * TILE_SIZE;
+  tile.y = row * TILE_SIZE;
+  tile.w = min((col1 - col0 + 1) * TILE_SIZE, SCREEN_WIDTH - tile.x);
+  tile.h = min(TILE_SIZE, SCREEN_HEIGHT - tile.y);
+  int pixels = tile.w * tile.h;
+  uint8_t* out = packet.data + sizeof(MirrorTile);
+  uint8_t* end = out + pixels * sizeof(uint16_t); // Past this, raw is smaller
+
+  // Runs of one colour: a count byte and the pixel as stored
+  uint8_t* next = out;
+  uint16_t color = img[tile.y * SCREEN_WIDTH + tile.x];
+  int run = 0;
+  for (int y = 0; y < tile.h && next <= end; y++) {
+    const uint16_t* line = img + (tile.y + y) * SCREEN_WIDTH + tile.x;
+    for (int x = 0; x < tile.w; x++) {
+      if (line[x] == color && run < 256) {
+        run++;
+        continue;
+      }
+      if (next + 3 > end) {
+        next = end + 1;
+        break;
+      }
+      *next++ = run - 1;
+      memcpy(next, &color, sizeof(color));
+      next += sizeof(color);
+      color = line[x];
+      run = 1;
+    }
+  }
+  if (next + 3 <= end) {
+    *next++ = run - 1;
+    memcpy(next, &color, sizeof(color));
+    next += sizeof(color);
+    mirrorHeader(tile.header, MIRROR_TILE_RLE);
+  } else {
+    for (int y = 0; y < tile.h; y++) {
+      memcpy(out + y * tile.w * sizeof(uint16_t), img + (tile.y + y) * SCREEN_WIDTH + tile.x,
+             tile.w * sizeof(uint16_t));
+    }
+    next = end;
+    mirrorHeader(tile.header, MIRROR_TILE_RAW);
+  }
+  memcpy(packet.data, &tile, sizeof(tile));
+  packet.length = next - packet.data;
+}
+
+/**
+ * Queues the frame's changed tiles and, now and then, the telemetry.
+ * Call after presentFrame(); returns at once if no packet is free.
+ */
+void mirrorFrame(uint8_t state, uint8_t object, int pot) {
+  if (!mirrorReady) return;
+  mirrorFrameCount++;
+
+  // Everything the panel was sent is news to the viewer
+  for (int row = 0; row < TILE_ROWS; row++) {
+    mirrorStale[row] |= backBuffer.pushedTileMask(row);
+  }
+
+  bool linked = mirrorLinkUp.load();
+  unsigned long now = millis();
+  if (!linked) {
+    mirrorWasLinked = false;
+    return;
+  }
+  if (!mirrorWasLinked || now - mirrorLastRefresh >= MIRROR_REFRESH_MS) {
+    // A new viewer, or packets lost since the last refresh: send it all again
+    for (int row = 0; row < TILE_ROWS; row++) mirrorStale[row] = tileSpan(0, TILE_COLS - 1);
+    mirrorLastRefresh = now;
+    mirrorWasLinked = true;
+  }
+
+  MirrorPacket* packet;
+  if (now - mirrorLastTelemetry >= MIRROR_TELEMETRY_MS && mirrorFreePackets.pop(packet)) {
+    MirrorTelemetry telemetry = {};
+    mirrorHeader(telemetry.header, MIRROR_TELEMETRY);
+    telemetry.panelWidth = SCREEN_WIDTH;
+    telemetry.panelHeight = SCREEN_HEIGHT;
+    telemetry.pot = pot;
+    telemetry.state = state;
+    telemetry.object = object;
+    telemetry.detail = lodDetail;
+    telemetry.skippedTiles = mirrorSkipped;
+#if PROFILER_ENABLED
+    for (int i = 0; i < PROF_OBJECT_DRAW; i++) telemetry.sectionUs[i] = profSections[i].latest();
+    telemetry.panelPixels = profCounters[PROF_PANEL_PIXELS].latest();
+    telemetry.panelBytes = profCounters[PROF_PANEL_BYTES].latest();
+#endif
+    memcpy(packet->data, &telemetry, sizeof(telemetry));
+    packet->length = sizeof(telemetry);
+    mirrorFilledPackets.push(packet);
+    mirrorLastTelemetry = now;
+  }
+
+  // Rows take turns going first, so a busy frame cannot starve the bottom of the screen
+  int budget = MIRROR_TILES_PER_FRAME;
+  for (int i = 0; i < TILE_ROWS && budget > 0; i++) {
+    int row = (mirrorRow + i) % TILE_ROWS;
+    while (mirrorStale[row] && budget > 0) {
+      int col0 = __builtin_ctzll(mirrorStale[row]);
+      int col1 = col0;
+      int longest = min(MIRROR_RUN_TILES, budget);
+      while (col1 + 1 < TILE_COLS && col1 + 1 - col0 < longest && (mirrorStale[row] & TILE_BIT(col1 + 1))) col1++;
+
+      if (!mirrorFreePackets.pop(packet)) {
+        for (int r = 0; r < TILE_ROWS; r++) mirrorSkipped += __builtin_popcountll(mirrorStale[r]);
+        mirrorRow = row;
+        xTaskNotifyGive(mirrorTask);
+        return;
+      }
+      mirrorEncodeRun(*packet, row, col0, col1);
+      mirrorFilledPackets.push(packet);
+      mirrorStale[row] &= ~tileSpan(col0, col1);
+      budget -= col1 - col0 + 1;
+    }
+  }
+  mirrorRow = (mirrorRow + 1) % TILE_ROWS;
+  xTaskNotifyGive(mirrorTask);
+}
+#else
+inline void mirrorBegin() {}
+inline void mirrorFrame(uint8_t, uint8_t, int) {}
+#endif
+
+#endif // MIRROR_H
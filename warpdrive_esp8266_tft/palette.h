@@ -0,0 +1,105 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <Arduino.h>
+#include "fixedpoint.h"
+
+// Precomputed RGB565 colours for the gradients drawn in inner loops.
+// All tables are built by the compiler and live in flash, like the trig
+// tables in fixedpoint.h; a colour is one lookup instead of float maths
+// and a color565() per pixel.
+
+#define PAL_RAMP_STEPS 256       // Ramp index is an 8-bit level
+#define PAL_NEBULA_TEMPS 64      // Temperature axis, 0..1
+#define PAL_NEBULA_DENSITIES 16  // Brightness axis, 0.2..1.0 (density * 1.2, clamped)
+
+// ---- Table generation -------------------------------------------------------
+
+constexpr uint16_t palRgb(int r, int g, int b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+constexpr int palClamp(int v) {
+  return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+constexpr int palLerp(int from, int to, int i) {
+  return from + (to - from) * i / (PAL_RAMP_STEPS - 1);
+}
+
+// Colours are given as 0xRRGGBB
+constexpr uint16_t palRampEntry(int i, uint32_t from, uint32_t to) {
+  return palRgb(palLerp((from >> 16) & 0xFF, (to >> 16) & 0xFF, i),
+                palLerp((from >> 8) & 0xFF, (to >> 8) & 0xFF, i),
+                palLerp(from & 0xFF, to & 0xFF, i));
+}
+
+template <int... I>
+constexpr FxTable<uint16_t, sizeof...(I)> palMakeRamp(FxIndexList<I...>, uint32_t from, uint32_t to) {
+  return {{ palRampEntry(I, from, to)... }};
+}
+
+// Nebula blackbody-ish curve before density: cool reds and purples,
+// then blues, then hot blues and whites
+constexpr int palNebulaRed(double t) {
+  return t < 0.3 ? (int)(255 * t * 3) : (t < 0.6 ? (int)(150 - (t - 0.3) * 200) : (int)((t - 0.6) * 400));
+}
+
+constexpr int palNebulaGreen(double t) {
+  return t < 0.3 ? 0 : (t < 0.6 ? (int)((t - 0.3) * 200) : (int)(120 + (t - 0.6) * 300));
+}
+
+constexpr int palNebulaBlue(double t) {
+  return t < 0.3 ? (int)(100 * t) : (t < 0.6 ? (int)(150 + (t - 0.3) * 200) : 255);
+}
+
+constexpr uint16_t palNebulaShade(double t, double brightness) {
+  return palRgb(palClamp((int)(palNebulaRed(t) * brightness)),
+                palClamp((int)(palNebulaGreen(t) * brightness)),
+                palClamp((int)(palNebulaBlue(t) * brightness)));
+}
+
+constexpr uint16_t palNebulaEntry(int i) {
+  return palNebulaShade((double)(i / PAL_NEBULA_DENSITIES) / (PAL_NEBULA_TEMPS - 1),
+                        0.2 + 0.8 * (i % PAL_NEBULA_DENSITIES) / (PAL_NEBULA_DENSITIES - 1));
+}
+
+template <int... I>
+constexpr FxTable<uint16_t, sizeof...(I)> palMakeNebulaTable(FxIndexList<I...>) {
+  return {{ palNebulaEntry(I)... }};
+}
+
+namespace {
+  typedef FxMakeIndexList<PAL_RAMP_STEPS>::type PalRampIndex;
+
+  // Black to white
+  constexpr FxTable<uint16_t, PAL_RAMP_STEPS> PAL_GREY = palMakeRamp(PalRampIndex(), 0x000000, 0xFFFFFF);
+  // Black to the warm white of a star core
+  constexpr FxTable<uint16_t, PAL_RAMP_STEPS> PAL_STAR = palMakeRamp(PalRampIndex(), 0x000000, 0xFFFFF0);
+  // Black to the icy blue of a comet tail
+  constexpr FxTable<uint16_t, PAL_RAMP_STEPS> PAL_COMET_TAIL = palMakeRamp(PalRampIndex(), 0x000000, 0x80CCFF);
+  // Pure blue to white, for pulsar beams and corona
+  constexpr FxTable<uint16_t, PAL_RAMP_STEPS> PAL_PULSAR_BEAM = palMakeRamp(PalRampIndex(), 0x0000FF, 0xFFFFFF);
+  // Black to the pale blue of a pulsar ripple
+  constexpr FxTable<uint16_t, PAL_RAMP_STEPS> PAL_PULSAR_RIPPLE = palMakeRamp(PalRampIndex(), 0x000000, 0x5050FF);
+
+  // Nebula gas colour, [temperature][density] flattened
+  constexpr FxTable<uint16_t, PAL_NEBULA_TEMPS * PAL_NEBULA_DENSITIES> PAL_NEBULA =
+      palMakeNebulaTable(FxMakeIndexList<PAL_NEBULA_TEMPS * PAL_NEBULA_DENSITIES>::type());
+}
+
+static_assert(PAL_GREY.v[255] == 0xFFFF && PAL_GREY.v[128] == palRgb(128, 128, 128), "Grey ramp must be exact");
+
+// ---- Lookups ----------------------------------------------------------------
+
+/**
+ * Nebula gas colour for a temperature (0 cool .. 1 hot) and density
+ */
+inline uint16_t paletteNebula(float temperature, float density) {
+  int t = constrain((int)(temperature * (PAL_NEBULA_TEMPS - 1) + 0.5f), 0, PAL_NEBULA_TEMPS - 1);
+  int d = constrain((int)((density * 1.2f - 0.2f) * ((PAL_NEBULA_DENSITIES - 1) / 0.8f) + 0.5f),
+                    0, PAL_NEBULA_DENSITIES - 1);
+  return PAL_NEBULA.v[t * PAL_NEBULA_DENSITIES + d];
+}
+
+#endif // PALETTE_H
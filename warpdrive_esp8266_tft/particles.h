@@ -0,0 +1,101 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <Arduino.h>
+
+// Pooled particle storage shared by the particle effects. Live particles are
+// kept packed at the front of the pool, so spawning is taking the next slot
+// and killing moves the last live particle into the hole: both are O(1), and
+// every pass touches only live particles, however large the pool is.
+// Killing reorders the pool, so a particle must not be identified by its index
+// from one frame to the next.
+//
+// What a particle does is given by a traits struct of static functions, which
+// the compiler inlines into the passes:
+//
+//   struct Traits {
+//     struct Context { ... };                         // Per-frame inputs of the passes
+//     static bool update(Particle&, Context&);        // Steps it; false kills it
+//     static void draw(const Particle&, Context&);
+//     static void erase(const Particle&, Context&);   // Only needed if erase() is called
+//   };
+//
+// A pool is a plain struct with no constructor, so it can come from the
+// object arena: zeroed memory is an empty pool.
+
+template <typename Particle, uint16_t N, typename Traits>
+struct ParticleSystem {
+  typedef typename Traits::Context Context;
+  static const uint16_t CAPACITY = N;
+
+  Particle items[N];    // items[0..count) are live
+  uint16_t count;
+  uint16_t spawnBudget; // Spawns left before the next beginSpawns()
+
+  /**
+   * Kills every particle
+   */
+  void clear() {
+    count = 0;
+    spawnBudget = 0;
+  }
+
+  uint16_t live() const { return count; }
+  Particle& operator[](uint16_t i) { return items[i]; }
+  const Particle& operator[](uint16_t i) const { return items[i]; }
+
+  /**
+   * Allows up to maxSpawns spawn() calls until the next beginSpawns()
+   */
+  void beginSpawns(uint16_t maxSpawns) {
+    spawnBudget = maxSpawns;
+  }
+
+  /**
+   * A free particle to fill in and count as live, or nullptr if the spawn
+   * budget is used up or liveLimit particles are live already. Its fields
+   * hold whatever the last particle in that slot left behind.
+   */
+  Particle* spawn(uint16_t liveLimit = N) {
+    if (spawnBudget == 0 || count >= min(liveLimit, N)) return nullptr;
+    spawnBudget--;
+    return &items[count++];
+  }
+
+  /**
+   * Kills a particle; the last live one takes its index
+   */
+  void kill(uint16_t i) {
+    if (i != --count) items[i] = items[count];
+  }
+
+  /**
+   * Kills live particles from the end down to n, erasing the ones killed
+   */
+  void truncate(uint16_t n, Context& context) {
+    while (count > n) Traits::erase(items[--count], context);
+  }
+
+  /**
+   * Steps every live particle and kills the ones whose update() says so
+   */
+  void update(Context& context) {
+    for (uint16_t i = 0; i < count;) {
+      if (Traits::update(items[i], context)) {
+        i++;
+      } else {
+        kill(i); // The particle moved in from the end is updated next
+      }
+    }
+  }
+
+  void draw(Context& context) {
+    for (uint16_t i = 0; i < count; i++) Traits::draw(items[i], context);
+  }
+
+  void erase(Context& context) {
+    for (uint16_t i = 0; i < count; i++) Traits::erase(items[i], context);
+  }
+};
+
+#endif // PARTICLES_H
@@ -0,0 +1,292 @@
+#ifndef PLANET_H
+#define PLANET_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "render.h"
+#include "frameclock.h"
+#include "arena.h"
+#include "rng.h"
+#include "blend.h"
+
+// The planet surface is generated once per planetSeed into an equirectangular
+// texture. Each frame only remaps it onto the disc through a sphere LUT built
+// for the current radius and light direction, then shifts the texture columns
+// to spin the planet.
+
+#define PLANET_TEX_W 128          // Texels around the equator, power of two so rotation wraps
+#define PLANET_TEX_H 64           // Texels from pole to pole
+#define PLANET_MAX_RADIUS ((int)(15 * 2.4f * PANEL_SCALE)) // Largest disc the LUT holds: the largest objectScale
+#define PLANET_DIAMETER (2 * PLANET_MAX_RADIUS + 1)
+#define PLANET_ROTATION_MS 24000  // One full turn of the surface
+
+// Forward declarations of external variables
+extern TFT_eSPI& canvas; // Draw target, see render.h
+extern uint16_t BG_COLOR;
+extern const int SCREEN_WIDTH;
+extern const int SCREEN_HEIGHT;
+extern int objectX, objectY;
+extern float objectScale;
+
+/**
+ * Per-pixel sphere mapping for one disc radius, stored row by row.
+ * Only the pixels inside the disc are kept; row j starts at rowStart[j]
+ * and spans x = -halfWidth[j] .. halfWidth[j].
+ */
+struct PlanetSphereLut {
+    uint8_t u[PLANET_DIAMETER * PLANET_DIAMETER];     // Texture column, before rotation
+    uint8_t light[PLANET_DIAMETER * PLANET_DIAMETER]; // Ambient + diffuse, BLEND_ALPHA_MAX = fully lit
+    uint8_t haze[PLANET_DIAMETER * PLANET_DIAMETER];  // Atmosphere blend towards the limb, in blend.h alpha
+    uint16_t rowStart[PLANET_DIAMETER];
+    uint8_t halfWidth[PLANET_DIAMETER];
+    uint8_t v[PLANET_DIAMETER];                       // Texture row (latitude) of each disc row
+    int radius;
+};
+
+#define PLANET_ARENA_BYTES (ARENA_SIZE(uint16_t[PLANET_TEX_W], PLANET_TEX_H) + ARENA_SIZE(PlanetSphereLut, 1))
+
+// Static variables to hold the current planet's generated configuration
+namespace {
+    bool planetConfigured = false;
+    uint32_t planetSeed = 0; // Seed for procedural generation
+    uint16_t planetBaseColor1 = TFT_BLACK;
+    uint16_t planetBaseColor2 = TFT_BLACK;
+    uint16_t planetFeatureColor = TFT_BLACK; // For clouds/details
+    uint16_t planetAtmosColor = TFT_BLACK;
+    float lightAngle = 0.0f; // Angle from which light is coming (radians)
+    int planetType = 0;      // 0=Rocky, 1=Gas, 2=Earth-like, 3=Ice
+    int baseRadius = 0;      // Store base radius used for configuration
+
+    // From the object arena, see initPlanet()
+    uint16_t (*planetTexture)[PLANET_TEX_W] = nullptr; // [PLANET_TEX_H][PLANET_TEX_W]
+    PlanetSphereLut* planetLut = nullptr;
+}
+
+// Simple pseudo-random noise function (replace with Perlin/Simplex if available/performant)
+// Uses integer coordinates and a seed for deterministic noise
+float simpleNoise(int x, int y, uint32_t seed) {
+    // Simple hash-like function - basic but gives variation
+    uint32_t hash = seed;
+    hash = (hash ^ 61) ^ (x * 31);
+    hash = hash + (y * 53);
+    hash = hash ^ (hash >> 16);
+    hash = hash * 0xDEADBEEF; // Mix it up
+    hash = hash ^ (hash >> 13);
+    return (hash & 0xFFFF) / 65535.0f; // Normalize to 0.0 - 1.0
+}
+
+// Helper to blend two colors, ratio 0.0 to 1.0
+uint16_t blendColor(uint16_t color1, uint16_t color2, float ratio) {
+    return blend565(color1, color2, blendAlphaFloat(ratio));
+}
+
+/**
+ * Generates the surface of the current planet into planetTexture.
+ * Texel (tx, ty) is sampled where the old per-pixel code used the disc offset,
+ * so features keep their size and look.
+ */
+void bakePlanetTexture() {
+    float featureThreshold;
+    switch (planetType) {
+        case 1: featureThreshold = 0.65f; break; // More prominent storms/bands
+        case 2: featureThreshold = 0.7f; break; // Clouds
+        default: featureThreshold = 0.9f; break; // Less frequent features
+    }
+
+    for (int ty = 0; ty < PLANET_TEX_H; ty++) {
+        int y = ty - PLANET_TEX_H / 2;
+        for (int tx = 0; tx < PLANET_TEX_W; tx++) {
+            int x = tx - PLANET_TEX_W / 2;
+
+            // Use multiple noise layers for more detail (adjust frequencies/amplitudes)
+            float noiseVal = simpleNoise(x / 2, y / 2, planetSeed) * 0.6f; // Base layer
+            noiseVal += simpleNoise(x * 2, y * 2, planetSeed + 1) * 0.3f; // Detail layer
+            noiseVal += simpleNoise(y / 4, x / 4, planetSeed + 2) * 0.1f; // Subtle large features (gas giant bands?)
+            noiseVal = constrain(noiseVal, 0.0f, 1.0f);
+
+            // Map noise to color gradient
+            uint16_t surfaceColor;
+            if (planetType == 2) { // Special case for Earth: bias towards water
+                surfaceColor = blendColor(planetBaseColor1, planetBaseColor2, constrain(noiseVal * 1.5f - 0.3f, 0.0f, 1.0f)); // More water
+            } else {
+                surfaceColor = blendColor(planetBaseColor1, planetBaseColor2, noiseVal);
+            }
+
+            // Cloud/Feature Layer
+            float featureNoise = simpleNoise(x * 3 + 50, y * 3, planetSeed + 3); // Different noise for features
+            if (featureNoise > featureThreshold) {
+                float featureIntensity = (featureNoise - featureThreshold) / (1.0f - featureThreshold); // How "strong" is the feature
+                surfaceColor = blendColor(surfaceColor, planetFeatureColor, constrain(featureIntensity * 0.8f, 0.0f, 0.8f)); // Blend feature color in
+            }
+
+            planetTexture[ty][tx] = surfaceColor;
+        }
+    }
+}
+
+/**
+ * Builds the sphere mapping, lighting and limb haze for a disc of the given radius
+ */
+void buildPlanetLut(int radius) {
+    float lightVecX = cos(lightAngle);
+    float lightVecY = sin(lightAngle);
+    int index = 0;
+
+    for (int j = 0; j <= 2 * radius; j++) {
+        int y = j - radius;
+        int halfWidth = (int)sqrtf((float)(radius * radius - y * y));
+        float ny = y / (float)radius;
+        float latitude = asinf(constrain(ny, -1.0f, 1.0f));
+
+        planetLut->rowStart[j] = index;
+        planetLut->halfWidth[j] = halfWidth;
+        planetLut->v[j] = constrain((int)((latitude / PI + 0.5f) * PLANET_TEX_H), 0, PLANET_TEX_H - 1);
+
+        for (int x = -halfWidth; x <= halfWidth; x++, index++) {
+            float nx = x / (float)radius;
+            float nz = sqrtf(max(0.0f, 1.0f - nx * nx - ny * ny));
+
+            // Longitude -90..90 degrees lands on a quarter turn either side of column 0
+            float longitude = atan2f(nx, nz);
+            planetLut->u[index] = (int)floorf(longitude / TWO_PI * PLANET_TEX_W) & (PLANET_TEX_W - 1);
+
+            // Dot product between light vector and pixel normal vector (approximated by the disc offset),
+            // with some ambient light so the shadow side isn't pitch black
+            float lightIntensity = 0.15f + max(0.0f, nx * lightVecX + ny * lightVecY) * 0.85f;
+            planetLut->light[index] = blendAlphaFloat(lightIntensity);
+
+            // Atmosphere haze near edge, stronger towards the limb
+            float edgeFactor = sqrtf(nx * nx + ny * ny); // 0 at center, 1 at edge
+            float hazeAmount = constrain(pow(edgeFactor, 4.0f) * 0.4f, 0.0f, 0.4f);
+            planetLut->haze[index] = blendAlphaFloat(hazeAmount);
+        }
+    }
+    planetLut->radius = radius;
+}
+
+/**
+ * Takes the texture and sphere LUT from the object arena; the first draw
+ * configures a new planet and fills them in
+ */
+void initPlanet() {
+    planetTexture = arenaAlloc<uint16_t[PLANET_TEX_W]>(PLANET_TEX_H);
+    planetLut = arenaAlloc<PlanetSphereLut>();
+    planetConfigured = false;
+}
+
+/**
+ * Draws a planet with atmosphere and surface details
+ * Modified to cycle through planet types
+ */
+void drawPlanet() {
+    int centerX = objectX;
+    int centerY = objectY;
+    float scale = max(0.1f, objectScale); // Ensure scale is positive
+    int currentRadius = min((int)round(15 * scale), PLANET_MAX_RADIUS);  // Slightly larger base radius
+
+    // If planet not configured OR the base radius changed significantly (needs regeneration)
+    if (!planetConfigured || abs(currentRadius - baseRadius) > 2) {
+        planetSeed = objectRng.next(); // New seed for this planet
+        planetType = objectRng.range(0, 4);       // 0=Rocky, 1=Gas, 2=Earth-like, 3=Ice
+        lightAngle = objectRng.range(0, 360) * DEG_TO_RAD; // Random light direction
+
+        // Define color palettes based on type
+        switch (planetType) {
+            case 0: // Rocky (Mars/Desert like)
+                planetBaseColor1 = canvas.color565(110, 70, 50);   // Dark Brown/Red
+                planetBaseColor2 = canvas.color565(210, 140, 90);  // Lighter Tan/Orange
+                planetFeatureColor = canvas.color565(180, 170, 160); // Wispy clouds/dust
+                planetAtmosColor = canvas.color565(230, 180, 150); // Thin, dusty atmosphere
+                break;
+            case 1: // Gas Giant (Jupiter/Saturn like)
+                planetBaseColor1 = canvas.color565(160, 140, 110); // Beige/Brown band
+                planetBaseColor2 = canvas.color565(220, 200, 170); // Lighter Cream band
+                planetFeatureColor = canvas.color565(240, 230, 220); // Bright Storms/swirls
+                planetAtmosColor = canvas.color565(210, 200, 180); // Hazy atmosphere
+                break;
+            case 2: // Earth-like
+                planetBaseColor1 = canvas.color565(20, 80, 160);   // Deep Ocean Blue
+                planetBaseColor2 = canvas.color565(50, 140, 70);   // Land Green
+                planetFeatureColor = canvas.color565(250, 250, 250); // White Clouds
+                planetAtmosColor = canvas.color565(180, 210, 240); // Blue sky atmosphere
+                break;
+            case 3: // Ice World
+                planetBaseColor1 = canvas.color565(150, 180, 210); // Shadowed Ice Blue
+                planetBaseColor2 = canvas.color565(220, 235, 255); // Bright Ice/Snow White
+                planetFeatureColor = canvas.color565(190, 210, 230); // Cracks / Light Blue features
+                planetAtmosColor = canvas.color565(210, 225, 245); // Very thin, bright atmosphere
+                break;
+        }
+        bakePlanetTexture();
+        planetLut->radius = 0; // Light direction changed, rebuild below
+        planetConfigured = true;
+        baseRadius = currentRadius; // Store the radius used for this configuration
+    }
+    if (planetLut->radius != currentRadius) {
+        buildPlanetLut(currentRadius);
+    }
+
+    // --- Drawing ---
+    int rotation = (frameClock.timeMs % PLANET_ROTATION_MS) * PLANET_TEX_W / PLANET_ROTATION_MS;
+    uint16_t span[PLANET_DIAMETER];
+
+    beginBatch(); // Optimize drawing speed
+
+    for (int j = 0; j <= 2 * currentRadius; j++) {
+        int screenY = centerY + j - currentRadius;
+        if (screenY < 0 || screenY >= SCREEN_HEIGHT) continue;
+
+        // Clip the row to the screen
+        int halfWidth = planetLut->halfWidth[j];
+        int xStart = max(-halfWidth, -centerX);
+        int xEnd = min(halfWidth, SCREEN_WIDTH - 1 - centerX);
+        if (xStart > xEnd) continue;
+
+        const uint16_t* texRow = planetTexture[planetLut->v[j]];
+        int index = planetLut->rowStart[j] + halfWidth;
+        for (int x = xStart; x <= xEnd; x++) {
+            uint16_t surface = texRow[(planetLut->u[index + x] + rotation) & (PLANET_TEX_W - 1)];
+            uint16_t litColor = scale565(surface, planetLut->light[index + x]);
+            span[x - xStart] = blend565(litColor, planetAtmosColor, planetLut->haze[index + x]);
+        }
+        pushSpan(centerX + xStart, screenY, xEnd - xStart + 1, 1, span);
+    }
+
+    // --- Draw Outer Atmosphere Glow (Softer version) ---
+    int glowRadiusStart = currentRadius + 1;
+    int glowRadiusEnd = currentRadius + max(2, (int)(6 * scale)); // Glow thickness scales
+    for (int r = glowRadiusEnd; r >= glowRadiusStart; r--) {
+        float progress = (float)(r - glowRadiusStart) / (float)(glowRadiusEnd - glowRadiusStart + 1); // 1.0 near planet, 0.0 far out
+        float alpha = (1.0 - progress) * 0.5f; // Fade out, max alpha less than 1.0
+
+        // Blend atmosphere color with background based on alpha
+        uint16_t glowColor = blendColor(BG_COLOR, planetAtmosColor, alpha);
+
+        // Draw circle - might be slow, consider drawing arcs or points if needed
+        canvasDrawCircle(centerX, centerY, r, glowColor);
+    }
+
+    endBatch(); // End optimized drawing
+}
+
+/**
+ * Erases the planet and resets the configuration flag.
+ */
+void erasePlanet() {
+#if !RENDER_FULL_REDRAW
+    int centerX = objectX;
+    int centerY = objectY;
+    float scale = max(0.1f, objectScale);
+    int currentRadius = round(15 * scale); // Match radius calculation in drawPlanet
+    int glowThickness = max(2, (int)(6 * scale)); // Match glow thickness
+
+    // Erase a circle slightly larger than the planet + atmosphere glow
+    int eraseRadius = currentRadius + glowThickness + 2; // Add buffer
+    canvasFillCircle(centerX, centerY, eraseRadius, BG_COLOR);
+#endif
+
+    // Signal that the planet needs to be re-configured on the next draw call
+    planetConfigured = false;
+}
+
+#endif // PLANET_H
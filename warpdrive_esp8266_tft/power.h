@@ -0,0 +1,153 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include "profiler.h"
+#include "lod.h"
+#include "frameclock.h"
+#include "render.h"
+#include "simulation.h"
+
+// Power policy for battery units. After each frame, loop() reports how long
+// the frame's work took. The CPU clock then steps down while even the next lower
+// clock would leave plenty of the frame budget over, and jumps back to full
+// speed as soon as a frame gets close to its budget, in warp, or
+// while the detail governor (lod.h) is trimming detail. Only 80, 160 and
+// 240 MHz are used: below 80 MHz the APB clock drops too, and SPI and the ADC
+// with it.
+// The rest of the frame is spent in light sleep with a timer wake-up instead
+// of idling, when it is long enough to be worth it and the sim core has
+// nothing to do.
+// Every frame's energy is estimated from the time spent at each clock and in
+// sleep, and lands in the profiler's "energy uJ" counter ('p' over serial).
+// Set -DPOWER_SAVE=0 to always run at 240 MHz and idle between frames.
+
+#ifndef POWER_SAVE
+#define POWER_SAVE 1
+#endif
+
+#ifndef POWER_LIGHT_SLEEP
+#if NET_MIRROR
+#define POWER_LIGHT_SLEEP 0 // Wi-Fi does not keep its link through a timer light sleep
+#else
+#define POWER_LIGHT_SLEEP POWER_SAVE
+#endif
+#endif
+
+#define POWER_DOWN_PERCENT 60   // Step down when the next lower clock would need less than this share of the budget
+#define POWER_UP_PERCENT 85     // Back to full speed as soon as one frame needs more than this
+#define POWER_SETTLE_FRAMES 15  // Frames between two steps down
+#define POWER_SLEEP_MIN_US 3000 // Shorter waits are not worth a light sleep
+#define POWER_WAKE_US 500       // Coming back from light sleep takes about this long, so the timer fires early by as much
+#define POWER_SUPPLY_MV 3300
+#define POWER_SLEEP_UA 800      // Light sleep current
+
+/**
+ * A CPU clock and what the chip draws at it, both cores running
+ */
+struct PowerLevel {
+  uint16_t mhz;
+  uint16_t activeUa;
+};
+
+// Midpoints of the ESP32 datasheet's modem-sleep ranges; the display and
+// backlight are not included
+const PowerLevel POWER_LEVELS[] = {
+  {80, 26000},
+  {160, 36000},
+  {240, 49000}
+};
+#define POWER_LEVEL_COUNT (sizeof(POWER_LEVELS) / sizeof(POWER_LEVELS[0]))
+#define POWER_FULL_SPEED (POWER_LEVEL_COUNT - 1)
+
+namespace {
+  uint8_t powerLevel = POWER_FULL_SPEED; // Index into POWER_LEVELS, only written by loop()
+  uint8_t powerSettle = 0;
+  int32_t powerAverageUs = 0;            // Smoothed frame work time at the current clock
+  uint32_t powerWorkUs = 0;              // Work time of the frame about to sleep
+  uint8_t powerWorkLevel = POWER_FULL_SPEED;
+}
+
+/**
+ * Energy in microjoules of spending us microseconds at a current
+ */
+inline uint32_t powerEnergyUj(uint32_t uA, uint32_t us) {
+  return (uint32_t)((uint64_t)uA * us * POWER_SUPPLY_MV / 1000000000ull);
+}
+
+/**
+ * Switches the CPU clock to a level
+ */
+void powerSetLevel(uint8_t level) {
+  if (level == powerLevel) return;
+  powerLevel = level;
+  powerAverageUs = 0; // Times measured at the old clock say little about the new one
+  setCpuFrequencyMhz(POWER_LEVELS[level].mhz);
+}
+
+/**
+ * Picks the clock for the next frame from this frame's work time (everything
+ * but the frame delay). fullSpeed asks for 240 MHz whatever the headroom.
+ */
+void powerUpdate(uint32_t workUs, uint32_t targetUs, bool fullSpeed) {
+  powerWorkUs = workUs;
+  powerWorkLevel = powerLevel;
+#if POWER_SAVE
+  if (powerAverageUs == 0) {
+    powerAverageUs = workUs;
+  } else {
+    powerAverageUs += ((int32_t)workUs - powerAverageUs) >> LOD_AVERAGE_SHIFT;
+  }
+
+  if (fullSpeed || lodDetail < LOD_MAX || workUs > targetUs * POWER_UP_PERCENT / 100) {
+    powerSetLevel(POWER_FULL_SPEED);
+    powerSettle = POWER_SETTLE_FRAMES;
+    return;
+  }
+  if (powerSettle > 0) {
+    powerSettle--;
+    return;
+  }
+  if (powerLevel > 0) {
+    // Assumes the work scales with the clock; SPI does not, so the real time is lower
+    uint32_t projectedUs = (uint32_t)powerAverageUs * POWER_LEVELS[powerLevel].mhz / POWER_LEVELS[powerLevel - 1].mhz;
+    if (projectedUs < targetUs * POWER_DOWN_PERCENT / 100) {
+      powerSetLevel(powerLevel - 1);
+      powerSettle = POWER_SETTLE_FRAMES;
+    }
+  }
+#endif
+}
+
+/**
+ * Waits out the rest of the frame like frameClockSleep(), in light sleep when
+ * that is possible, and books the frame's energy
+ */
+void powerSleep(uint32_t frameMs) {
+  uint32_t waitUs = frameClockRemainingUs(frameMs);
+  uint32_t sleptUs = 0;
+  unsigned long start = micros();
+#if POWER_LIGHT_SLEEP
+  if (waitUs >= POWER_SLEEP_MIN_US && simIdle()) {
+    releaseDisplay(); // DMA stops in light sleep, so the frame has to be out first
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup(waitUs - POWER_WAKE_US);
+    if (esp_light_sleep_start() == ESP_OK) {
+      sleptUs = max(1ul, micros() - start);
+      frameClockRestart();
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER); // Or it would end the deep sleep of powerOff()
+  }
+#endif
+  if (sleptUs == 0) {
+    frameClockSleep(frameMs);
+  }
+  uint32_t idleUs = (uint32_t)(micros() - start) - sleptUs;
+
+  profCount(PROF_ENERGY_UJ, powerEnergyUj(POWER_LEVELS[powerWorkLevel].activeUa, powerWorkUs) +
+                            powerEnergyUj(POWER_LEVELS[powerLevel].activeUa, idleUs) +
+                            powerEnergyUj(POWER_SLEEP_UA, sleptUs));
+}
+
+#endif // POWER_H
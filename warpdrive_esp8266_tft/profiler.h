@@ -0,0 +1,201 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// Frame profiler: scoped microsecond timers around the main loop stages and
+// the celestial object draw/erase calls, plus counters for what goes out over
+// SPI. Every sample lands in a small ring per section; send 'p' on the serial
+// port to print p50/p95/max of the recent samples.
+// Set -DPROFILER_ENABLED=0 to compile it all out.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROF_RING_SIZE 64      // Samples kept per section
+#define PROF_OBJECT_TYPES 12   // Must match CelestialObject::NUM_TYPES
+#define PROF_WINDOW_BYTES 11   // CASET + RASET + RAMWR command and parameter bytes per address window
+
+enum ProfSection : uint8_t {
+  PROF_FRAME,           // loop() from input to present, without the frame delay
+  PROF_READ_POT,
+  PROF_INPUT,
+  PROF_STARS,
+  PROF_WARP_STARS,
+  PROF_SHOOTING_STARS,
+  PROF_PRESENT,
+  PROF_FRAME_DELAY,
+  PROF_OBJECT_DRAW,                                   // One section per object type
+  PROF_OBJECT_ERASE = PROF_OBJECT_DRAW + PROF_OBJECT_TYPES,
+  PROF_SECTION_COUNT = PROF_OBJECT_ERASE + PROF_OBJECT_TYPES
+};
+
+enum ProfCounter : uint8_t {
+  PROF_PANEL_PIXELS,    // Pixels written to the panel per frame
+  PROF_PANEL_BYTES,     // SPI bytes per frame, pixel data plus address windows
+  PROF_ENERGY_UJ,       // Estimated energy of the previous frame, see power.h
+  PROF_COUNTER_COUNT
+};
+
+#if PROFILER_ENABLED
+/**
+ * Last PROF_RING_SIZE samples of one section or counter
+ */
+struct ProfRing {
+  uint32_t samples[PROF_RING_SIZE];
+  uint8_t head;   // Next slot to write
+  uint8_t count;  // Valid samples, up to PROF_RING_SIZE
+
+  void push(uint32_t value) {
+    samples[head] = value;
+    head = (head + 1) % PROF_RING_SIZE;
+    if (count < PROF_RING_SIZE) count++;
+  }
+
+  /**
+   * The newest sample, 0 before the first
+   */
+  uint32_t latest() const {
+    return count ? samples[(head + PROF_RING_SIZE - 1) % PROF_RING_SIZE] : 0;
+  }
+};
+
+namespace {
+  ProfRing profSections[PROF_SECTION_COUNT];
+  ProfRing profCounters[PROF_COUNTER_COUNT];
+  uint32_t profFrameCounts[PROF_COUNTER_COUNT]; // Running totals for the current frame
+
+  const char* const PROF_SECTION_NAMES[PROF_OBJECT_DRAW] = {
+    "frame", "readPotentiometer", "processInput", "updateStars",
+    "updateWarpStars", "updateShootingStars", "presentFrame", "frame delay"
+  };
+  const char* const PROF_COUNTER_NAMES[PROF_COUNTER_COUNT] = {
+    "panel pixels", "panel bytes", "energy uJ"
+  };
+}
+
+/**
+ * Timestamp for profRecord(), in microseconds
+ */
+inline int64_t profNow() {
+  return esp_timer_get_time();
+}
+
+/**
+ * Adds the time since start (from profNow()) to a section
+ */
+inline void profRecord(uint8_t section, int64_t start) {
+  profSections[section].push((uint32_t)(esp_timer_get_time() - start));
+}
+
+/**
+ * Times the enclosing block into a section
+ */
+class ProfScope {
+public:
+  explicit ProfScope(uint8_t section) : section(section), start(profNow()) {}
+  ~ProfScope() {
+    profRecord(section, start);
+  }
+
+private:
+  uint8_t section;
+  int64_t start;
+};
+
+#define PROF_CONCAT_(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+#define PROF_SCOPE(section) ProfScope PROF_CONCAT(profScope, __LINE__)(section)
+
+/**
+ * Counts one address window of pixels sent to the panel
+ */
+inline void profCountPanel(uint32_t pixels) {
+  profFrameCounts[PROF_PANEL_PIXELS] += pixels;
+  profFrameCounts[PROF_PANEL_BYTES] += pixels * 2 + PROF_WINDOW_BYTES;
+}
+
+/**
+ * Adds to one of the frame's counters
+ */
+inline void profCount(uint8_t counter, uint32_t value) {
+  profFrameCounts[counter] += value;
+}
+
+/**
+ * A counter's total for the last frame closed by profEndFrame()
+ */
+inline uint32_t profLatestCount(uint8_t counter) {
+  return profCounters[counter].latest();
+}
+
+/**
+ * Closes the frame's counters into their rings
+ */
+void profEndFrame() {
+  for (int i = 0; i < PROF_COUNTER_COUNT; i++) {
+    profCounters[i].push(profFrameCounts[i]);
+    profFrameCounts[i] = 0;
+  }
+}
+
+/**
+ * Prints p50/p95/max of one ring, if it has samples
+ */
+void profPrintRing(const char* name, int index, const ProfRing& ring, const char* unit) {
+  if (ring.count == 0) return;
+
+  // Insertion sort of at most PROF_RING_SIZE values, only done on request
+  uint32_t sorted[PROF_RING_SIZE];
+  for (int i = 0; i < ring.count; i++) {
+    uint32_t value = ring.samples[i];
+    int j = i;
+    while (j > 0 && sorted[j - 1] > value) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = value;
+  }
+
+  uint32_t p50 = sorted[(ring.count - 1) / 2];
+  uint32_t p95 = sorted[(ring.count - 1) * 95 / 100];
+  uint32_t peak = sorted[ring.count - 1];
+  if (index >= 0) {
+    Serial.printf("  %-10s %-8s n=%-3u p50=%lu p95=%lu max=%lu %s\n", name, index < PROF_OBJECT_TYPES ? "draw" : "erase",
+                  ring.count, (unsigned long)p50, (unsigned long)p95, (unsigned long)peak, unit);
+  } else {
+    Serial.printf("  %-19s n=%-3u p50=%lu p95=%lu max=%lu %s\n", name,
+                  ring.count, (unsigned long)p50, (unsigned long)p95, (unsigned long)peak, unit);
+  }
+}
+
+/**
+ * Prints every section and counter that has samples.
+ * objectNames holds PROF_OBJECT_TYPES names in CelestialObject order.
+ */
+void profDump(const char* const* objectNames) {
+  Serial.println("Profile (last samples per section):");
+  for (int i = 0; i < PROF_OBJECT_DRAW; i++) {
+    profPrintRing(PROF_SECTION_NAMES[i], -1, profSections[i], "us");
+  }
+  for (int i = 0; i < 2 * PROF_OBJECT_TYPES; i++) {
+    profPrintRing(objectNames[i % PROF_OBJECT_TYPES], i, profSections[PROF_OBJECT_DRAW + i], "us");
+  }
+  for (int i = 0; i < PROF_COUNTER_COUNT; i++) {
+    profPrintRing(PROF_COUNTER_NAMES[i], -1, profCounters[i], "/frame");
+  }
+}
+
+#else
+#define PROF_SCOPE(section) do {} while (0)
+inline int64_t profNow() { return 0; }
+inline void profRecord(uint8_t, int64_t) {}
+inline void profCountPanel(uint32_t) {}
+inline void profCount(uint8_t, uint32_t) {}
+inline void profEndFrame() {}
+inline uint32_t profLatestCount(uint8_t) { return 0; }
+inline void profDump(const char* const*) {}
+#endif
+
+#endif // PROFILER_H
@@ -2,9 +2,14 @@
 #define PULSAR_H
 
 #include <TFT_eSPI.h>
+#include "render.h"
+#include "frameclock.h"
+#include "fixedpoint.h"
+#include "palette.h"
+#include "glow.h"
 
 // Forward declarations of external variables and constants
-extern TFT_eSPI tft;
+extern TFT_eSPI& canvas; // Draw target, see render.h
 extern uint16_t BG_COLOR;
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
@@ -13,88 +18,88 @@ extern float objectScale;
 
 // Pulsar parameters
 const float ROTATION_PERIOD = 2000.0f; // ms for one full rotation
+#define PULSAR_CORONA_WIDTH 3 // Rings around the core
+#define PULSAR_ARENA_BYTES GLOW_BYTES((int)(6 * GLOW_MAX_SCALE) + PULSAR_CORONA_WIDTH - 1)
 
 // Variables visible only within this module
 namespace {
     bool pulsarInitialized = false;
     int pulsarRadius = 0;
     int prevPulsarX = 0, prevPulsarY = 0;
-    float prevAngle = 0;
-    uint8_t intensityMap[128]; // Pre-calculated intensity map for beams
+    fx_angle prevAngle = 0;
 }
 
 // Function prototypes for internal functions
-void drawPulsarBeam(int centerX, int centerY, float angle, int baseRadius, float scale, float intensity, int maxLength);
-void drawPulsarRipple(int centerX, int centerY, int distance, float angle, float scale, float intensity, float distFactor);
-void erasePulsarBeam(int centerX, int centerY, float angle, int baseRadius, float scale, int maxLength);
-void erasePulsarRipple(int centerX, int centerY, int distance, float angle, float scale, float distFactor);
-void precalculateIntensityMap();
-
-void precalculateIntensityMap() {
-    for (int i = 0; i < 128; i++) {
-        float distFactor = (float)i / 128.0f;
-        intensityMap[i] = (uint8_t)(255 * (1.0f - distFactor * distFactor));
-    }
+void drawPulsarBeam(int centerX, int centerY, fx_angle angle, int baseRadius, float scale, q8_8 intensity, int maxLength);
+void drawPulsarRipple(int centerX, int centerY, int distance, q16_16 cosAngle, q16_16 sinAngle, float scale, q8_8 intensity, float distFactor);
+void erasePulsarBeam(int centerX, int centerY, fx_angle angle, int baseRadius, float scale, int maxLength);
+void erasePulsarRipple(int centerX, int centerY, int distance, q16_16 cosAngle, q16_16 sinAngle, float scale, float distFactor);
+
+/**
+ * Renders the core and its corona into the glow atlas
+ */
+void initPulsar() {
+    int radius = 6 * objectScale;
+    uint16_t coreColor = canvas.color565(200, 200, 255); // Bright blue-white
+    glowCreate(GLOW_PULSAR_CORE, radius + PULSAR_CORONA_WIDTH - 1, [=](int dx, int dy) -> uint16_t {
+        // Corona with 3D-like effect, its inner ring over the edge of the core
+        int ring = glowRing(dx, dy) - radius;
+        if (ring >= 0 && ring < PULSAR_CORONA_WIDTH) {
+            return PAL_PULSAR_BEAM.v[map(ring, 0, PULSAR_CORONA_WIDTH - 1, 180, 100)];
+        }
+        return glowInDisc(dx, dy, radius) ? coreColor : 0;
+    });
 }
 
 /**
  * Draws a pulsar - a rapidly rotating neutron star that emits beams of radiation
  */
 void drawPulsar() {
-    if (!pulsarInitialized) {
-        precalculateIntensityMap();
-        pulsarInitialized = true;
-    }
+    pulsarInitialized = true; // Beam falloff comes from FX_FALLOFF_TABLE, nothing to precompute
 
     int centerX = objectX;
     int centerY = objectY;
     float scale = objectScale;
     pulsarRadius = 6 * scale;
-    unsigned long currentTime = millis();
+    unsigned long currentTime = frameClock.timeMs;
 
     // Calculate current angle for continuous rotation
-    float currentAngle = (currentTime % (unsigned long)ROTATION_PERIOD) / ROTATION_PERIOD * 2 * PI;
+    fx_angle currentAngle = (fx_angle)((currentTime % (unsigned long)ROTATION_PERIOD) * 65536 / (unsigned long)ROTATION_PERIOD);
 
     // Calculate parameters for beam and core
     float time = currentTime / 1000.0f; // seconds
-    float intensity = 0.5f + 0.5f * sin(time); // 0-1 intensity for beams
+    q8_8 intensity = FX8_ONE / 2 + (fxSin(fxAngleFromRadians(time)) >> 9); // 0-1 intensity for beams
     int maxBeamLength = max(
         max(centerX, SCREEN_WIDTH - centerX),
         max(centerY, SCREEN_HEIGHT - centerY)
     ) + 10;
 
+#if !RENDER_FULL_REDRAW
     // Always erase previous beams before drawing new ones
     erasePulsarBeam(centerX, centerY, prevAngle, pulsarRadius, scale, maxBeamLength);
-    erasePulsarBeam(centerX, centerY, prevAngle + PI, pulsarRadius, scale, maxBeamLength);
+    erasePulsarBeam(centerX, centerY, prevAngle + FX_HALF_TURN, pulsarRadius, scale, maxBeamLength);
+#endif
     
     // Update previous position and angle
     prevPulsarX = centerX;
     prevPulsarY = centerY;
     prevAngle = currentAngle;
 
-    // Draw the pulsar's core
-    uint16_t coreColor = tft.color565(200, 200, 255); // Bright blue-white
-    tft.fillCircle(centerX, centerY, pulsarRadius, coreColor);
-
-    // Draw corona around the core with 3D-like effect
-    for (int i = 0; i < 3; i++) {
-        uint8_t brightness = map(i, 0, 2, 180, 100);
-        uint16_t coronaColor = tft.color565(brightness, brightness, 255);
-        tft.drawCircle(centerX, centerY, pulsarRadius + i, coronaColor);
-    }
+    // Draw the pulsar's core and corona
+    glowBlit(GLOW_PULSAR_CORE, centerX, centerY);
 
     // Draw the two radiation beams with intensity variation
     drawPulsarBeam(centerX, centerY, currentAngle, pulsarRadius, scale, intensity, maxBeamLength);
-    drawPulsarBeam(centerX, centerY, currentAngle + PI, pulsarRadius, scale, intensity, maxBeamLength);
+    drawPulsarBeam(centerX, centerY, currentAngle + FX_HALF_TURN, pulsarRadius, scale, intensity, maxBeamLength);
 
     // Pulse the core for a realistic effect
     float pulseFactor = 0.8f + 0.2f * sin(time * 3.0f);
-    uint16_t corePulseColor = tft.color565(
+    uint16_t corePulseColor = canvas.color565(
         200 * pulseFactor,
         200 * pulseFactor,
         255 * pulseFactor
     );
-    tft.fillCircle(centerX, centerY, pulsarRadius - 2, corePulseColor);
+    canvasFillCircle(centerX, centerY, pulsarRadius - 2, corePulseColor);
 
     // Update previous angle for the next frame
     prevAngle = currentAngle;
@@ -103,72 +108,76 @@ void drawPulsar() {
 /**
  * Draws a single pulsar radiation beam
  */
-void drawPulsarBeam(int centerX, int centerY, float angle, int baseRadius, float scale, float intensity, int maxLength) {
-    float cosAngle = cos(angle);
-    float sinAngle = sin(angle);
+void drawPulsarBeam(int centerX, int centerY, fx_angle angle, int baseRadius, float scale, q8_8 intensity, int maxLength) {
+    q16_16 cosAngle = fxCos(angle);
+    q16_16 sinAngle = fxSin(angle);
+    q16_16 originX = FX_FROM_INT(centerX);
+    q16_16 originY = FX_FROM_INT(centerY);
 
     for (int r = baseRadius; r < maxLength; r += 1) {
-        float distFactor = min(1.0f, 2.0f * (1.0f - (float)(r - baseRadius) / maxLength));
-        uint8_t beamIntensity = (uint8_t)(intensityMap[min(r, 127)] * intensity);
+        uint8_t beamIntensity = fx8Scale(FX_FALLOFF_TABLE.v[min(r, FX_FALLOFF_STEPS - 1)], intensity);
 
-        int x = centerX + cosAngle * r;
-        int y = centerY + sinAngle * r;
+        q16_16 beamX = originX + cosAngle * r;
+        q16_16 beamY = originY + sinAngle * r;
+        int x = beamX >> FX_SHIFT;
+        int y = beamY >> FX_SHIFT;
 
         if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-            uint16_t beamColor = tft.color565(beamIntensity, beamIntensity, 255);
-            tft.drawPixel(x, y, beamColor);
+            canvas.drawPixel(x, y, PAL_PULSAR_BEAM.v[beamIntensity]);
 
             // Add a simple 3D-like effect by drawing a faint trail
             if (r > baseRadius + 5) {
-                uint16_t trailColor = tft.color565(beamIntensity / 2, beamIntensity / 2, 255);
-                tft.drawPixel(x - cosAngle, y - sinAngle, trailColor);
+                canvas.drawPixel((FX_FROM_INT(x) - cosAngle) / FX_ONE, (FX_FROM_INT(y) - sinAngle) / FX_ONE,
+                                 PAL_PULSAR_BEAM.v[beamIntensity / 2]);
             }
         }
 
         // Add ripple effect at intervals
         if (r % 15 == 0 && r > baseRadius + 15) {
-            drawPulsarRipple(centerX, centerY, r, angle, scale, intensity * 0.7f, distFactor);
+            float distFactor = min(1.0f, 2.0f * (1.0f - (float)(r - baseRadius) / maxLength));
+            drawPulsarRipple(centerX, centerY, r, cosAngle, sinAngle, scale, intensity * 7 / 10, distFactor);
         }
     }
 }
 
 /**
- * Draws a ripple effect perpendicular to the beam
+ * Draws a ripple effect perpendicular to the beam.
+ * Walks outwards from the beam in half-pixel steps on both sides.
  */
-void drawPulsarRipple(int centerX, int centerY, int distance, float angle, float scale, float intensity, float distFactor) {
-    float rippleWidth = 6.0f * scale * distFactor;
-    float perpAngle = angle + PI / 2.0f;
+void drawPulsarRipple(int centerX, int centerY, int distance, q16_16 cosAngle, q16_16 sinAngle, float scale, q8_8 intensity, float distFactor) {
+    int steps = (int)(12.0f * scale * distFactor); // Ripple width in half pixels
+    if (steps <= 0) return;
+    q16_16 baseX = FX_FROM_INT(centerX) + cosAngle * distance;
+    q16_16 baseY = FX_FROM_INT(centerY) + sinAngle * distance;
+
+    for (int w = 0; w <= steps; w++) {
+        q8_8 rippleFactor = fx8Scale(FX8_ONE - w * FX8_ONE / steps, intensity);
+        if (rippleFactor < FX8_CONST(0.05)) continue;
 
-    for (float w = 0; w <= rippleWidth; w += 0.5f) {
-        float rippleFactor = (1.0f - (w / rippleWidth)) * intensity;
-        if (rippleFactor < 0.05f) continue;
+        // Perpendicular is (-sin, cos); offsets truncate towards zero like the float version did
+        int offsetX = (-sinAngle * w / 2) / FX_ONE;
+        int offsetY = (cosAngle * w / 2) / FX_ONE;
+        uint16_t rippleColor = PAL_PULSAR_RIPPLE.v[min((int)rippleFactor, PAL_RAMP_STEPS - 1)];
 
         for (int s = -1; s <= 1; s += 2) {
-            int offsetX = cos(perpAngle) * w * s;
-            int offsetY = sin(perpAngle) * w * s;
-            int x = centerX + cos(angle) * distance + offsetX;
-            int y = centerY + sin(angle) * distance + offsetY;
+            int x = (baseX >> FX_SHIFT) + offsetX * s;
+            int y = (baseY >> FX_SHIFT) + offsetY * s;
 
             if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                uint16_t rippleColor = tft.color565(
-                    80 * rippleFactor,
-                    80 * rippleFactor,
-                    255 * rippleFactor
-                );
-                tft.drawPixel(x, y, rippleColor);
+                canvas.drawPixel(x, y, rippleColor);
             }
         }
     }
 }
 
 // Erase functions remain largely the same
-void erasePulsarBeam(int centerX, int centerY, float angle, int baseRadius, float scale, int maxLength) {
-    float cosAngle = cos(angle);
-    float sinAngle = sin(angle);
+void erasePulsarBeam(int centerX, int centerY, fx_angle angle, int baseRadius, float scale, int maxLength) {
+    q16_16 cosAngle = fxCos(angle);
+    q16_16 sinAngle = fxSin(angle);
 
     for (int r = baseRadius; r < maxLength; r += 1) {
-        int x = centerX + cosAngle * r;
-        int y = centerY + sinAngle * r;
+        int x = (FX_FROM_INT(centerX) + cosAngle * r) >> FX_SHIFT;
+        int y = (FX_FROM_INT(centerY) + sinAngle * r) >> FX_SHIFT;
 
         // Erase pixels within a slightly larger area to cover the beam's width
         for (int dx = -1; dx <= 1; dx++) {
@@ -178,31 +187,32 @@ void erasePulsarBeam(int centerX, int centerY, float angle, int baseRadius, floa
 
                 if (eraseX >= 0 && eraseX < SCREEN_WIDTH &&
                     eraseY >= 0 && eraseY < SCREEN_HEIGHT) {
-                    tft.drawPixel(eraseX, eraseY, BG_COLOR);
+                    canvas.drawPixel(eraseX, eraseY, BG_COLOR);
                 }
             }
         }
 
         if (r % 15 == 0 && r > baseRadius + 15) {
-            erasePulsarRipple(centerX, centerY, r, angle, scale, 1.0f);
+            erasePulsarRipple(centerX, centerY, r, cosAngle, sinAngle, scale, 1.0f);
         }
     }
 }
 
 
-void erasePulsarRipple(int centerX, int centerY, int distance, float angle, float scale, float distFactor) {
-    float rippleWidth = 6.0f * scale * distFactor;
-    float perpAngle = angle + PI / 2.0f;
+void erasePulsarRipple(int centerX, int centerY, int distance, q16_16 cosAngle, q16_16 sinAngle, float scale, float distFactor) {
+    int steps = (int)(12.0f * scale * distFactor);
+    q16_16 baseX = FX_FROM_INT(centerX) + cosAngle * distance;
+    q16_16 baseY = FX_FROM_INT(centerY) + sinAngle * distance;
 
-    for (float w = 0; w <= rippleWidth; w += 0.5f) {
+    for (int w = 0; w <= steps; w++) {
+        int offsetX = (-sinAngle * w / 2) / FX_ONE;
+        int offsetY = (cosAngle * w / 2) / FX_ONE;
         for (int s = -1; s <= 1; s += 2) {
-            int offsetX = cos(perpAngle) * w * s;
-            int offsetY = sin(perpAngle) * w * s;
-            int x = centerX + cos(angle) * distance + offsetX;
-            int y = centerY + sin(angle) * distance + offsetY;
+            int x = (baseX >> FX_SHIFT) + offsetX * s;
+            int y = (baseY >> FX_SHIFT) + offsetY * s;
 
             if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                tft.drawPixel(x, y, BG_COLOR);
+                canvas.drawPixel(x, y, BG_COLOR);
             }
         }
     }
@@ -210,13 +220,15 @@ void erasePulsarRipple(int centerX, int centerY, int distance, float angle, floa
 
 void erasePulsar() {
     if (pulsarInitialized) {
-        tft.fillCircle(prevPulsarX, prevPulsarY, pulsarRadius + 3, BG_COLOR);
+#if !RENDER_FULL_REDRAW
+        canvasFillCircle(prevPulsarX, prevPulsarY, pulsarRadius + 3, BG_COLOR);
         int maxRadius = max(
             max(prevPulsarX, SCREEN_WIDTH - prevPulsarX),
             max(prevPulsarY, SCREEN_HEIGHT - prevPulsarY)
         ) + 10;
         erasePulsarBeam(prevPulsarX, prevPulsarY, prevAngle, pulsarRadius, objectScale, maxRadius);
-        erasePulsarBeam(prevPulsarX, prevPulsarY, prevAngle + PI, pulsarRadius, objectScale, maxRadius);
+        erasePulsarBeam(prevPulsarX, prevPulsarY, prevAngle + FX_HALF_TURN, pulsarRadius, objectScale, maxRadius);
+#endif
 
         pulsarInitialized = false;
     }
@@ -0,0 +1,931 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <TFT_eSPI.h>
+#include "profiler.h"
+#include "blend.h"
+
+// Panel geometry comes from TFT_WIDTH and TFT_HEIGHT in User_Setup.h, which
+// give the portrait size; rotations 1 and 3 are landscape
+#ifndef SCREEN_ROTATION
+#define SCREEN_ROTATION 2
+#endif
+#if SCREEN_ROTATION & 1
+#define PANEL_WIDTH TFT_HEIGHT
+#define PANEL_HEIGHT TFT_WIDTH
+#else
+#define PANEL_WIDTH TFT_WIDTH
+#define PANEL_HEIGHT TFT_HEIGHT
+#endif
+#define PANEL_MIN_SIDE (PANEL_WIDTH < PANEL_HEIGHT ? PANEL_WIDTH : PANEL_HEIGHT)
+#define PANEL_SCALE (PANEL_MIN_SIDE / 128.0f) // Objects are sized for 128 px and grow with the panel
+
+// Smallest type that holds any screen coordinate and SCREEN_NO_COORD
+#if PANEL_WIDTH < 255 && PANEL_HEIGHT < 255
+typedef uint8_t screen_coord;
+#else
+typedef uint16_t screen_coord;
+#endif
+#define SCREEN_NO_COORD ((screen_coord)~0) // "Not on screen"
+
+// Render modes - pick one at compile time with -DRENDER_MODE=... (or change the default below)
+#define RENDER_DIRECT 0 // Draw straight to the panel, erase by redrawing in BG_COLOR
+#define RENDER_SPRITE 1 // Compose each frame in a full-screen sprite and push it with DMA
+#define RENDER_TILED  2 // Compose each frame in a sprite, push only the 8x8 tiles that changed
+#define RENDER_BANDED 3 // Record each frame, then compose and push it a band of rows at a time
+
+// A full frame buffer has to fit next to everything else in DRAM; bigger panels render in bands
+#define FRAME_BUFFER_MAX_BYTES 65536
+
+#ifndef RENDER_MODE
+#if PANEL_WIDTH * PANEL_HEIGHT * 2 <= FRAME_BUFFER_MAX_BYTES
+#define RENDER_MODE RENDER_TILED
+#else
+#define RENDER_MODE RENDER_BANDED
+#endif
+#endif
+
+// Modes that rebuild the whole frame every time and need no erase bookkeeping
+#define RENDER_FULL_REDRAW (RENDER_MODE != RENDER_DIRECT)
+
+// Direct mode: collect single pixel writes and send them sorted, in runs
+#ifndef PIXEL_BATCH
+#define PIXEL_BATCH 1
+#endif
+#define PIXEL_BATCH_SIZE 1024 // Pixels held before a flush, 8 KB with the sort scratch (12 KB past 255 px)
+
+// Forward declarations of external variables
+extern TFT_eSPI tft;
+extern TFT_eSPI& canvas; // Draw target for all scene rendering (panel or back buffer)
+extern uint16_t BG_COLOR;
+extern const int SCREEN_WIDTH;
+extern const int SCREEN_HEIGHT;
+
+#if RENDER_MODE == RENDER_SPRITE
+extern TFT_eSprite backBuffer;
+
+// A switch between warp and discovery fades the last frame before it out over
+// the first frames after it. The old frame is copied to the heap for the fade
+// and freed after it; without room for the copy the cut stays hard.
+#define CROSSFADE_FRAMES 8
+
+namespace {
+  int8_t backBufferFrames = 0; // 2 = double buffered, 1 = single buffer, 0 = not allocated
+  int8_t backBufferFrame = 1;  // Frame currently being drawn into (1 or 2)
+  uint16_t* crossfadeFrame = nullptr; // Last frame before the switch, panel byte order
+  uint8_t crossfadeLeft = 0;          // Frames still to blend it into
+}
+#elif RENDER_MODE == RENDER_TILED
+// Dirty-tile grid laid over the back buffer
+#define TILE_SIZE 8
+#define TILE_COLS ((PANEL_WIDTH + TILE_SIZE - 1) / TILE_SIZE)
+#define TILE_ROWS ((PANEL_HEIGHT + TILE_SIZE - 1) / TILE_SIZE)
+
+// Each tile row is tracked in one mask, a bit per column; panels wider than 256 px need 64 bits
+#if TILE_COLS <= 32
+typedef uint32_t tile_mask;
+#else
+typedef uint64_t tile_mask;
+#endif
+#define TILE_BIT(col) ((tile_mask)1 << (col))
+
+static_assert(TILE_COLS <= 64, "Each tile row is tracked in one 64-bit mask");
+static_assert(TILE_COLS * TILE_SIZE >= PANEL_WIDTH && TILE_ROWS * TILE_SIZE >= PANEL_HEIGHT,
+              "The tile grid must cover the screen");
+
+/**
+ * Mask of the tile columns col0..col1
+ */
+inline tile_mask tileSpan(int col0, int col1) {
+  tile_mask upTo = (col1 >= (int)sizeof(tile_mask) * 8 - 1) ? ~(tile_mask)0 : (TILE_BIT(col1 + 1) - 1);
+  return upTo & ~(TILE_BIT(col0) - 1);
+}
+
+/**
+ * Back buffer that records which 8x8 tiles were drawn into.
+ * Only the primitives TFT_eSprite writes to memory itself are hooked;
+ * circles, triangles and lines are built from them. Anything that writes
+ * pixels some other way (e.g. pushImage) must call markTiles() itself.
+ */
+class TileCanvas : public TFT_eSprite {
+public:
+  explicit TileCanvas(TFT_eSPI* display) : TFT_eSprite(display) {}
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) override {
+    markTiles(x, y, 1, 1);
+    TFT_eSprite::drawPixel(x, y, color);
+  }
+
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) override {
+    markTiles(x, y, w, 1);
+    TFT_eSprite::drawFastHLine(x, y, w, color);
+  }
+
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) override {
+    markTiles(x, y, 1, h);
+    TFT_eSprite::drawFastVLine(x, y, h, color);
+  }
+
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override {
+    markTiles(x, y, w, h);
+    TFT_eSprite::fillRect(x, y, w, h, color);
+  }
+
+  void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) override {
+    markTiles(x, y, 6 * size, 8 * size); // GLCD font cell
+    TFT_eSprite::drawChar(x, y, c, color, bg, size);
+  }
+
+  /**
+   * Flags every tile under a rectangle as drawn this frame
+   */
+  void markTiles(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (w <= 0 || h <= 0) return;
+    int32_t x1 = x + w - 1;
+    int32_t y1 = y + h - 1;
+    if (x1 < 0 || y1 < 0 || x >= TILE_COLS * TILE_SIZE || y >= TILE_ROWS * TILE_SIZE) return;
+
+    int col0 = max(x, (int32_t)0) / TILE_SIZE;
+    int col1 = min(x1, (int32_t)(TILE_COLS * TILE_SIZE - 1)) / TILE_SIZE;
+    int row0 = max(y, (int32_t)0) / TILE_SIZE;
+    int row1 = min(y1, (int32_t)(TILE_ROWS * TILE_SIZE - 1)) / TILE_SIZE;
+    tile_mask bits = tileSpan(col0, col1);
+    for (int row = row0; row <= row1; row++) {
+      drawnTiles[row] |= bits;
+    }
+  }
+
+  /**
+   * Forgets what the panel shows, so the next push sends every tile
+   */
+  void resetTiles() {
+    memset(drawnTiles, 0, sizeof(drawnTiles));
+    memset(lastDrawnTiles, 0, sizeof(lastDrawnTiles));
+    pushAllTiles = true;
+  }
+
+  /**
+   * Clears what was drawn last frame back to bg and starts a new dirty set.
+   * Tiles nobody drew into are still bg, so they are left alone.
+   */
+  void beginTiles(uint16_t bg) {
+    for (int row = 0; row < TILE_ROWS; row++) {
+      forEachRun(drawnTiles[row], [&](int col0, int col1) {
+        TFT_eSprite::fillRect(col0 * TILE_SIZE, row * TILE_SIZE,
+                              (col1 - col0 + 1) * TILE_SIZE, TILE_SIZE, bg);
+      });
+      lastDrawnTiles[row] = drawnTiles[row];
+      drawnTiles[row] = 0;
+    }
+  }
+
+  /**
+   * Pushes the tiles whose pixels differ from what the panel shows.
+   * Only tiles drawn this frame or last frame can have changed; of those,
+   * a tile is skipped when its hash matches the one last pushed.
+   * Returns the number of tiles sent.
+   */
+  int pushChangedTiles(TFT_eSPI& display) {
+    int pushed = 0;
+    for (int row = 0; row < TILE_ROWS; row++) {
+      tile_mask candidates = pushAllTiles ? tileSpan(0, TILE_COLS - 1)
+                                          : (drawnTiles[row] | lastDrawnTiles[row]);
+      tile_mask changed = 0;
+      for (int col = 0; col < TILE_COLS; col++) {
+        if (!(candidates & TILE_BIT(col))) continue;
+        uint32_t hash = tileHash(col, row);
+        if (hash != shownHash[row][col] || pushAllTiles) {
+          shownHash[row][col] = hash;
+          changed |= TILE_BIT(col);
+        }
+      }
+
+      forEachRun(changed, [&](int col0, int col1) {
+        pushRun(display, row, col0, col1);
+        pushed += col1 - col0 + 1;
+      });
+      pushedTiles[row] = changed;
+    }
+    pushAllTiles = false;
+    return pushed;
+  }
+
+  /**
+   * Columns of a tile row the last pushChangedTiles() sent, as a bit mask
+   */
+  tile_mask pushedTileMask(int row) const {
+    return pushedTiles[row];
+  }
+
+private:
+  tile_mask drawnTiles[TILE_ROWS] = {0};     // Tiles drawn into this frame
+  tile_mask lastDrawnTiles[TILE_ROWS] = {0}; // Tiles drawn last frame (cleared now, maybe still lit on the panel)
+  uint32_t shownHash[TILE_ROWS][TILE_COLS] = {{0}}; // Hash of each tile as last sent to the panel
+  tile_mask pushedTiles[TILE_ROWS] = {0};    // Tiles sent by the last push
+  bool pushAllTiles = true;
+
+  // A run of tiles is copied out so DMA can send it while the next run is gathered
+  uint16_t staging[2][TILE_COLS * TILE_SIZE * TILE_SIZE];
+  uint8_t stagingIndex = 0;
+
+  /**
+   * Calls fn(firstCol, lastCol) for each run of set bits in a tile row mask
+   */
+  template <typename Fn>
+  static void forEachRun(tile_mask bits, Fn fn) {
+    int col = 0;
+    while (col < TILE_COLS && (bits >> col)) {
+      if (!(bits & TILE_BIT(col))) { col++; continue; }
+      int start = col;
+      while (col < TILE_COLS && (bits & TILE_BIT(col))) col++;
+      fn(start, col - 1);
+    }
+  }
+
+  /**
+   * MurmurHash3 (x86_32) block mixing over the tile's pixels, two at a time.
+   * A plain multiply-xor hash is not enough here: a one-bit colour change in
+   * the high half of a word only ever moves upwards and two of them cancel.
+   */
+  uint32_t tileHash(int col, int row) {
+    const uint16_t* img = (const uint16_t*)getPointer();
+    int stride = width();
+    int x0 = col * TILE_SIZE;
+    int y0 = row * TILE_SIZE;
+    int w = min(TILE_SIZE, stride - x0);
+    int h = min(TILE_SIZE, (int)height() - y0);
+
+    uint32_t hash = 0;
+    for (int y = 0; y < h; y++) {
+      const uint16_t* line = img + (y0 + y) * stride + x0;
+      for (int x = 0; x < w; x += 2) {
+        uint32_t k = line[x] | ((x + 1 < w) ? (uint32_t)line[x + 1] << 16 : 0);
+        k *= 0xcc9e2d51u;
+        k = (k << 15) | (k >> 17);
+        k *= 0x1b873593u;
+        hash ^= k;
+        hash = (hash << 13) | (hash >> 19);
+        hash = hash * 5 + 0xe6546b64u;
+      }
+    }
+    return hash;
+  }
+
+  void pushRun(TFT_eSPI& display, int row, int col0, int col1) {
+    const uint16_t* img = (const uint16_t*)getPointer();
+    int stride = width();
+    int x0 = col0 * TILE_SIZE;
+    int y0 = row * TILE_SIZE;
+    int w = min((col1 - col0 + 1) * TILE_SIZE, stride - x0);
+    int h = min(TILE_SIZE, (int)height() - y0);
+
+    // The transfer that last used this buffer was waited for when the other one started
+    uint16_t* out = staging[stagingIndex];
+    stagingIndex ^= 1;
+    for (int y = 0; y < h; y++) {
+      memcpy(out + y * w, img + (y0 + y) * stride + x0, w * sizeof(uint16_t));
+    }
+    // Sprite pixels are already in panel byte order
+    display.pushImageDMA(x0, y0, w, h, out);
+    profCountPanel(w * h);
+  }
+};
+
+extern TileCanvas backBuffer;
+
+namespace {
+  bool backBufferReady = false;
+}
+#elif RENDER_MODE == RENDER_BANDED
+#define BAND_HEIGHT 16            // Rows composed and pushed at a time
+// The list and the span pool are sized for the busiest frames at the largest
+// object scale: on 240x320 the pulsar records about 2300 calls, and the planet
+// at 2.4 * PANEL_SCALE covers a quarter of the short side squared in spans
+#define BAND_MAX_COMMANDS 4096    // Draw calls recorded per frame, 12 bytes each
+#define BAND_MAX_SPAN_PIXELS (PANEL_MIN_SIDE * PANEL_MIN_SIDE * 3 / 10) // pushSpan() pixels recorded per frame
+
+// Implemented in glow.h and hud.h, and below after the band buffer
+void glowCopy(uint8_t slot, uint16_t* frame, int width, int height, int x, int y);
+void hudCopy(uint8_t slot, uint16_t* frame, int width, int height, int x, int y);
+void presentBands();
+
+/**
+ * Draw target in band mode. A frame is recorded as a list of primitives
+ * instead of being drawn, then presentFrame() composes it one band of rows
+ * at a time: every call that reaches into the band is replayed into a
+ * strip sprite, moved up by the band's top row, and the strip is pushed with
+ * DMA while the next band is composed. So a frame needs two strips and the
+ * list, not a whole frame buffer. Triangles and text are recorded as the
+ * lines and pixels TFT_eSPI builds them from. drawCircle() and fillCircle()
+ * are not virtual, so circles only make one command each through
+ * canvasDrawCircle() and canvasFillCircle(). Anything that writes pixels
+ * some other way must use recordSpan(), recordGlow() or recordHud().
+ * If a frame outgrows the list, what is recorded is pushed at once and the
+ * rest of the frame goes straight to the panel, so it may flicker but is
+ * complete.
+ */
+class BandRecorder : public TFT_eSPI {
+public:
+  explicit BandRecorder(TFT_eSPI* display) : TFT_eSPI(), panel(display) {}
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) override {
+    if (x < 0 || y < 0 || x >= panel->width() || y >= panel->height()) return;
+    if (reserve()) {
+      record(BAND_PIXEL, x, y, 0, 0, color);
+    } else {
+      panel->drawPixel(x, y, color);
+    }
+  }
+
+  void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) override {
+    if (reserve()) {
+      record(BAND_CHAR, x, y, c, bg, color, size);
+    } else {
+      panel->drawChar(x, y, c, color, bg, size);
+    }
+  }
+
+  void drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye, uint32_t color) override {
+    if (reserve()) {
+      record(BAND_LINE, xs, ys, xe, ye, color);
+    } else {
+      panel->drawLine(xs, ys, xe, ye, color);
+    }
+  }
+
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) override {
+    fillRect(x, y, w, 1, color);
+  }
+
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) override {
+    fillRect(x, y, 1, h, color);
+  }
+
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override {
+    if (w <= 0 || h <= 0 || x + w <= 0 || y + h <= 0 || x >= panel->width() || y >= panel->height()) return;
+    if (reserve()) {
+      record(BAND_RECT, x, y, w, h, color);
+    } else {
+      panel->fillRect(x, y, w, h, color);
+    }
+  }
+
+  int16_t width(void) override { return panel->width(); }
+  int16_t height(void) override { return panel->height(); }
+
+  /**
+   * Records a circle outline, or a filled circle, as one command
+   */
+  void recordCircle(int32_t x, int32_t y, int32_t r, uint32_t color, bool filled) {
+    if (r < 0 || x + r < 0 || y + r < 0 || x - r >= panel->width() || y - r >= panel->height()) return;
+    if (reserve()) {
+      record(filled ? BAND_FILL_CIRCLE : BAND_CIRCLE, x, y, r, 0, color);
+    } else if (filled) {
+      panel->fillCircle(x, y, r, color);
+    } else {
+      panel->drawCircle(x, y, r, color);
+    }
+  }
+
+  /**
+   * Records a pushSpan(); colors are plain RGB565
+   */
+  void recordSpan(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* colors) {
+    int pixels = w * h;
+    if (!reserve(pixels)) {
+      panel->setAddrWindow(x, y, w, h);
+      panel->pushColors((uint16_t*)colors, pixels);
+      profCountPanel(pixels);
+      return;
+    }
+    memcpy(spanPool + spanPixels, colors, pixels * sizeof(uint16_t));
+    record(BAND_SPAN, x, y, w, h, spanPixels);
+    spanPixels += pixels;
+  }
+
+  /**
+   * Records a glowBlit(); the atlas holds the bitmap until the frame is pushed.
+   * pixels is the bitmap, in panel byte order with 0 transparent.
+   */
+  void recordGlow(uint8_t slot, int32_t x, int32_t y, int32_t half, uint16_t* pixels) {
+    if (reserve()) {
+      record(BAND_GLOW, x, y, half, 0, slot);
+    } else {
+      int side = 2 * half + 1;
+      panel->pushImage(x - half, y - half, side, side, pixels, (uint16_t)0);
+    }
+  }
+
+  /**
+   * Records a hudDraw() of an element w x h at (x, y); the atlas holds it
+   * until the frame is pushed. pixels is its first row, stride pixels apart,
+   * in panel byte order with 0 transparent.
+   */
+  void recordHud(uint8_t slot, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* pixels, int32_t stride) {
+    if (reserve()) {
+      record(BAND_HUD, x, y, w, h, slot);
+    } else {
+      for (int row = 0; row < h; row++) {
+        panel->pushImage(x, y + row, w, 1, pixels + row * stride, (uint16_t)0);
+      }
+    }
+  }
+
+  /**
+   * Forgets the last frame's list
+   */
+  void reset() {
+    count = 0;
+    spanPixels = 0;
+    spilled = false;
+  }
+
+  /**
+   * Draws every recorded call that reaches rows top..top + rows - 1 into the band.
+   * band is in panel byte order, like any sprite.
+   */
+  void replayBand(TFT_eSprite& band, int top, int rows) {
+    int bottom = top + rows;
+    for (uint16_t i = 0; i < count; i++) {
+      const BandCommand& cmd = cmds[i];
+      int y = cmd.y - top;
+      switch (cmd.op) {
+        case BAND_PIXEL:
+          if (cmd.y >= top && cmd.y < bottom) band.drawPixel(cmd.x, y, cmd.color);
+          break;
+        case BAND_RECT:
+          if (cmd.y < bottom && cmd.y + cmd.b > top) band.fillRect(cmd.x, y, cmd.a, cmd.b, cmd.color);
+          break;
+        case BAND_LINE:
+          if (min(cmd.y, cmd.b) < bottom && max(cmd.y, cmd.b) >= top) {
+            band.drawLine(cmd.x, y, cmd.a, cmd.b - top, cmd.color);
+          }
+          break;
+        case BAND_CIRCLE:
+          if (cmd.y - cmd.a < bottom && cmd.y + cmd.a >= top) band.drawCircle(cmd.x, y, cmd.a, cmd.color);
+          break;
+        case BAND_FILL_CIRCLE:
+          if (cmd.y - cmd.a < bottom && cmd.y + cmd.a >= top) band.fillCircle(cmd.x, y, cmd.a, cmd.color);
+          break;
+        case BAND_CHAR:
+          if (cmd.y < bottom && cmd.y + 8 * cmd.size > top) {
+            band.drawChar(cmd.x, y, cmd.a, cmd.color, (uint16_t)cmd.b, cmd.size);
+          }
+          break;
+        case BAND_SPAN:
+          if (cmd.y < bottom && cmd.y + cmd.b > top) {
+            band.setSwapBytes(true);
+            band.pushImage(cmd.x, y, cmd.a, cmd.b, spanPool + cmd.color);
+            band.setSwapBytes(false);
+          }
+          break;
+        case BAND_GLOW:
+          if (cmd.y - cmd.a < bottom && cmd.y + cmd.a >= top) {
+            glowCopy(cmd.color, (uint16_t*)band.getPointer(), band.width(), rows, cmd.x, y);
+          }
+          break;
+        case BAND_HUD:
+          if (cmd.y < bottom && cmd.y + cmd.b > top) {
+            hudCopy(cmd.color, (uint16_t*)band.getPointer(), band.width(), rows, cmd.x, y);
+          }
+          break;
+      }
+    }
+  }
+
+  uint16_t commands() const { return count; }
+
+  /**
+   * True once this frame outgrew the list and is being drawn on the panel
+   */
+  bool spilledFrame() const { return spilled; }
+
+private:
+  enum BandOp : uint8_t {
+    BAND_PIXEL,
+    BAND_RECT,  // Also the lines and spans circles and triangles are made of
+    BAND_LINE,  // a, b hold the end point
+    BAND_CIRCLE,      // a holds the radius
+    BAND_FILL_CIRCLE, // a holds the radius
+    BAND_CHAR,  // a holds the character, b the background
+    BAND_SPAN,  // color holds the offset into spanPool
+    BAND_GLOW,  // color holds the GlowSlot, a the half size
+    BAND_HUD    // color holds the HudSlot, a and b its size
+  };
+
+  struct BandCommand {
+    uint8_t op;
+    uint8_t size; // Text size of BAND_CHAR
+    uint16_t color;
+    int16_t x, y;
+    int16_t a, b;
+  };
+
+  TFT_eSPI* panel;
+  BandCommand cmds[BAND_MAX_COMMANDS];
+  uint16_t spanPool[BAND_MAX_SPAN_PIXELS];
+  uint16_t count = 0;
+  uint16_t spanPixels = 0;
+  bool spilled = false;
+
+  /**
+   * True if one more call, with that many span pixels, fits the list. When
+   * it does not, the frame so far is pushed and the panel is ready for the rest.
+   */
+  bool reserve(int pixels = 0) {
+    if (spilled) return false;
+    if (count < BAND_MAX_COMMANDS && spanPixels + pixels <= BAND_MAX_SPAN_PIXELS) return true;
+    presentBands();
+    panel->dmaWait(); // The last strip must be out before drawing over it
+    spilled = true;
+    return false;
+  }
+
+  void record(uint8_t op, int32_t x, int32_t y, int32_t a, int32_t b, uint32_t color, uint8_t size = 0) {
+    BandCommand& cmd = cmds[count++];
+    cmd.op = op;
+    cmd.size = size;
+    cmd.color = color;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.a = a;
+    cmd.b = b;
+  }
+};
+
+extern BandRecorder frameRecorder;
+extern TFT_eSprite bandBuffer;
+
+namespace {
+  int8_t bandBufferFrames = 0; // 2 = double buffered, 1 = single buffer, 0 = not allocated
+  int8_t bandBufferFrame = 1;  // Strip currently being composed (1 or 2)
+}
+
+/**
+ * Composes the recorded frame band by band and pushes the strips
+ */
+void presentBands() {
+  if (bandBufferFrames == 0) return;
+
+  tft.startWrite();
+  for (int top = 0; top < SCREEN_HEIGHT; top += BAND_HEIGHT) {
+    int rows = min(BAND_HEIGHT, SCREEN_HEIGHT - top);
+    bandBuffer.fillSprite(BG_COLOR);
+    frameRecorder.replayBand(bandBuffer, top, rows);
+    // Waits for the previous strip, which was the other buffer
+    tft.pushImageDMA(0, top, SCREEN_WIDTH, rows, (uint16_t*)bandBuffer.getPointer());
+    profCountPanel(SCREEN_WIDTH * rows);
+
+    if (bandBufferFrames == 2) {
+      bandBufferFrame = (bandBufferFrame == 1) ? 2 : 1;
+      bandBuffer.frameBuffer(bandBufferFrame);
+    } else {
+      tft.dmaWait();
+    }
+  }
+}
+#elif PIXEL_BATCH
+/**
+ * Draw target in direct mode that write-combines single pixels.
+ * drawPixel() only queues the pixel; everything else is passed on to the
+ * panel after the queue is flushed, so writes land in the order they were
+ * made. A flush sorts the queue by row, keeps only the last write to each
+ * pixel (stars and trails are often erased and drawn again on the spot) and
+ * sends runs of neighbouring pixels through one address window, all in a
+ * single transaction. Anything that writes to tft itself during a frame
+ * (e.g. pushImage) must call flush() first.
+ */
+class PixelBatch : public TFT_eSPI {
+public:
+  explicit PixelBatch(TFT_eSPI* display) : TFT_eSPI(), panel(display) {}
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) override {
+    if (x < 0 || y < 0 || x >= panel->width() || y >= panel->height()) return;
+    if (count == PIXEL_BATCH_SIZE) flush();
+    pending[count++] = {(screen_coord)x, (screen_coord)y, (uint16_t)color};
+  }
+
+  void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) override {
+    flush();
+    panel->drawChar(x, y, c, color, bg, size);
+  }
+
+  void drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye, uint32_t color) override {
+    flush();
+    panel->drawLine(xs, ys, xe, ye, color);
+  }
+
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) override {
+    flush();
+    panel->drawFastHLine(x, y, w, color);
+  }
+
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) override {
+    flush();
+    panel->drawFastVLine(x, y, h, color);
+  }
+
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override {
+    flush();
+    panel->fillRect(x, y, w, h, color);
+  }
+
+  int16_t width(void) override { return panel->width(); }
+  int16_t height(void) override { return panel->height(); }
+
+  /**
+   * Sends the queued pixels to the panel
+   */
+  void flush() {
+    if (count == 0) return;
+    sortPending();
+
+    panel->startWrite();
+    uint16_t run[PANEL_WIDTH];
+    int i = 0;
+    while (i < count) {
+      // Collect a run of neighbouring pixels on one row; of repeated writes the last one wins
+      int x0 = pending[i].x;
+      int y = pending[i].y;
+      int length = 0;
+      while (i < count && pending[i].y == y && pending[i].x <= x0 + length) {
+        if (pending[i].x < x0 + length) {
+          run[length - 1] = pending[i].color;
+        } else {
+          run[length++] = pending[i].color;
+        }
+        i++;
+      }
+
+      if (length == 1) {
+        // The driver skips the row address when it has not changed
+        panel->drawPixel(x0, y, run[0]);
+      } else {
+        panel->setAddrWindow(x0, y, length, 1);
+        panel->pushColors(run, length);
+      }
+      profCountPanel(length);
+    }
+    panel->endWrite();
+    count = 0;
+  }
+
+private:
+  struct Pixel {
+    screen_coord x, y;
+    uint16_t color;
+  };
+
+  TFT_eSPI* panel;
+  Pixel pending[PIXEL_BATCH_SIZE];
+  Pixel scratch[PIXEL_BATCH_SIZE];
+  uint16_t count = 0;
+
+  /**
+   * Two stable counting sort passes, by x and then by y, so writes to the
+   * same pixel stay in the order they were made
+   */
+  void sortPending() {
+    uint16_t starts[PANEL_WIDTH > PANEL_HEIGHT ? PANEL_WIDTH : PANEL_HEIGHT];
+    radixPass(pending, scratch, starts, [](const Pixel& p) { return p.x; });
+    radixPass(scratch, pending, starts, [](const Pixel& p) { return p.y; });
+  }
+
+  template <typename Key>
+  void radixPass(const Pixel* in, Pixel* out, uint16_t* starts, Key key) {
+    const int keys = max(PANEL_WIDTH, PANEL_HEIGHT);
+    memset(starts, 0, keys * sizeof(uint16_t));
+    for (int i = 0; i < count; i++) starts[key(in[i])]++;
+    uint16_t total = 0;
+    for (int k = 0; k < keys; k++) {
+      uint16_t n = starts[k];
+      starts[k] = total;
+      total += n;
+    }
+    for (int i = 0; i < count; i++) out[starts[key(in[i])]++] = in[i];
+  }
+};
+
+extern PixelBatch pixelBatch;
+#endif
+
+/**
+ * Sets up the draw target after tft.init()
+ */
+void initRenderTarget() {
+#if RENDER_MODE == RENDER_SPRITE
+  // DMA cannot read from PSRAM, so keep the frame(s) in internal RAM
+  backBuffer.setAttribute(PSRAM_ENABLE, false);
+  backBuffer.setColorDepth(16);
+
+  // Two frames let the CPU draw the next frame while DMA pushes the last one
+  if (backBuffer.createSprite(SCREEN_WIDTH, SCREEN_HEIGHT, 2)) {
+    backBufferFrames = 2;
+  } else if (backBuffer.createSprite(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+    backBufferFrames = 1;
+    Serial.println("Back buffer: not enough RAM for two frames, using one");
+  } else {
+    backBufferFrames = 0;
+    Serial.println("Back buffer: allocation failed, nothing will be drawn");
+    return;
+  }
+
+  backBufferFrame = 1;
+  backBuffer.frameBuffer(backBufferFrame);
+  backBuffer.fillSprite(BG_COLOR);
+  tft.initDMA();
+#elif RENDER_MODE == RENDER_TILED
+  backBuffer.setAttribute(PSRAM_ENABLE, false);
+  backBuffer.setColorDepth(16);
+  backBufferReady = backBuffer.createSprite(SCREEN_WIDTH, SCREEN_HEIGHT) != nullptr;
+  if (!backBufferReady) {
+    Serial.println("Back buffer: allocation failed, nothing will be drawn");
+    return;
+  }
+
+  backBuffer.fillSprite(BG_COLOR);
+  backBuffer.resetTiles(); // Whatever is on the panel now gets overwritten by the first frame
+  tft.initDMA();
+#elif RENDER_MODE == RENDER_BANDED
+  bandBuffer.setAttribute(PSRAM_ENABLE, false);
+  bandBuffer.setColorDepth(16);
+
+  // Two strips let the CPU compose the next band while DMA pushes the last one
+  int rows = min(BAND_HEIGHT, SCREEN_HEIGHT);
+  if (bandBuffer.createSprite(SCREEN_WIDTH, rows, 2)) {
+    bandBufferFrames = 2;
+  } else if (bandBuffer.createSprite(SCREEN_WIDTH, rows)) {
+    bandBufferFrames = 1;
+    Serial.println("Band buffer: not enough RAM for two strips, using one");
+  } else {
+    bandBufferFrames = 0;
+    Serial.println("Band buffer: allocation failed, nothing will be drawn");
+    return;
+  }
+  bandBufferFrame = 1;
+  bandBuffer.frameBuffer(bandBufferFrame);
+  tft.initDMA();
+#endif
+}
+
+/**
+ * Prepares the draw target for a new frame
+ */
+void beginFrame() {
+#if RENDER_MODE == RENDER_SPRITE
+  backBuffer.fillSprite(BG_COLOR);
+#elif RENDER_MODE == RENDER_TILED
+  backBuffer.beginTiles(BG_COLOR);
+#elif RENDER_MODE == RENDER_BANDED
+  frameRecorder.reset();
+#endif
+}
+
+/**
+ * Starts a crossfade from the frame on the panel to the frames that follow.
+ * Only sprite mode keeps whole frames around; elsewhere this does nothing.
+ */
+void beginCrossfade() {
+#if RENDER_MODE == RENDER_SPRITE
+  if (backBufferFrames == 0) return;
+  size_t bytes = SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t);
+  if (!crossfadeFrame) crossfadeFrame = (uint16_t*)malloc(bytes);
+  if (!crossfadeFrame) return;
+
+  // Double buffered, the frame last pushed is in the buffer not being drawn into
+  if (backBufferFrames == 2) backBuffer.frameBuffer(backBufferFrame == 1 ? 2 : 1);
+  memcpy(crossfadeFrame, backBuffer.getPointer(), bytes);
+  backBuffer.frameBuffer(backBufferFrame);
+  crossfadeLeft = CROSSFADE_FRAMES;
+#endif
+}
+
+/**
+ * Sends the finished frame to the panel
+ */
+void presentFrame() {
+#if RENDER_MODE == RENDER_SPRITE
+  if (backBufferFrames == 0) return;
+
+  if (crossfadeLeft > 0) {
+    crossfadeLeft--;
+    uint8_t alpha = BLEND_ALPHA_MAX * (crossfadeLeft + 1) / (CROSSFADE_FRAMES + 1);
+    blendFrame((uint16_t*)backBuffer.getPointer(), crossfadeFrame, SCREEN_WIDTH * SCREEN_HEIGHT, alpha);
+    if (crossfadeLeft == 0) {
+      free(crossfadeFrame);
+      crossfadeFrame = nullptr;
+    }
+  }
+
+  // The transaction stays open between frames; startWrite() is a no-op once it is
+  tft.startWrite();
+  // pushImageDMA() waits for the previous transfer before starting this one.
+  // Sprite pixels are already stored in panel byte order, so no swapping is needed.
+  tft.pushImageDMA(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (uint16_t*)backBuffer.getPointer());
+  profCountPanel(SCREEN_WIDTH * SCREEN_HEIGHT);
+
+  if (backBufferFrames == 2) {
+    // Draw the next frame into the other buffer while this one is in flight
+    backBufferFrame = (backBufferFrame == 1) ? 2 : 1;
+    backBuffer.frameBuffer(backBufferFrame);
+  } else {
+    tft.dmaWait(); // Single buffer: it must not change until the transfer is done
+  }
+#elif RENDER_MODE == RENDER_TILED
+  if (!backBufferReady) return;
+
+  tft.startWrite();
+  backBuffer.pushChangedTiles(tft);
+#elif RENDER_MODE == RENDER_BANDED
+  // A frame that outgrew the list is already on the panel
+  if (!frameRecorder.spilledFrame()) presentBands();
+#elif PIXEL_BATCH
+  pixelBatch.flush();
+#endif
+}
+
+/**
+ * Finishes any frame in flight so tft can be drawn to directly (e.g. power-off screen)
+ */
+void releaseDisplay() {
+#if RENDER_MODE == RENDER_SPRITE
+  if (backBufferFrames == 0) return;
+  tft.dmaWait();
+  tft.endWrite();
+#elif RENDER_MODE == RENDER_TILED
+  if (!backBufferReady) return;
+  tft.dmaWait();
+  tft.endWrite();
+#elif RENDER_MODE == RENDER_BANDED
+  if (bandBufferFrames == 0) return;
+  tft.dmaWait();
+  tft.endWrite();
+#elif PIXEL_BATCH
+  pixelBatch.flush();
+#endif
+}
+
+/**
+ * Writes a one pixel wide row (h = 1) or column (w = 1) of individually
+ * coloured pixels through a single address window. colors are plain RGB565,
+ * left to right or top to bottom; the span must lie on screen.
+ */
+void pushSpan(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* colors) {
+#if RENDER_MODE == RENDER_DIRECT
+#if PIXEL_BATCH
+  pixelBatch.flush();
+#endif
+  tft.setAddrWindow(x, y, w, h);
+  tft.pushColors(colors, w * h); // Swaps into panel byte order on the way out
+  profCountPanel(w * h); // Direct mode only counts spans; TFT_eSPI's own primitives bypass the counter
+#elif RENDER_MODE == RENDER_BANDED
+  frameRecorder.recordSpan(x, y, w, h, colors);
+#else
+  // The sprite stores panel byte order, so have pushImage() swap the plain colours
+  backBuffer.setSwapBytes(true);
+  backBuffer.pushImage(x, y, w, h, colors);
+  backBuffer.setSwapBytes(false);
+#if RENDER_MODE == RENDER_TILED
+  backBuffer.markTiles(x, y, w, h);
+#endif
+#endif
+}
+
+/**
+ * canvas.drawCircle() and canvas.fillCircle(), which band mode records as one
+ * command each instead of the pixels and lines TFT_eSPI draws them with
+ */
+void canvasDrawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+#if RENDER_MODE == RENDER_BANDED
+  frameRecorder.recordCircle(x, y, r, color, false);
+#else
+  canvas.drawCircle(x, y, r, color);
+#endif
+}
+
+void canvasFillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+#if RENDER_MODE == RENDER_BANDED
+  frameRecorder.recordCircle(x, y, r, color, true);
+#else
+  canvas.fillCircle(x, y, r, color);
+#endif
+}
+
+/**
+ * Groups many small draw calls into one SPI transaction.
+ * In the back buffer modes drawing is plain memory writes, and touching the SPI bus
+ * here would disturb the DMA transfer that may be running.
+ */
+void beginBatch() {
+#if RENDER_MODE == RENDER_DIRECT
+  tft.startWrite();
+#endif
+}
+
+void endBatch() {
+#if RENDER_MODE == RENDER_DIRECT
+  tft.endWrite();
+#endif
+}
+
+#endif // RENDER_H
@@ -0,0 +1,94 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <Arduino.h>
+
+// Software random number streams. On the ESP32, Arduino's random() goes
+// through esp_random() and the hardware RNG, which is far slower than a few
+// shifts, and it is one stream for the whole sketch. Here every subsystem
+// has its own xorshift32 stream, seeded from the session seed, so what one
+// of them draws never shifts the numbers another sees:
+// - starRng: the starfield, shooting stars and the intro,
+// - warpRng: warp streaks, stepped on the sim core,
+// - discoveryRng: what is found after a warp and where,
+// - objectRng: the object on screen, reseeded from discoveryRng each discovery.
+// No stream is used by both cores at the same time, so a session replays the
+// same however the cores interleave.
+
+/**
+ * One xorshift32 stream. The state must never be 0; seed() takes care of it.
+ */
+struct Rng {
+  uint32_t state;
+
+  /**
+   * Restarts the stream; any seed, 0 included, gives a usable state
+   */
+  void seed(uint32_t value) {
+    // splitmix32 spreads nearby seeds over the whole state space
+    value += 0x9E3779B9;
+    value = (value ^ (value >> 16)) * 0x85EBCA6B;
+    value = (value ^ (value >> 13)) * 0xC2B2AE35;
+    value ^= value >> 16;
+    state = value ? value : 0x6D2B79F5;
+  }
+
+  uint32_t next() {
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return state = x;
+  }
+
+  /**
+   * 0 to howbig - 1, like random(howbig); 0 if howbig is not positive
+   */
+  int32_t below(int32_t howbig) {
+    if (howbig <= 0) return 0;
+    return (int32_t)(((uint64_t)next() * (uint32_t)howbig) >> 32);
+  }
+
+  /**
+   * howsmall to howbig - 1, like random(howsmall, howbig); howsmall if the range is empty
+   */
+  int32_t range(int32_t howsmall, int32_t howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + below(howbig - howsmall);
+  }
+
+  /**
+   * Fills count values with range(howsmall, howbig), for init loops
+   */
+  template <typename T>
+  void fill(T* out, size_t count, int32_t howsmall, int32_t howbig) {
+    for (size_t i = 0; i < count; i++) out[i] = (T)range(howsmall, howbig);
+  }
+
+  /**
+   * Same for one field of an array of structs, e.g. fill(stars, n, &Star::x, 0, width)
+   */
+  template <typename S, typename T>
+  void fill(S* items, size_t count, T S::*field, int32_t howsmall, int32_t howbig) {
+    for (size_t i = 0; i < count; i++) items[i].*field = (T)range(howsmall, howbig);
+  }
+};
+
+namespace {
+  Rng starRng;
+  Rng warpRng;
+  Rng discoveryRng;
+  Rng objectRng;
+}
+
+/**
+ * Seeds every stream from one session seed
+ */
+void rngBegin(uint32_t seed) {
+  starRng.seed(seed);
+  warpRng.seed(seed ^ 0x57415250);      // "WARP"
+  discoveryRng.seed(seed ^ 0x44495343); // "DISC"
+  objectRng.seed(seed ^ 0x4F424A45);    // "OBJE"
+}
+
+#endif // RNG_H
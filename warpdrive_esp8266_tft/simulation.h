@@ -0,0 +1,467 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <atomic>
+#include "render.h"
+#include "streak.h"
+#include "lod.h"
+#include "frameclock.h"
+#include "glow.h"
+#include "lens.h"
+
+// Dual-core pipeline: the particle-heavy animations step on one core and record
+// what they draw, the other core replays it into the canvas and drives SPI.
+// Set -DSIM_PIPELINE=0 to run everything on the loop() core.
+#ifndef SIM_PIPELINE
+#if defined(ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+#define SIM_PIPELINE 1
+#else
+#define SIM_PIPELINE 0
+#endif
+#endif
+
+#define SIM_TASK_CORE 0         // loop() and the SPI driver stay on core 1
+#define SIM_TASK_STACK 4096
+#define SIM_TASK_PRIORITY 1
+#define SIM_FRAME_BUFFERS 2     // One being recorded while the other is replayed
+
+// Commands per frame. The black hole is the busiest animation at ~550; direct mode
+// also records the erase of every particle, so it needs about twice that.
+#if RENDER_FULL_REDRAW
+#define SIM_MAX_COMMANDS 1024
+#else
+#define SIM_MAX_COMMANDS 2048
+#endif
+
+// Forward declarations of external variables
+extern TFT_eSPI& canvas;
+extern float warpFactor;
+
+/**
+ * Per-frame values the simulation reads from the input side.
+ * They travel with each command buffer, so the sim core never reads a global
+ * that loop() is busy changing.
+ */
+struct SimInputs {
+  float warpFactor;
+  uint8_t detail; // Level-of-detail for the frame, see lod.h
+  FrameTime clock; // Frame clock for the frame, see frameclock.h
+};
+
+/**
+ * Takes a snapshot of the inputs for the next simulated frame
+ */
+SimInputs currentSimInputs() {
+  SimInputs inputs;
+  inputs.warpFactor = warpFactor;
+  inputs.detail = lodDetail;
+  inputs.clock = frameClock;
+  return inputs;
+}
+
+namespace {
+  SimInputs simInputs = {0.0f, LOD_MAX, {0, 0, 0, 0}}; // Inputs of the frame being simulated
+}
+
+typedef void (*SimJob)();
+
+/**
+ * Lock-free single-producer single-consumer ring of pointers.
+ * Holds up to N - 1 items; head is only written by the consumer, tail by the producer.
+ */
+template <typename T, uint8_t N>
+class SpscQueue {
+public:
+  bool push(T item) {
+    uint8_t tail = tailIndex.load(std::memory_order_relaxed);
+    uint8_t next = (tail + 1) % N;
+    if (next == headIndex.load(std::memory_order_acquire)) return false; // Full
+    items[tail] = item;
+    tailIndex.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& item) {
+    uint8_t head = headIndex.load(std::memory_order_relaxed);
+    if (head == tailIndex.load(std::memory_order_acquire)) return false; // Empty
+    item = items[head];
+    headIndex.store((head + 1) % N, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Empties the queue. Only safe while neither side is using it.
+   */
+  void clear() {
+    headIndex.store(0, std::memory_order_relaxed);
+    tailIndex.store(0, std::memory_order_release);
+  }
+
+private:
+  T items[N];
+  std::atomic<uint8_t> headIndex{0};
+  std::atomic<uint8_t> tailIndex{0};
+};
+
+#if SIM_PIPELINE
+enum DrawOp : uint8_t {
+  DRAW_PIXEL,
+  DRAW_HLINE,
+  DRAW_VLINE,
+  DRAW_RECT,
+  DRAW_LINE,
+  DRAW_CIRCLE,
+  FILL_CIRCLE,
+  DRAW_STREAK,  // color holds the brightness
+  ERASE_STREAK,
+  DRAW_GLOW,    // color holds the GlowSlot
+  APPLY_LENS
+};
+
+struct DrawCommand {
+  uint8_t op;
+  uint16_t color;
+  int16_t x, y;
+  int16_t a, b; // w/h, line or streak end point, or radius in a
+};
+
+/**
+ * One simulated frame: the inputs it was stepped with and what it drew
+ */
+struct CommandBuffer {
+  SimInputs inputs;
+  uint16_t count;
+  uint16_t dropped; // Commands that did not fit (shows up as missing pixels)
+  DrawCommand cmds[SIM_MAX_COMMANDS];
+};
+
+/**
+ * Stand-in for canvas used by the simulated animations.
+ * While the sim task records a frame it appends draw commands to that frame's
+ * buffer; with no buffer attached the calls go straight to canvas.
+ * It only offers the primitives those animations use.
+ */
+class CommandRecorder {
+public:
+  CommandBuffer* buffer = nullptr;
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) {
+    if (!buffer) { canvas.drawPixel(x, y, color); return; }
+    if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return;
+    record(DRAW_PIXEL, x, y, 0, 0, color);
+  }
+
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    if (!buffer) { canvas.drawFastHLine(x, y, w, color); return; }
+    record(DRAW_HLINE, x, y, w, 0, color);
+  }
+
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    if (!buffer) { canvas.drawFastVLine(x, y, h, color); return; }
+    record(DRAW_VLINE, x, y, h, 0, color);
+  }
+
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (!buffer) { canvas.fillRect(x, y, w, h, color); return; }
+    record(DRAW_RECT, x, y, w, h, color);
+  }
+
+  void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    if (!buffer) { canvas.drawLine(x0, y0, x1, y1, color); return; }
+    record(DRAW_LINE, x0, y0, x1, y1, color);
+  }
+
+  void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+    if (!buffer) { canvasDrawCircle(x, y, r, color); return; }
+    if (offscreen(x, y, r)) return;
+    record(DRAW_CIRCLE, x, y, r, 0, color);
+  }
+
+  void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+    if (!buffer) { canvasFillCircle(x, y, r, color); return; }
+    if (offscreen(x, y, r)) return;
+    record(FILL_CIRCLE, x, y, r, 0, color);
+  }
+
+  void drawStreak(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t brightness) {
+    if (!buffer) { ::drawStreak(x0, y0, x1, y1, brightness); return; }
+    record(DRAW_STREAK, x0, y0, x1, y1, brightness);
+  }
+
+  void eraseStreak(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    if (!buffer) { ::eraseStreak(x0, y0, x1, y1, color); return; }
+    record(ERASE_STREAK, x0, y0, x1, y1, color);
+  }
+
+  void drawGlow(uint8_t slot, int32_t x, int32_t y) {
+    if (!buffer) { glowBlit(slot, x, y); return; }
+    if (offscreen(x, y, glowAtlas[slot].half)) return;
+    record(DRAW_GLOW, x, y, 0, 0, slot);
+  }
+
+  void applyLens(int32_t x, int32_t y) {
+    if (!buffer) { lensApply(x, y); return; }
+    record(APPLY_LENS, x, y, 0, 0, 0);
+  }
+
+private:
+  static bool offscreen(int32_t x, int32_t y, int32_t r) {
+    return x + r < 0 || y + r < 0 || x - r >= SCREEN_WIDTH || y - r >= SCREEN_HEIGHT;
+  }
+
+  void record(uint8_t op, int32_t x, int32_t y, int32_t a, int32_t b, uint32_t color) {
+    if (buffer->count >= SIM_MAX_COMMANDS) {
+      buffer->dropped++;
+      return;
+    }
+    DrawCommand& cmd = buffer->cmds[buffer->count++];
+    cmd.op = op;
+    cmd.color = color;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.a = a;
+    cmd.b = b;
+  }
+};
+
+typedef CommandRecorder SimCanvas;
+
+extern CommandRecorder simRecorder;
+
+namespace {
+  CommandBuffer* simBuffers[SIM_FRAME_BUFFERS] = {nullptr};
+  SpscQueue<CommandBuffer*, SIM_FRAME_BUFFERS + 1> simFreeBuffers;   // loop() -> sim task
+  SpscQueue<CommandBuffer*, SIM_FRAME_BUFFERS + 1> simFilledBuffers; // sim task -> loop()
+  std::atomic<SimJob> simJob{nullptr};
+  std::atomic<bool> simBusy{false};
+  TaskHandle_t simTask = nullptr;
+  TaskHandle_t renderTask = nullptr;
+  bool simReady = false; // False if the task or its buffers could not be created
+}
+
+/**
+ * Sim task body: steps the current job once per free buffer, then sleeps until
+ * loop() hands a buffer back or changes the job
+ */
+void simTaskMain(void*) {
+  for (;;) {
+    simBusy = true;
+    SimJob job = simJob.load();
+    CommandBuffer* frame;
+    if (job && simFreeBuffers.pop(frame)) {
+      simInputs = frame->inputs;
+      frame->count = 0;
+      frame->dropped = 0;
+      simRecorder.buffer = frame;
+      job();
+      simRecorder.buffer = nullptr;
+      simFilledBuffers.push(frame);
+      simBusy = false;
+      xTaskNotifyGive(renderTask);
+    } else {
+      simBusy = false;
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+  }
+}
+
+/**
+ * Draws a recorded frame into canvas
+ */
+void replayCommands(const CommandBuffer* frame) {
+  beginBatch();
+  for (uint16_t i = 0; i < frame->count; i++) {
+    const DrawCommand& cmd = frame->cmds[i];
+    switch (cmd.op) {
+      case DRAW_PIXEL:  canvas.drawPixel(cmd.x, cmd.y, cmd.color); break;
+      case DRAW_HLINE:  canvas.drawFastHLine(cmd.x, cmd.y, cmd.a, cmd.color); break;
+      case DRAW_VLINE:  canvas.drawFastVLine(cmd.x, cmd.y, cmd.a, cmd.color); break;
+      case DRAW_RECT:   canvas.fillRect(cmd.x, cmd.y, cmd.a, cmd.b, cmd.color); break;
+      case DRAW_LINE:   canvas.drawLine(cmd.x, cmd.y, cmd.a, cmd.b, cmd.color); break;
+      case DRAW_CIRCLE: canvasDrawCircle(cmd.x, cmd.y, cmd.a, cmd.color); break;
+      case FILL_CIRCLE: canvasFillCircle(cmd.x, cmd.y, cmd.a, cmd.color); break;
+      case DRAW_STREAK: drawStreak(cmd.x, cmd.y, cmd.a, cmd.b, cmd.color); break;
+      case ERASE_STREAK: eraseStreak(cmd.x, cmd.y, cmd.a, cmd.b, cmd.color); break;
+      case DRAW_GLOW:   glowBlit(cmd.color, cmd.x, cmd.y); break;
+      case APPLY_LENS:  lensApply(cmd.x, cmd.y); break;
+    }
+  }
+  endBatch();
+}
+
+/**
+ * Starts the sim task on the other core. Falls back to running the
+ * animations inline if the buffers or the task cannot be created.
+ */
+void simBegin() {
+  renderTask = xTaskGetCurrentTaskHandle();
+  for (int i = 0; i < SIM_FRAME_BUFFERS; i++) {
+    simBuffers[i] = (CommandBuffer*)malloc(sizeof(CommandBuffer));
+    if (!simBuffers[i]) {
+      Serial.println("Sim pipeline: not enough RAM for command buffers, running single core");
+      return;
+    }
+  }
+  if (xTaskCreatePinnedToCore(simTaskMain, "sim", SIM_TASK_STACK, nullptr,
+                              SIM_TASK_PRIORITY, &simTask, SIM_TASK_CORE) != pdPASS) {
+    Serial.println("Sim pipeline: could not start the sim task, running single core");
+    return;
+  }
+  simReady = true;
+}
+
+/**
+ * Parks the sim task and takes back every buffer.
+ * Call before touching any animation state from loop() (erase, reset, new object).
+ * In direct mode frames already simulated are drawn, so erasing matches the panel.
+ */
+void simStop() {
+  if (!simReady || !simJob.load()) return;
+
+  simJob = nullptr;
+  while (simBusy) {
+    ulTaskNotifyTake(pdTRUE, 1);
+  }
+
+  CommandBuffer* frame;
+  while (simFilledBuffers.pop(frame)) {
+#if !RENDER_FULL_REDRAW
+    replayCommands(frame);
+#endif
+  }
+  simFreeBuffers.clear();
+  simFilledBuffers.clear();
+}
+
+/**
+ * True if the sim task has nothing to do until loop() hands it a buffer
+ */
+bool simIdle() {
+  // simBusy is raised before the task takes a buffer, so a buffer it is about to take still counts
+  return !simReady || !simJob.load() || (!simBusy && simFreeBuffers.empty());
+}
+
+/**
+ * Runs one frame of an animation job. With the pipeline the job runs ahead on
+ * the sim core and this replays the oldest finished frame; without it the job
+ * just runs here.
+ */
+void simRun(SimJob job) {
+  if (!simReady) {
+    simInputs = currentSimInputs();
+    job();
+    return;
+  }
+
+  if (simJob.load() != job) {
+    simStop();
+    SimInputs inputs = currentSimInputs();
+    for (int i = 0; i < SIM_FRAME_BUFFERS; i++) {
+      simBuffers[i]->inputs = inputs;
+      simFreeBuffers.push(simBuffers[i]);
+    }
+    simJob = job;
+    xTaskNotifyGive(simTask);
+  }
+
+  CommandBuffer* frame;
+  while (!simFilledBuffers.pop(frame)) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+  replayCommands(frame);
+
+  frame->inputs = currentSimInputs();
+  simFreeBuffers.push(frame);
+  xTaskNotifyGive(simTask);
+}
+#else
+typedef TFT_eSPI SimCanvas;
+
+void simBegin() {}
+
+void simStop() {}
+
+bool simIdle() { return true; }
+
+/**
+ * Runs one frame of an animation job
+ */
+void simRun(SimJob job) {
+  simInputs = currentSimInputs();
+  job();
+}
+#endif
+
+extern SimCanvas& simCanvas; // Draw target for code that can run on the sim core
+
+/**
+ * Warp streaks for code that can run on the sim core (see streak.h)
+ */
+void simDrawStreak(int x0, int y0, int x1, int y1, uint8_t brightness) {
+#if SIM_PIPELINE
+  simRecorder.drawStreak(x0, y0, x1, y1, brightness);
+#else
+  drawStreak(x0, y0, x1, y1, brightness);
+#endif
+}
+
+void simEraseStreak(int x0, int y0, int x1, int y1, uint16_t color) {
+#if SIM_PIPELINE
+  simRecorder.eraseStreak(x0, y0, x1, y1, color);
+#else
+  eraseStreak(x0, y0, x1, y1, color);
+#endif
+}
+
+/**
+ * Circles for code that can run on the sim core (see canvasDrawCircle())
+ */
+void simDrawCircle(int x, int y, int r, uint16_t color) {
+#if SIM_PIPELINE
+  simRecorder.drawCircle(x, y, r, color);
+#else
+  canvasDrawCircle(x, y, r, color);
+#endif
+}
+
+void simFillCircle(int x, int y, int r, uint16_t color) {
+#if SIM_PIPELINE
+  simRecorder.fillCircle(x, y, r, color);
+#else
+  canvasFillCircle(x, y, r, color);
+#endif
+}
+
+/**
+ * Glow bitmaps for code that can run on the sim core (see glow.h)
+ */
+void simDrawGlow(uint8_t slot, int x, int y) {
+#if SIM_PIPELINE
+  simRecorder.drawGlow(slot, x, y);
+#else
+  glowBlit(slot, x, y);
+#endif
+}
+
+/**
+ * Lensing of what was drawn so far, for code that can run on the sim core (see lens.h)
+ */
+void simApplyLens(int x, int y) {
+#if SIM_PIPELINE
+  simRecorder.applyLens(x, y);
+#else
+  lensApply(x, y);
+#endif
+}
+
+#endif // SIMULATION_H
@@ -2,128 +2,92 @@
 #define STAR_H
 
 #include <TFT_eSPI.h>
+#include "render.h"
+#include "fixedpoint.h"
+#include "palette.h"
+#include "glow.h"
 
 // Forward declarations of external variables
-extern TFT_eSPI tft;
+extern TFT_eSPI& canvas; // Draw target, see render.h
 extern uint16_t BG_COLOR;
 extern int objectX;
 extern int objectY;
 extern float objectScale;
 
+#define STAR_ARENA_BYTES GLOW_BYTES((int)((int)(8 * GLOW_MAX_SCALE) * 1.5f))
+
 // Star structure and related constants
 struct Star {
-  float realX;          // Actual X position (float for smooth warp movement)
-  float realY;          // Actual Y position
-  uint8_t x;            // Integer X position for drawing
-  uint8_t y;            // Integer Y position for drawing
+  q16_16 realX;         // Actual X position (16.16 fixed point for smooth warp movement)
+  q16_16 realY;         // Actual Y position
+  q16_16 prevRealX;     // Position one simulation step earlier, for interpolation
+  q16_16 prevRealY;
+  screen_coord x;       // Integer X position for drawing
+  screen_coord y;       // Integer Y position for drawing
   uint8_t brightness;   // Brightness level (150-255)
   bool increasing;      // Brightness direction flag
   uint8_t streakLength; // Length of streak in warp mode
+  uint8_t layer;        // Depth layer, 0 is nearest (see StarLayer)
+};
+
+/**
+ * How the stars of one depth layer look and move
+ */
+struct StarLayer {
+  uint8_t count;         // Stars in the layer
+  uint8_t minBrightness; // Twinkle range
+  uint8_t maxBrightness;
+  uint8_t twinkleEvery;  // One star in this many takes a twinkle step per frame
+  uint8_t driftPer10s;   // Leftward drift in normal mode, pixels per 10 seconds
+  q16_16 depth;          // Warp speed and streak length factor, 1.0 is nearest
 };
 
 /**
  * Draws a single star with specified brightness
  */
 void drawStar(const Star& star) {
-  uint16_t color = tft.color565(star.brightness, star.brightness, star.brightness);
-  tft.drawPixel(star.x, star.y, color);
+  canvas.drawPixel(star.x, star.y, PAL_GREY.v[star.brightness]);
 }
 
 /**
- * Draws a star with flares and light variations
+ * Renders the star, its glow and its flares into the glow atlas
  */
-void drawStar() {
-  int centerX = objectX;
-  int centerY = objectY;
-  float scale = objectScale;
-  
-  // Base size
-  int radius = 8 * scale;
-  uint16_t starColor = TFT_WHITE;
-  
-  // Draw core with glow
-  for (int r = radius; r > 0; r--) {
-    float intensity = map(r, 0, radius, 255, 50) / 255.0;
-    uint16_t color = tft.color565(
-      255 * intensity,
-      255 * intensity,
-      240 * intensity
-    );
-    tft.drawCircle(centerX, centerY, r, color);
-  }
-  tft.fillCircle(centerX, centerY, radius/2, starColor);
-  
-  // Draw starflares
+void initStar() {
+  int radius = 8 * objectScale;
   int flareLength = radius * 1.5;
-  for (int i = 0; i < 4; i++) {
-    float angle = i * PI / 2.0;
-    int endX = centerX + flareLength * cos(angle);
-    int endY = centerY + flareLength * sin(angle);
-    
-    // Draw flare with gradient
-    for (int j = 0; j < flareLength; j++) {
-      int x = centerX + j * cos(angle);
-      int y = centerY + j * sin(angle);
-      
-      // Apply gradient
-      float brightness = 1.0 - (float)j / flareLength;
-      uint16_t flareColor = tft.color565(
-        255 * brightness,
-        255 * brightness,
-        240 * brightness
-      );
-      
-      tft.drawPixel(x, y, flareColor);
+  glowCreate(GLOW_STAR, flareLength, [=](int dx, int dy) -> uint16_t {
+    // Flares along the axes, fading out from the centre, on top of everything
+    if ((dx == 0 || dy == 0) && abs(dx + dy) < flareLength) {
+      return PAL_STAR.v[255 * (flareLength - abs(dx + dy)) / flareLength];
     }
-  }
+    if (glowInDisc(dx, dy, radius / 2)) return TFT_WHITE;
+    // Core with glow: one ring per pixel of radius
+    int r = glowRing(dx, dy);
+    if (r > radius) return 0;
+    return PAL_STAR.v[map(r, 0, radius, 255, 50)];
+  });
+}
+
+/**
+ * Draws a star with flares and light variations
+ */
+void drawStar() {
+  glowBlit(GLOW_STAR, objectX, objectY);
 }
 
 /**
  * Erases a star
  */
 void eraseStar() {
+#if !RENDER_FULL_REDRAW
   int centerX = objectX;
   int centerY = objectY;
   float scale = objectScale;
   
   // Erase with a circle slightly larger than the star + flares
   int eraseRadius = 8 * scale * 1.6;
-  tft.fillCircle(centerX, centerY, eraseRadius, BG_COLOR);
-}
-
-/**
- * Draws a star with a glow effect and subtle color variations
- */
-void drawStarWithGlow(int x, int y, int radius, uint16_t baseColor) {
-  // Draw glow
-  for (int r = radius + 2; r > radius; r--) {
-    uint8_t brightness = map(r, radius, radius + 2, 200, 100);
-    uint16_t glowColor = tft.color565(
-      ((baseColor >> 11) & 0x1F) * brightness / 255,
-      ((baseColor >> 5) & 0x3F) * brightness / 255,
-      (baseColor & 0x1F) * brightness / 255
-    );
-    tft.drawCircle(x, y, r, glowColor);
-  }
-
-  // Draw core with subtle color variations
-  for (int r = radius; r > 0; r--) {
-    float intensity = map(r, 0, radius, 255, 150) / 255.0;
-    uint8_t variation = random(-20, 21); // Subtle color variation
-    
-    // Calculate RGB components with proper type handling
-    float rComponent = ((baseColor >> 11) & 0x1F) * intensity * 8 + variation;
-    float gComponent = ((baseColor >> 5) & 0x3F) * intensity * 4 + variation;
-    float bComponent = (baseColor & 0x1F) * intensity * 8 + variation;
-    
-    // Use proper type for min/max operations (renamed variables to avoid conflict)
-    uint8_t red = constrain(rComponent, 0, 255);
-    uint8_t green = constrain(gComponent, 0, 255);
-    uint8_t blue = constrain(bComponent, 0, 255);
-    
-    uint16_t color = tft.color565(red, green, blue);
-    tft.drawCircle(x, y, r, color);
-  }
+  canvasFillCircle(centerX, centerY, eraseRadius, BG_COLOR);
+#endif
 }
 
 #endif // STAR_H 
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef STREAK_H
+#define STREAK_H
+
+#include <TFT_eSPI.h>
+#include "render.h"
+#include "palette.h"
+
+// Warp streak rasterizer: a streak is one line segment, drawn as runs of
+// pixels along its major axis. Each run is a single address window on the
+// panel (or one copy into the back buffer) instead of a drawPixel per pixel.
+
+#define STREAK_MAX_RUN 32 // Longest run pushed in one go, longer runs are split
+
+// Forward declarations of external variables
+extern TFT_eSPI& canvas; // Draw target, see render.h
+extern const int SCREEN_WIDTH;
+extern const int SCREEN_HEIGHT;
+
+/**
+ * Walks the line from (x0, y0) to (x1, y1) and calls
+ * fn(x, y, length, horizontal, firstIndex, indexStep) for each on-screen run.
+ * A run is a row (horizontal) or column of pixels starting at its left/top end;
+ * its pixel p is pixel firstIndex + p * indexStep of the line, counted from (x0, y0).
+ * Returns the index of the last pixel, i.e. the length of the line minus one.
+ */
+template <typename Fn>
+int forEachStreakRun(int x0, int y0, int x1, int y1, Fn fn) {
+  int dx = abs(x1 - x0);
+  int dy = abs(y1 - y0);
+  int sx = (x0 < x1) ? 1 : -1;
+  int sy = (y0 < y1) ? 1 : -1;
+  bool horizontal = dx >= dy;
+  int major = horizontal ? dx : dy;
+  int minor = horizontal ? dy : dx;
+  int majorStep = horizontal ? sx : sy;
+  int majorLimit = horizontal ? SCREEN_WIDTH : SCREEN_HEIGHT;
+  int minorLimit = horizontal ? SCREEN_HEIGHT : SCREEN_WIDTH;
+
+  int runMajor = horizontal ? x0 : y0; // Major coordinate of the run's first pixel
+  int runMinor = horizontal ? y0 : x0;
+  int runStart = 0;                    // Line index of the run's first pixel
+  int err = major / 2;
+
+  for (int i = 0; i <= major; i++) {
+    bool minorStep = false;
+    if (i < major) {
+      err -= minor;
+      if (err < 0) {
+        err += major;
+        minorStep = true;
+      }
+    }
+    if (i < major && !minorStep) continue;
+
+    // Run covers line pixels runStart..i, clip it to the screen
+    if (runMinor >= 0 && runMinor < minorLimit) {
+      int n = i - runStart + 1;
+      int kMin = (majorStep > 0) ? max(0, -runMajor) : max(0, runMajor - (majorLimit - 1));
+      int kMax = (majorStep > 0) ? min(n - 1, majorLimit - 1 - runMajor) : min(n - 1, runMajor);
+      if (kMin <= kMax) {
+        int len = kMax - kMin + 1;
+        // Runs are handed over left/top end first, whichever way the line goes
+        int firstK = (majorStep > 0) ? kMin : kMax;
+        int start = runMajor + majorStep * firstK;
+        if (horizontal) {
+          fn(start, runMinor, len, true, runStart + firstK, majorStep);
+        } else {
+          fn(runMinor, start, len, false, runStart + firstK, majorStep);
+        }
+      }
+    }
+
+    runMajor += majorStep * (i - runStart + 1);
+    runMinor += horizontal ? sy : sx;
+    runStart = i + 1;
+  }
+  return major;
+}
+
+/**
+ * Draws a warp streak from its head (x0, y0) to its tail (x1, y1), fading from
+ * brightness at the head to black at the tail
+ */
+void drawStreak(int x0, int y0, int x1, int y1, uint8_t brightness) {
+  int last = max(abs(x1 - x0), abs(y1 - y0));
+  forEachStreakRun(x0, y0, x1, y1, [&](int x, int y, int len, bool horizontal, int index, int step) {
+    uint16_t colors[STREAK_MAX_RUN];
+    for (int done = 0; done < len; done += STREAK_MAX_RUN) {
+      int chunk = min(len - done, STREAK_MAX_RUN);
+      for (int p = 0; p < chunk; p++) {
+        int j = index + (done + p) * step;
+        uint8_t intensity = (last > 0) ? brightness * (last - j) / last : brightness;
+        colors[p] = PAL_GREY.v[intensity];
+      }
+      if (horizontal) {
+        pushSpan(x + done, y, chunk, 1, colors);
+      } else {
+        pushSpan(x, y + done, 1, chunk, colors);
+      }
+    }
+  });
+}
+
+/**
+ * Fills the pixels of a streak drawn by drawStreak() with one colour
+ */
+void eraseStreak(int x0, int y0, int x1, int y1, uint16_t color) {
+  forEachStreakRun(x0, y0, x1, y1, [&](int x, int y, int len, bool horizontal, int, int) {
+    if (horizontal) {
+      canvas.drawFastHLine(x, y, len, color);
+    } else {
+      canvas.drawFastVLine(x, y, len, color);
+    }
+  });
+}
+
+#endif // STREAK_H
@@ -2,9 +2,14 @@
 #define SUPERNOVA_H
 
 #include <TFT_eSPI.h>
+#include "render.h"
+#include "simulation.h"
+#include "arena.h"
+#include "rng.h"
+#include "particles.h"
 
 // Forward declarations of external variables and constants
-extern TFT_eSPI tft;
+extern TFT_eSPI& canvas; // Draw target for erasing, see render.h
 extern uint16_t BG_COLOR;
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
@@ -20,13 +25,61 @@ struct SupernovaParticle {
   float vx, vy;        // Velocity
   int brightness;      // Brightness
   uint16_t color;      // Color
-  int prevX, prevY;    // Previous position
-  bool active;         // Whether the particle is active
+  int prevX, prevY;    // Last drawn position
 };
 
+/**
+ * Debris flies out from the explosion and fades once the shock wave weakens
+ */
+struct SupernovaDebrisTraits {
+  struct Context {
+    int steps;
+    bool fading;
+  };
+
+  static bool update(SupernovaParticle& p, Context& context) {
+#if !RENDER_FULL_REDRAW
+    // Erase old position
+    simCanvas.drawPixel(p.prevX, p.prevY, BG_COLOR);
+#endif
+
+    // Update position
+    p.x += p.vx * context.steps;
+    p.y += p.vy * context.steps;
+
+    // Fade particles in phase 2; completely faded ones are gone
+    if (context.fading) {
+      p.brightness = max(0, (int)(p.brightness - 2 * context.steps));
+      if (p.brightness <= 10) return false;
+    }
+
+    // Particles that leave the screen are gone too
+    int x = round(p.x);
+    int y = round(p.y);
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return false;
+    p.prevX = x;
+    p.prevY = y;
+    return true;
+  }
+
+  static void draw(const SupernovaParticle& p, Context& context) {
+    // Calculate final color with applied brightness
+    float brightnessFactor = p.brightness / 255.0f;
+    uint16_t baseColor = p.color;
+    uint8_t r = ((baseColor >> 11) & 0x1F) * brightnessFactor * 8;
+    uint8_t g = ((baseColor >> 5) & 0x3F) * brightnessFactor * 4;
+    uint8_t b = (baseColor & 0x1F) * brightnessFactor * 8;
+    simCanvas.drawPixel(p.prevX, p.prevY, simCanvas.color565(r, g, b));
+  }
+};
+
+typedef ParticleSystem<SupernovaParticle, MAX_SUPERNOVA_PARTICLES, SupernovaDebrisTraits> SupernovaDebris;
+
+#define SUPERNOVA_ARENA_BYTES ARENA_SIZE(SupernovaDebris, 1)
+
 // These variables are visible only within this module
 namespace {
-  SupernovaParticle supernovaParticles[MAX_SUPERNOVA_PARTICLES];
+  SupernovaDebris* supernovaParticles = nullptr; // From the object arena
   bool supernovaInitialized = false;
   unsigned long supernovaStartTime = 0;
   int supernovaPhase = 0;  // 0=initial, 1=expanding, 2=fading
@@ -34,6 +87,14 @@ namespace {
   int prevSupernovaX = 0, prevSupernovaY = 0;
 }
 
+/**
+ * Takes the debris from the object arena; the first draw starts the explosion
+ */
+void initSupernova() {
+  supernovaParticles = arenaAlloc<SupernovaDebris>();
+  supernovaInitialized = false;
+}
+
 /**
  * Draws a supernova - an exploding star with expanding shock wave and debris
  */
@@ -41,7 +102,7 @@ void drawSupernova() {
   int centerX = objectX;
   int centerY = objectY;
   float scale = objectScale;
-  unsigned long currentTime = millis();
+  unsigned long currentTime = simInputs.clock.timeMs;
   
   if (!supernovaInitialized) {
     prevSupernovaX = centerX;
@@ -50,32 +111,12 @@ void drawSupernova() {
     supernovaStartTime = currentTime;
     supernovaPhase = 0;
     
-    // Initialize explosion particles (initially inactive)
-    for (int i = 0; i < MAX_SUPERNOVA_PARTICLES; i++) {
-      supernovaParticles[i].active = false;
-      supernovaParticles[i].x = centerX;
-      supernovaParticles[i].y = centerY;
-      
-      // Pre-assign colors for later use
-      int colorChoice = random(4);
-      if (colorChoice == 0) {
-        supernovaParticles[i].color = tft.color565(255, 255, 200); // White-yellow
-      } else if (colorChoice == 1) {
-        supernovaParticles[i].color = tft.color565(255, 150, 50);  // Orange
-      } else if (colorChoice == 2) {
-        supernovaParticles[i].color = tft.color565(255, 50, 50);   // Red
-      } else {
-        supernovaParticles[i].color = tft.color565(200, 200, 255); // Blue-white
-      }
-      
-      // Store initial position for erasing
-      supernovaParticles[i].prevX = centerX;
-      supernovaParticles[i].prevY = centerY;
-    }
+    // The debris only exists once the star explodes
+    supernovaParticles->clear();
     
     // Draw initial star
-    uint16_t starColor = tft.color565(255, 200, 100); // Yellow-orange
-    tft.fillCircle(centerX, centerY, supernovaRadius, starColor);
+    uint16_t starColor = simCanvas.color565(255, 200, 100); // Yellow-orange
+    simFillCircle(centerX, centerY, supernovaRadius, starColor);
     
     supernovaInitialized = true;
   }
@@ -87,16 +128,31 @@ void drawSupernova() {
   if (supernovaPhase == 0 && elapsedTime > 1000) {
     supernovaPhase = 1; // Start expansion
     
-    // Activate all particles
-    for (int i = 0; i < MAX_SUPERNOVA_PARTICLES; i++) {
-      supernovaParticles[i].active = true;
-      supernovaParticles[i].brightness = 255;
+    // Spawn all the debris at once
+    supernovaParticles->beginSpawns(MAX_SUPERNOVA_PARTICLES);
+    while (SupernovaParticle* p = supernovaParticles->spawn()) {
+      p->x = centerX;
+      p->y = centerY;
+      p->prevX = centerX;
+      p->prevY = centerY;
+      p->brightness = 255;
+      
+      int colorChoice = objectRng.below(4);
+      if (colorChoice == 0) {
+        p->color = simCanvas.color565(255, 255, 200); // White-yellow
+      } else if (colorChoice == 1) {
+        p->color = simCanvas.color565(255, 150, 50);  // Orange
+      } else if (colorChoice == 2) {
+        p->color = simCanvas.color565(255, 50, 50);   // Red
+      } else {
+        p->color = simCanvas.color565(200, 200, 255); // Blue-white
+      }
       
       // Random velocity in all directions
-      float angle = random(0, 360) * PI / 180.0f;
-      float speed = random(10, 20) / 10.0f * scale;
-      supernovaParticles[i].vx = cos(angle) * speed;
-      supernovaParticles[i].vy = sin(angle) * speed;
+      float angle = objectRng.range(0, 360) * PI / 180.0f;
+      float speed = objectRng.range(10, 20) / 10.0f * scale;
+      p->vx = cos(angle) * speed;
+      p->vy = sin(angle) * speed;
     }
   } else if (supernovaPhase == 1 && elapsedTime > 3000) {
     supernovaPhase = 2; // Start fading
@@ -111,19 +167,23 @@ void drawSupernova() {
     // Gradually increase brightness
     float brightness = min(1.0f, (float)elapsedTime / 1000.0f) * pulseFactor;
     
-    uint16_t starColor = tft.color565(
+    uint16_t starColor = simCanvas.color565(
       255 * brightness, 
       200 * brightness, 
       100 * brightness
     );
     
     // Erase and redraw star with new brightness
-    tft.fillCircle(centerX, centerY, supernovaRadius, BG_COLOR);
-    tft.fillCircle(centerX, centerY, supernovaRadius, starColor);
+#if !RENDER_FULL_REDRAW
+    simFillCircle(centerX, centerY, supernovaRadius, BG_COLOR);
+#endif
+    simFillCircle(centerX, centerY, supernovaRadius, starColor);
     
   } else if (supernovaPhase == 1 || supernovaPhase == 2) {
+#if !RENDER_FULL_REDRAW
     // Clear the center as the star has exploded
-    tft.fillCircle(centerX, centerY, supernovaRadius, BG_COLOR);
+    simFillCircle(centerX, centerY, supernovaRadius, BG_COLOR);
+#endif
     
     // Draw shockwave (expanding ring)
     int waveRadius = (int)(5 + (elapsedTime - 1000) / 100.0f * scale);
@@ -135,62 +195,20 @@ void drawSupernova() {
       
       for (int w = 0; w < waveWidth; w++) {
         float ringBrightness = waveBrightness * (1.0f - (float)w / waveWidth);
-        uint16_t ringColor = tft.color565(
+        uint16_t ringColor = simCanvas.color565(
           255 * ringBrightness,
           200 * ringBrightness,
           150 * ringBrightness
         );
         
-        tft.drawCircle(centerX, centerY, waveRadius + w, ringColor);
+        simDrawCircle(centerX, centerY, waveRadius + w, ringColor);
       }
     }
     
     // Update and draw particles
-    for (int i = 0; i < MAX_SUPERNOVA_PARTICLES; i++) {
-      if (supernovaParticles[i].active) {
-        // Erase old position
-        tft.drawPixel(supernovaParticles[i].prevX, supernovaParticles[i].prevY, BG_COLOR);
-        
-        // Update position
-        supernovaParticles[i].x += supernovaParticles[i].vx;
-        supernovaParticles[i].y += supernovaParticles[i].vy;
-        
-        // Fade particles in phase 2
-        if (supernovaPhase == 2) {
-          supernovaParticles[i].brightness = max(0, (int)(supernovaParticles[i].brightness - 2));
-          
-          // Deactivate completely faded particles
-          if (supernovaParticles[i].brightness <= 10) {
-            supernovaParticles[i].active = false;
-            continue;
-          }
-        }
-        
-        // Calculate final color with applied brightness
-        float brightnessFactor = supernovaParticles[i].brightness / 255.0f;
-        uint16_t baseColor = supernovaParticles[i].color;
-        uint8_t r = ((baseColor >> 11) & 0x1F) * brightnessFactor * 8;
-        uint8_t g = ((baseColor >> 5) & 0x3F) * brightnessFactor * 4;
-        uint8_t b = (baseColor & 0x1F) * brightnessFactor * 8;
-        
-        uint16_t finalColor = tft.color565(r, g, b);
-        
-        // Draw at new position
-        int x = round(supernovaParticles[i].x);
-        int y = round(supernovaParticles[i].y);
-        
-        if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-          tft.drawPixel(x, y, finalColor);
-          
-          // Store position for next erase
-          supernovaParticles[i].prevX = x;
-          supernovaParticles[i].prevY = y;
-        } else {
-          // Deactivate particles that leave the screen
-          supernovaParticles[i].active = false;
-        }
-      }
-    }
+    SupernovaDebrisTraits::Context debrisContext = {simInputs.clock.steps, supernovaPhase == 2};
+    supernovaParticles->update(debrisContext);
+    supernovaParticles->draw(debrisContext);
   }
 }
 
@@ -199,31 +217,32 @@ void drawSupernova() {
  */
 void eraseSupernova() {
   if (supernovaInitialized) {
+#if !RENDER_FULL_REDRAW
     // Erase the main supernova
     if (prevSupernovaX >= 0 && prevSupernovaX < SCREEN_WIDTH && 
         prevSupernovaY >= 0 && prevSupernovaY < SCREEN_HEIGHT) {
       // Use a larger radius to ensure we clear all visual effects
       int clearRadius = max(supernovaRadius + 5, 30);
-      tft.fillCircle(prevSupernovaX, prevSupernovaY, clearRadius, BG_COLOR);
+      canvasFillCircle(prevSupernovaX, prevSupernovaY, clearRadius, BG_COLOR);
     }
     
     // Erase all particles with a bit of padding
-    for (int i = 0; i < MAX_SUPERNOVA_PARTICLES; i++) {
-      if (supernovaParticles[i].active) {
-        int particleX = round(supernovaParticles[i].x);
-        int particleY = round(supernovaParticles[i].y);
-        
-        if (particleX >= 0 && particleX < SCREEN_WIDTH && 
-            particleY >= 0 && particleY < SCREEN_HEIGHT) {
-          // Clear with slightly larger area for particles that might have visual blur
-          tft.fillCircle(particleX, particleY, 2, BG_COLOR);
-        }
+    for (uint16_t i = 0; i < supernovaParticles->live(); i++) {
+      const SupernovaParticle& particle = (*supernovaParticles)[i];
+      int particleX = round(particle.x);
+      int particleY = round(particle.y);
+      
+      if (particleX >= 0 && particleX < SCREEN_WIDTH && 
+          particleY >= 0 && particleY < SCREEN_HEIGHT) {
+        // Clear with slightly larger area for particles that might have visual blur
+        canvasFillCircle(particleX, particleY, 2, BG_COLOR);
       }
     }
     
     // Clear the full shockwave area just to be safe
     int maxShockwaveRadius = 40 * objectScale;
-    tft.fillCircle(objectX, objectY, maxShockwaveRadius, BG_COLOR);
+    canvasFillCircle(objectX, objectY, maxShockwaveRadius, BG_COLOR);
+#endif
     
     supernovaInitialized = false;
   }
@@ -0,0 +1,267 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+// Input trace recording and replay, for reproducing a session exactly. A
+// trace holds the session seed (rng.h) and then the inputs loop() acted on, each
+// stamped with its frame number:
+// - the potentiometer value processInput() used,
+// - the raw power button reading,
+// - the time frameClockTick() saw,
+// - the detail level the governor chose.
+// A value is only written when it changes. During replay the same values come
+// back in place of the hardware, so the session plays out frame for frame,
+// however long the frames take to draw this time. When the trace runs out the
+// live inputs take over again.
+// Recordings go to TRACE_FILE on LittleFS. Sending 't' over serial ends the
+// recording and dumps the file as hex, for replay in the host simulator.
+
+#define TRACE_OFF 0
+#define TRACE_RECORD 1
+#define TRACE_REPLAY 2
+
+#ifndef TRACE_MODE
+#define TRACE_MODE TRACE_OFF      // Mode at boot
+#endif
+
+#define TRACE_FILE "/trace.bin"
+#define TRACE_MAGIC 0x31525457    // "WTR1" in the first four bytes
+#define TRACE_MAX_BYTES 65536     // Recording stops here, several minutes of frames
+#define TRACE_BUFFER_EVENTS 64    // Events held in RAM between flash writes
+#define TRACE_HEX_PER_LINE 32     // Bytes per line of traceDump()
+
+/**
+ * What an event carries; TRACE_END marks the last recorded frame
+ */
+enum TraceChannel : uint8_t {
+  TRACE_POT,
+  TRACE_BUTTON,
+  TRACE_CLOCK,   // Low 32 bits of esp_timer_get_time()
+  TRACE_DETAIL,
+  TRACE_CHANNELS,
+  TRACE_END = 0xFF
+};
+
+/**
+ * File layout: the header, then events in frame order
+ */
+struct TraceHeader {
+  uint32_t magic;
+  uint32_t seed;
+};
+
+struct TraceEvent {
+  uint32_t frameAndChannel; // Frame << 8 | channel
+  uint32_t value;
+};
+
+namespace {
+  uint8_t traceMode = TRACE_MODE;       // May be changed before setup(), as the host simulator does
+  const char* tracePath = TRACE_FILE;
+  File traceFile;
+  TraceEvent traceBuffer[TRACE_BUFFER_EVENTS];
+  uint8_t traceBuffered = 0;            // Recording: events not written yet. Replay: events read
+  uint8_t traceNext = 0;                // Replay: next event in the buffer
+  uint32_t traceBytes = 0;              // Recording: bytes in the file
+  uint32_t traceFrame = 0;              // Frames since traceBegin()
+  uint32_t traceValue[TRACE_CHANNELS];  // Last value written, or the value in force during replay
+  bool traceHasValue[TRACE_CHANNELS];
+  int64_t traceReplayUs = 0;            // Replay: the recorded clock, widened back to 64 bits
+}
+
+/**
+ * True while inputs come from a trace
+ */
+inline bool traceReplaying() {
+  return traceMode == TRACE_REPLAY;
+}
+
+/**
+ * Writes the buffered events to the file
+ */
+bool traceFlush() {
+  size_t bytes = traceBuffered * sizeof(TraceEvent);
+  traceBuffered = 0;
+  if (traceFile.write((const uint8_t*)traceBuffer, bytes) != bytes) {
+    return false;
+  }
+  traceBytes += bytes;
+  return true;
+}
+
+/**
+ * Finishes a recording, or abandons a replay; the live inputs are used from here on
+ */
+void traceEnd() {
+  if (traceMode == TRACE_RECORD && traceBytes > 0) {
+    traceBuffer[traceBuffered++] = {traceFrame << 8 | TRACE_END, 0}; // There is always room for it
+    traceFlush();
+    Serial.printf("Trace: recorded %lu frames, %lu bytes\n", (unsigned long)traceFrame, (unsigned long)traceBytes);
+  }
+  if (traceFile) traceFile.close();
+  traceMode = TRACE_OFF;
+}
+
+/**
+ * Starts recording or replaying, whichever traceMode asks for.
+ * Returns the seed to give rngBegin(): liveSeed, or the one in the trace.
+ */
+uint32_t traceBegin(uint32_t liveSeed) {
+  traceFrame = 0;
+  traceBuffered = traceNext = 0;
+  traceBytes = 0;
+  memset(traceHasValue, 0, sizeof(traceHasValue));
+  if (traceMode == TRACE_OFF) return liveSeed;
+
+  if (!LittleFS.begin(true)) {
+    Serial.println("Trace: LittleFS did not mount, tracing off");
+    traceMode = TRACE_OFF;
+    return liveSeed;
+  }
+
+  TraceHeader header = {TRACE_MAGIC, liveSeed};
+  if (traceMode == TRACE_RECORD) {
+    traceFile = LittleFS.open(tracePath, FILE_WRITE);
+    if (!traceFile || traceFile.write((const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+      Serial.printf("Trace: cannot write %s, tracing off\n", tracePath);
+      traceEnd();
+      return liveSeed;
+    }
+    traceBytes = sizeof(header);
+    Serial.printf("Trace: recording to %s\n", tracePath);
+    return liveSeed;
+  }
+
+  traceFile = LittleFS.open(tracePath, FILE_READ);
+  if (!traceFile || traceFile.read((uint8_t*)&header, sizeof(header)) != sizeof(header) || header.magic != TRACE_MAGIC) {
+    Serial.printf("Trace: no trace in %s, tracing off\n", tracePath);
+    traceEnd();
+    return liveSeed;
+  }
+  Serial.printf("Trace: replaying %s\n", tracePath);
+  return header.seed;
+}
+
+/**
+ * Replay: applies every event up to the current frame
+ */
+void traceCatchUp() {
+  while (traceMode == TRACE_REPLAY) {
+    if (traceNext == traceBuffered) {
+      int bytes = traceFile.read((uint8_t*)traceBuffer, sizeof(traceBuffer));
+      traceBuffered = bytes > 0 ? bytes / sizeof(TraceEvent) : 0;
+      traceNext = 0;
+      if (traceBuffered == 0) {
+        Serial.println("Trace: replay cut short, live input from here");
+        traceEnd();
+        return;
+      }
+    }
+
+    const TraceEvent& event = traceBuffer[traceNext];
+    uint32_t frame = event.frameAndChannel >> 8;
+    uint8_t channel = event.frameAndChannel & 0xFF;
+    if (channel == TRACE_END) {
+      // The recording covered this frame completely; stop at the next one
+      if (traceFrame > frame) {
+        Serial.println("Trace: replay finished, live input from here");
+        traceEnd();
+      }
+      return;
+    }
+    if (frame > traceFrame) return;
+    if (channel < TRACE_CHANNELS) {
+      traceValue[channel] = event.value;
+      traceHasValue[channel] = true;
+    }
+    traceNext++;
+  }
+}
+
+/**
+ * Records a live input, or swaps in the recorded one during replay
+ */
+uint32_t traceInput(uint8_t channel, uint32_t live) {
+  if (traceMode == TRACE_RECORD) {
+    if (traceHasValue[channel] && traceValue[channel] == live) return live;
+    traceValue[channel] = live;
+    traceHasValue[channel] = true;
+    traceBuffer[traceBuffered++] = {traceFrame << 8 | channel, live};
+    if (traceBuffered == TRACE_BUFFER_EVENTS - 1) { // Keep a slot for the end marker
+      if (!traceFlush()) {
+        Serial.println("Trace: write failed, recording stopped");
+        traceEnd();
+      } else if (traceBytes + sizeof(traceBuffer) > TRACE_MAX_BYTES) {
+        traceEnd();
+      }
+    }
+  } else if (traceMode == TRACE_REPLAY) {
+    traceCatchUp();
+    if (traceMode == TRACE_REPLAY && traceHasValue[channel]) return traceValue[channel];
+  }
+  return live;
+}
+
+/**
+ * Potentiometer value for processInput()
+ */
+inline int tracePot(int live) {
+  return (int)traceInput(TRACE_POT, (uint32_t)live);
+}
+
+/**
+ * Raw power button reading for checkPowerButton()
+ */
+inline int traceButton(int live) {
+  return (int)traceInput(TRACE_BUTTON, (uint32_t)live);
+}
+
+/**
+ * Detail level for the next frame, after lodUpdate()
+ */
+inline uint8_t traceDetail(uint8_t live) {
+  return (uint8_t)traceInput(TRACE_DETAIL, live);
+}
+
+/**
+ * Frame clock time for frameClockTick(); also counts the frames
+ */
+int64_t traceClock(int64_t liveUs) {
+  if (traceMode == TRACE_OFF) return liveUs;
+  traceFrame++;
+  bool started = traceHasValue[TRACE_CLOCK];
+  uint32_t previous = traceValue[TRACE_CLOCK];
+  uint32_t low = traceInput(TRACE_CLOCK, (uint32_t)liveUs);
+  if (traceMode != TRACE_REPLAY) return liveUs;
+
+  // Only the low bits are stored; the steps between frames are short enough to add up
+  traceReplayUs = started ? traceReplayUs + (uint32_t)(low - previous) : (int64_t)low;
+  return traceReplayUs;
+}
+
+/**
+ * Ends a recording in progress and prints the trace file as hex between "TRACE <bytes>" and "END"
+ */
+void traceDump() {
+  if (traceMode == TRACE_RECORD) traceEnd();
+  if (traceMode == TRACE_REPLAY || !LittleFS.begin(true)) return;
+
+  File file = LittleFS.open(tracePath, FILE_READ);
+  if (!file) {
+    Serial.printf("Trace: no trace in %s\n", tracePath);
+    return;
+  }
+  Serial.printf("TRACE %lu\n", (unsigned long)file.size());
+  uint8_t line[TRACE_HEX_PER_LINE];
+  int count;
+  while ((count = file.read(line, sizeof(line))) > 0) {
+    for (int i = 0; i < count; i++) Serial.printf("%02x", line[i]);
+    Serial.println();
+  }
+  Serial.println("END");
+  file.close();
+}
+
+#endif // TRACE_H
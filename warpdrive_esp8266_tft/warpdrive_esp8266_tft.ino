@@ -33,11 +33,32 @@
 
 #include <TFT_eSPI.h> // Replace Adafruit_GFX and Adafruit_ST7735
 #include <SPI.h>
+#include "render.h" // Render target selection (direct or sprite back buffer)
+#include "blend.h" // Integer RGB565 blending and saturating add
+#include "profiler.h" // Frame timers and SPI counters, dumped with 'p' over serial
+#include "debuglog.h" // DEBUG_LOG() and the verbosity levels
+#include "input.h" // Background potentiometer sampling and filtering
+#include "trace.h" // Input recording and replay, dumped with 't' over serial
+#include "lod.h" // Frame-time driven detail level
+#include "frameclock.h" // Fixed-step simulation clock and frame pacing
+#include "simulation.h" // Sim core / render core split for the particle animations
+#include "fixedpoint.h" // Q16.16 / Q8.8 math and the trig tables in flash
+#include "palette.h" // Precomputed RGB565 ramps for gradients
+#include "arena.h" // Shared storage for the object on screen
+#include "rng.h" // Random number streams for each subsystem
+#include "particles.h" // Pooled particle storage for the particle effects
+#include "celestial.h" // Renderer table for the celestial objects
+#include "glow.h" // Pre-rendered glows for stars and cores
+#include "hud.h" // Retained text and gauge overlay
 #include "blackhole.h"
 #include "pulsar.h" // Include the pulsar header file
 #include "supernova.h" // Include the supernova header file
 #include "comet.h" // Include the comet header file
 #include "star.h"
+#include "planet.h"
+#include "mirror.h" // Frame and telemetry stream to a viewer over Wi-Fi, off by default
+#include "power.h" // CPU clock scaling and light sleep between frames
+#include "bench.h" // Fixed benchmark run over warp and every object, 'b' over serial
 #include <esp_sleep.h>
 #include <driver/rtc_io.h>
 
@@ -58,20 +79,46 @@ unsigned long buttonPressStartTime = 0;
 #define ST7735_GRAY 0x8410  // Medium gray in RGB565 format
 //#define ST7735_GREEN 0x07E0  // Green color in RGB565 format
 
-// Previous positions for nebula
-#define MAX_NEBULA_CIRCLES 15
-int prevNebulaX[MAX_NEBULA_CIRCLES], prevNebulaY[MAX_NEBULA_CIRCLES];
-int prevNebulaR[MAX_NEBULA_CIRCLES];
-int prevNebulaColors[MAX_NEBULA_CIRCLES];
-int prevNebulaCount = 0;
+// Galaxy: a point cloud generated on discovery and rotated as a whole every frame
+#define MAX_GALAXY_ARMS 5
+#define MAX_GALAXY_POINTS 96       // Points per arm
+#define MIN_GALAXY_POINTS 16       // Points per arm kept at the lowest detail level
+#define GALAXY_ARM_CANDIDATES 160  // Places tried along each arm, some are left empty
 
-// Previous positions for galaxy
+/**
+ * One star of the galaxy, in polar form around the centre
+ */
+struct GalaxyPoint {
+  fx_angle angle;          // Before the galaxy's rotation
+  fx_angle twinkle;        // Twinkle phase
+  int16_t radius;          // Distance from the centre in pixels, Q8.8
+  int8_t jitterX, jitterY; // Offset off the arm in 1/64 pixels
+  uint8_t brightness;      // Before twinkling
+  uint16_t color;          // Fixed color, or 0 for a twinkling white star
+};
+
+GalaxyPoint* galaxyPoints = nullptr;    // [arm * MAX_GALAXY_POINTS + point], from the object arena
+uint8_t galaxyArmPoints[MAX_GALAXY_ARMS]; // Points generated per arm, inner ones first
+#if !RENDER_FULL_REDRAW
+/**
+ * What a galaxy point last put on the panel
+ */
+struct GalaxyPixel {
+  screen_coord x, y; // x is SCREEN_NO_COORD when nothing
+  uint16_t color;
+};
+
+#define GALAXY_ERASED_WORDS (TFT_WIDTH * TFT_HEIGHT / 32)
 int prevGalaxyCenterX, prevGalaxyCenterY;
 int prevGalaxyCoreRadius;
-#define MAX_GALAXY_ARMS 4
-#define MAX_GALAXY_POINTS 50
-int prevGalaxyPoints[MAX_GALAXY_ARMS][MAX_GALAXY_POINTS][2]; // [arm][point][x,y]
-int prevGalaxyPointCount[MAX_GALAXY_ARMS];
+GalaxyPixel* galaxyShown = nullptr; // Same layout as galaxyPoints, from the object arena
+uint32_t* galaxyErased = nullptr;   // One bit per screen pixel cleared this frame
+#define GALAXY_ARENA_BYTES (ARENA_SIZE(GalaxyPoint, MAX_GALAXY_ARMS * MAX_GALAXY_POINTS) + \
+                            ARENA_SIZE(GalaxyPixel, MAX_GALAXY_ARMS * MAX_GALAXY_POINTS) + \
+                            ARENA_SIZE(uint32_t, GALAXY_ERASED_WORDS))
+#else
+#define GALAXY_ARENA_BYTES ARENA_SIZE(GalaxyPoint, MAX_GALAXY_ARMS * MAX_GALAXY_POINTS)
+#endif
 
 // Previous positions for solar system
 int prevSunX, prevSunY, prevSunRadius;
@@ -98,24 +145,69 @@ struct Asteroid {
   int radius;
   int prevX, prevY;
 };
-Asteroid asteroids[MAX_ASTEROIDS];
+#define ASTEROID_FIELD_ARENA_BYTES ARENA_SIZE(Asteroid, MAX_ASTEROIDS)
+Asteroid* asteroids = nullptr; // MAX_ASTEROIDS from the object arena
 bool asteroidFieldInitialized = false;
 
 // Initialize TFT object
 TFT_eSPI tft = TFT_eSPI();
+#if RENDER_MODE == RENDER_SPRITE
+TFT_eSprite backBuffer = TFT_eSprite(&tft); // Full-screen back buffer, pushed with DMA
+TFT_eSPI& canvas = backBuffer;
+#elif RENDER_MODE == RENDER_TILED
+TileCanvas backBuffer = TileCanvas(&tft); // Full-screen back buffer, only changed tiles are pushed
+TFT_eSPI& canvas = backBuffer;
+#elif RENDER_MODE == RENDER_BANDED
+BandRecorder frameRecorder = BandRecorder(&tft); // Records each frame for presentFrame() to compose band by band
+TFT_eSprite bandBuffer = TFT_eSprite(&tft);      // Two strips of BAND_HEIGHT rows, pushed with DMA
+TFT_eSPI& canvas = frameRecorder;
+#elif PIXEL_BATCH
+PixelBatch pixelBatch = PixelBatch(&tft); // Write-combines single pixels on their way to the panel
+TFT_eSPI& canvas = pixelBatch;
+#else
+TFT_eSPI& canvas = tft;
+#endif
+TFT_eSprite hudAtlas = TFT_eSprite(&tft); // Pre-rendered HUD elements, see hud.h
+#if SIM_PIPELINE
+CommandRecorder simRecorder; // Records sim core drawing for loop() to replay into canvas
+CommandRecorder& simCanvas = simRecorder;
+#else
+TFT_eSPI& simCanvas = canvas;
+#endif
 // Display dimensions
-constexpr int SCREEN_WIDTH  = 128;
-constexpr int SCREEN_HEIGHT = 128;
-int potValue = 0;  // Potentiometer value
-
-// Starfield parameters
-constexpr int STAR_COUNT = 60;
-Star stars[STAR_COUNT];
-
-// Previous positions for streak erasure in warp mode
+constexpr int SCREEN_WIDTH  = PANEL_WIDTH;  // From User_Setup.h, see render.h
+constexpr int SCREEN_HEIGHT = PANEL_HEIGHT;
+std::atomic<int> potValue{0};  // Filtered potentiometer value, published by the sampler (see input.h)
+
+// Starfield parameters: depth layers, nearest first. Far layers are dimmer,
+// drift slower, twinkle less often and streak shorter in warp.
+constexpr StarLayer STAR_LAYER[] = {
+  // count, brightness, twinkle every, drift per 10 s, depth
+  {36, 190, 255, 8, 20, FX_ONE},
+  {60, 160, 225, 16, 8, FX_CONST(0.65f)},
+  {84, 130, 190, 32, 3, FX_CONST(0.4f)},
+};
+constexpr int STAR_LAYERS = sizeof(STAR_LAYER) / sizeof(STAR_LAYER[0]);
+constexpr int STAR_COUNT = 36 + 60 + 84;
+static_assert(STAR_LAYERS == 3 && STAR_LAYER[0].count + STAR_LAYER[1].count + STAR_LAYER[2].count == STAR_COUNT,
+              "STAR_COUNT is the sum of the layers");
+constexpr int MIN_STAR_COUNT = 48; // Stars kept at the lowest detail level, the far layer goes first
+constexpr int WARP_STAR_COUNT = 36 + 60; // Layers that streak in warp; the far one stays put behind them
+Star stars[STAR_COUNT];            // Layer by layer, in the order of STAR_LAYER
+int starLayerShift[STAR_LAYERS];   // Pixels each layer has drifted, modulo the screen width
+uint32_t starFrame = 0;            // updateStars() calls, picks the stars that twinkle
+int activeStars = STAR_COUNT;     // Normal-mode stars in use at the current detail level
+int activeWarpStars = WARP_STAR_COUNT; // Stars streaked last warp frame
+
+// End points of each star's last streak, for erasing in warp mode
 constexpr int MAX_STREAK_LENGTH = 15;
-uint8_t prevX[STAR_COUNT][MAX_STREAK_LENGTH + 1];
-uint8_t prevY[STAR_COUNT][MAX_STREAK_LENGTH + 1];
+#if !RENDER_FULL_REDRAW
+struct StreakEnds {
+  int16_t headX, headY;
+  int16_t tailX, tailY;
+};
+StreakEnds prevStreaks[WARP_STAR_COUNT];
+#endif
 
 // Colors
 uint16_t BG_COLOR = TFT_BLACK;
@@ -153,6 +245,11 @@ enum class CelestialObject {
   SPACE_STATION, // Added Space Station
   NUM_TYPES  // Keep this last
 };
+static_assert(static_cast<int>(CelestialObject::NUM_TYPES) == PROF_OBJECT_TYPES, "Profiler needs a section per object");
+const char* const CELESTIAL_OBJECT_NAMES[PROF_OBJECT_TYPES] = {
+  "star", "planet", "nebula", "galaxy", "solar", "asteroids",
+  "blackhole", "pulsar", "supernova", "comet", "binary", "station"
+};
 CelestialObject currentObject;
 unsigned long discoveryStartTime;
 
@@ -217,6 +314,29 @@ void initializeAccretionParticle(int index, int centerX, int centerY);
 // Add new variable to track power state
 bool isPoweredOn = true;  // Start powered on
 
+// Session snapshot kept in RTC memory through deep sleep, so a button wake
+// carries on with the same sky instead of replaying the intro.
+// The object on screen is not kept: its state lives in the object arena.
+#define SNAPSHOT_MAGIC 0x534E4150 // "SNAP"
+
+struct SnapshotStar {
+  screen_coord x, y;
+  uint8_t brightness;
+  bool increasing;
+};
+
+struct RtcSnapshot {
+  uint32_t magic;          // SNAPSHOT_MAGIC while it holds a session
+  uint32_t rngState[4];    // starRng, warpRng, discoveryRng, objectRng
+  uint32_t starFrame;
+  uint8_t state;           // State at power-off
+  uint8_t objectsRemaining;
+  bool objectsShown[static_cast<int>(CelestialObject::NUM_TYPES)];
+  int16_t starLayerShift[STAR_LAYERS];
+  SnapshotStar stars[STAR_COUNT]; // Layers are implied by the index, as in stars
+};
+RTC_DATA_ATTR RtcSnapshot rtcSnapshot; // About 1.1 KB of the 8 KB of RTC slow memory
+
 void setup() {
   Serial.begin(9600);  // Move Serial.begin to top for debugging
   
@@ -231,14 +351,15 @@ void setup() {
     // We woke up from button press
     Serial.println("Waking from deep sleep");
     isPoweredOn = true;
-    
-    // Initialize display
     digitalWrite(TFT_LED, HIGH);
+    if (resumeSystem()) {
+      return;
+    }
+    
+    // No snapshot to carry on from: show the wake-up message and start over
     tft.init();
-    tft.setRotation(2);
+    tft.setRotation(SCREEN_ROTATION);
     tft.fillScreen(TFT_BLACK);
-    
-    // Show wake-up message
     tft.setTextColor(TFT_GREEN);
     tft.setTextSize(1);
     tft.setCursor((SCREEN_WIDTH - tft.textWidth("POWERING ON...")) / 2, SCREEN_HEIGHT/2);
@@ -252,42 +373,65 @@ void setup() {
     Serial.println("Normal power-on");
     isPoweredOn = true;
     digitalWrite(TFT_LED, HIGH);
+
+    // The button held at power-on asks for a benchmark run; it starts once the
+    // button is let go, so checkPowerButton() does not take it for a long press
+    if (digitalRead(BUTTON_PIN) == LOW) {
+      Serial.println("Benchmark: release the button to start");
+      while (digitalRead(BUTTON_PIN) == LOW) {
+        delay(10);
+      }
+      benchStart();
+    }
     initializeSystem();
   }
 }
 
-// Add this new function to handle system initialization
-void initializeSystem() {
+/**
+ * Brings up the display, the render target and the background tasks
+ */
+void initializeHardware() {
   tft.init();
-  tft.setRotation(2);
+  tft.setRotation(SCREEN_ROTATION);
   tft.fillScreen(TFT_BLACK);
+  initRenderTarget();
+  hudBegin();
+  simBegin();
+  mirrorBegin();
+  pinMode(POT_PIN, INPUT);
+}
+
+// Add this new function to handle system initialization
+void initializeSystem() {
+  initializeHardware();
   
   // Initialize potentiometer
-  pinMode(POT_PIN, INPUT);
-  randomSeed(analogRead(POT_PIN));
+  // A replay takes the recorded seed
+  uint32_t seed = traceBegin(benchRunning() ? BENCH_SEED : analogRead(POT_PIN) + 1);
+  rngBegin(seed);
+  potSamplerBegin(POT_PIN);
   
   // Draw intro screen
   drawIntroScreen();
+  rngBegin(seed); // However long the intro waited, the session starts from the seed alone
   
   // Initialize object tracking
   memset(objectsShown, false, sizeof(objectsShown));
   objectsRemaining = static_cast<int>(CelestialObject::NUM_TYPES);
   
-  // Initialize tracking variables
-  prevNebulaCount = 0;
-  prevGalaxyCoreRadius = 0;
-  for (int arm = 0; arm < MAX_GALAXY_ARMS; arm++) {
-    prevGalaxyPointCount[arm] = 0;
-  }
-  
   // Initialize stars
-  for (int i = 0; i < STAR_COUNT; i++) {
-    stars[i].x = random(0, SCREEN_WIDTH);
-    stars[i].y = random(0, SCREEN_HEIGHT);
-    stars[i].realX = static_cast<float>(stars[i].x);
-    stars[i].realY = static_cast<float>(stars[i].y);
-    stars[i].brightness = random(150, 256);
-    stars[i].increasing = random(0, 2);
+  memset(starLayerShift, 0, sizeof(starLayerShift));
+  starRng.fill(stars, STAR_COUNT, &Star::x, 0, SCREEN_WIDTH);
+  starRng.fill(stars, STAR_COUNT, &Star::y, 0, SCREEN_HEIGHT);
+  for (int i = 0, layer = 0, layerEnd = STAR_LAYER[0].count; i < STAR_COUNT; i++) {
+    if (i == layerEnd) layerEnd += STAR_LAYER[++layer].count;
+    stars[i].layer = layer;
+    stars[i].realX = FX_FROM_INT(stars[i].x);
+    stars[i].realY = FX_FROM_INT(stars[i].y);
+    stars[i].prevRealX = stars[i].realX;
+    stars[i].prevRealY = stars[i].realY;
+    stars[i].brightness = starRng.range(STAR_LAYER[layer].minBrightness, STAR_LAYER[layer].maxBrightness + 1);
+    stars[i].increasing = starRng.range(0, 2);
     stars[i].streakLength = 0;
     drawStar(stars[i]);
   }
@@ -296,6 +440,75 @@ void initializeSystem() {
   initShootingStars();
 }
 
+/**
+ * Wake path: picks the session up from the RTC snapshot, without the intro.
+ * Returns false if there is no snapshot, or a trace needs the full start.
+ */
+bool resumeSystem() {
+  if (rtcSnapshot.magic != SNAPSHOT_MAGIC || traceMode != TRACE_OFF) return false;
+  rtcSnapshot.magic = 0; // Used once; the next power-off writes a new one
+
+  initializeHardware();
+  potSamplerBegin(POT_PIN);
+
+  starRng.state = rtcSnapshot.rngState[0];
+  warpRng.state = rtcSnapshot.rngState[1];
+  discoveryRng.state = rtcSnapshot.rngState[2];
+  objectRng.state = rtcSnapshot.rngState[3];
+  memcpy(objectsShown, rtcSnapshot.objectsShown, sizeof(objectsShown));
+  objectsRemaining = rtcSnapshot.objectsRemaining;
+
+  starFrame = rtcSnapshot.starFrame;
+  for (int layer = 0; layer < STAR_LAYERS; layer++) {
+    starLayerShift[layer] = rtcSnapshot.starLayerShift[layer];
+  }
+  for (int i = 0, layer = 0, layerEnd = STAR_LAYER[0].count; i < STAR_COUNT; i++) {
+    if (i == layerEnd) layerEnd += STAR_LAYER[++layer].count;
+    const SnapshotStar& saved = rtcSnapshot.stars[i];
+    stars[i].layer = layer;
+    stars[i].x = saved.x;
+    stars[i].y = saved.y;
+    stars[i].realX = FX_FROM_INT(saved.x);
+    stars[i].realY = FX_FROM_INT(saved.y);
+    stars[i].prevRealX = stars[i].realX;
+    stars[i].prevRealY = stars[i].realY;
+    stars[i].brightness = saved.brightness;
+    stars[i].increasing = saved.increasing;
+    stars[i].streakLength = 0;
+    drawStar(stars[i]);
+  }
+  initShootingStars();
+
+  // A discovery comes back as open space: the knob decides what happens next
+  currentState = static_cast<State>(rtcSnapshot.state);
+  prevShouldWarp = currentState == State::WARP;
+  showingCelestialObject = false;
+
+  Serial.printf("Resumed from the RTC snapshot %lu ms after the wake-up\n", millis());
+  return true;
+}
+
+/**
+ * Saves what resumeSystem() needs into RTC memory, on the way into deep sleep
+ */
+void saveSnapshot() {
+  rtcSnapshot.rngState[0] = starRng.state;
+  rtcSnapshot.rngState[1] = warpRng.state;
+  rtcSnapshot.rngState[2] = discoveryRng.state;
+  rtcSnapshot.rngState[3] = objectRng.state;
+  memcpy(rtcSnapshot.objectsShown, objectsShown, sizeof(objectsShown));
+  rtcSnapshot.objectsRemaining = objectsRemaining;
+  rtcSnapshot.state = static_cast<uint8_t>(currentState);
+  rtcSnapshot.starFrame = starFrame;
+  for (int layer = 0; layer < STAR_LAYERS; layer++) {
+    rtcSnapshot.starLayerShift[layer] = starLayerShift[layer];
+  }
+  for (int i = 0; i < STAR_COUNT; i++) {
+    rtcSnapshot.stars[i] = {stars[i].x, stars[i].y, stars[i].brightness, stars[i].increasing};
+  }
+  rtcSnapshot.magic = SNAPSHOT_MAGIC;
+}
+
 void loop() {
   // Only process if powered on
   if (isPoweredOn) {
@@ -306,44 +519,62 @@ void loop() {
       return;
     }
     
-    unsigned long frameStart = millis();
+    unsigned long frameStartUs = micros();
+    frameClockTick();
+    pollSerialCommands();
+    if (benchStepBegins()) {
+      enterBenchStep(benchStep());
+    }
+    lodDetail = benchDetail(lodDetail);
+    int64_t profFrameStart = profNow();
     
-    readPotentiometer();
-    processInput();
+    {
+      PROF_SCOPE(PROF_READ_POT);
+      readPotentiometer();
+    }
+    {
+      PROF_SCOPE(PROF_INPUT);
+      processInput();
+    }
+    beginFrame();
     
     if (currentState == State::WARP) {
-      updateWarpStars();
+      PROF_SCOPE(PROF_WARP_STARS);
+      simRun(updateWarpStars);
     } else {
       // In NORMAL and DISCOVERY states
-      
-      // Static variable to stagger updates of different animations
-      // to distribute processing load across multiple frames
-      static int frameCounter = 0;
-      frameCounter++;
-      
-      // Update stars every frame in DISCOVERY state
-      if (currentState == State::DISCOVERY) {
-        updateStars(); // Ensure stars twinkle in discovery mode
-      } else if (frameCounter % 2 == 0) {
-        updateStars(); // Only update stars on even frames in NORMAL mode
+      {
+        PROF_SCOPE(PROF_STARS);
+        updateStars(); // Each layer paces its own drift and twinkle
+#if RENDER_FULL_REDRAW
+        drawStarfield(); // The back buffer starts empty, so every star is drawn each frame
+#endif
       }
       
       // Update shooting stars every frame as they are important for visual appeal
-      updateShootingStars();
+      {
+        PROF_SCOPE(PROF_SHOOTING_STARS);
+        updateShootingStars();
+      }
       
       // Only draw celestial objects if in discovery mode and object should be shown
       if (currentState == State::DISCOVERY && showingCelestialObject) {
         drawCelestialObject();
       }
-      
-      // Reset frame counter every 10 frames
-      if (frameCounter >= 10) {
-        frameCounter = 0;
-      }
     }
+
+    hudUpdateGauges(currentState == State::WARP, warpFactor, frameClock.deltaUs, frameClock.timeMs);
+    hudDraw();
+    {
+      PROF_SCOPE(PROF_PRESENT);
+      presentFrame();
+    }
+    profRecord(PROF_FRAME, profFrameStart);
+    profEndFrame();
+    mirrorFrame(static_cast<uint8_t>(currentState),
+                showingCelestialObject ? static_cast<uint8_t>(currentObject) : 0xFF, potValue);
     
     // Dynamic frame timing based on current state
-    unsigned long frameTime = millis() - frameStart;
     unsigned long targetFrameTime;
     
     // Adjust target frame time based on current state to optimize performance
@@ -354,9 +585,19 @@ void loop() {
     } else {
       targetFrameTime = TARGET_FRAME_MS + 10; // Lower framerate for standard starfield
     }
+
+    if (benchRecord(micros() - frameStartUs)) {
+      benchReport(CELESTIAL_OBJECT_NAMES);
+    }
+
+    // Trade detail for frame rate when the frame did not fit
+    lodUpdate(micros() - frameStartUs, targetFrameTime * 1000);
+    lodDetail = traceDetail(lodDetail); // A replay repeats the recorded choices
+    powerUpdate(micros() - frameStartUs, targetFrameTime * 1000, currentState == State::WARP || benchRunning());
     
-    if (frameTime < targetFrameTime) {
-      delay(targetFrameTime - frameTime);
+    {
+      PROF_SCOPE(PROF_FRAME_DELAY);
+      powerSleep(targetFrameTime);
     }
   } else {
     // When powered off, only check for button press
@@ -365,32 +606,77 @@ void loop() {
   }
 }
 
+/**
+ * Handles single-character commands on the serial port
+ */
+void pollSerialCommands() {
+  while (Serial.available() > 0) {
+    switch (Serial.read()) {
+      case 'p': profDump(CELESTIAL_OBJECT_NAMES); break; // Profile, see profiler.h
+      case 't': traceDump(); break;                      // Input trace, see trace.h
+      case 'b': benchStart(); break;                     // Benchmark run, see bench.h
+    }
+  }
+}
+
+/**
+ * Sets up a benchmark step: warp, or a discovery the way processInput() makes
+ * one, of a fixed object at the centre and one end of its scale range
+ */
+void enterBenchStep(const BenchStep& step) {
+  simStop();
+  if (currentState == State::DISCOVERY && showingCelestialObject) {
+    eraseCelestialObject();
+  }
+  showingCelestialObject = false;
+  rngBegin(BENCH_SEED);
+
+  if (step.warp) {
+    currentState = State::WARP;
+    prevShouldWarp = true;
+    return;
+  }
+  currentState = State::DISCOVERY;
+  prevShouldWarp = false;
+  currentObject = static_cast<CelestialObject>(step.object);
+  discoveryStartTime = millis();
+  objectX = SCREEN_WIDTH / 2;
+  objectY = SCREEN_HEIGHT / 2;
+  if (currentObject == CelestialObject::BLACK_HOLE) {
+    objectScale = (step.largest ? 1.8f : 1.0f) * PANEL_SCALE;
+  } else {
+    objectScale = (step.largest ? 2.4f : 1.2f) * PANEL_SCALE;
+  }
+  arenaReset();
+  const CelestialRenderer& renderer = CELESTIAL_RENDERERS[step.object];
+  if (renderer.init) renderer.init();
+  showingCelestialObject = true;
+}
+
 void readPotentiometer() {
-  // Take multiple readings for stability
-  int rawValue = 0;
-  const int numReadings = 4;
-  
-  for (int i = 0; i < numReadings; i++) {
-    // Invert the reading (4095 - value) to reverse the potentiometer direction
-    rawValue += 4095 - analogRead(POT_PIN);
+  // The sampler timer normally keeps potValue up to date; without it, feed the filter here
+  if (!potSamplerRunning) {
+    for (int i = 0; i < POT_OVERSAMPLE; i++) {
+      potFilterSample(analogRead(POT_PIN));
+    }
   }
-  
-  // Average the readings and store in potValue (0-4095 range for 12-bit ADC)
-  potValue = rawValue / numReadings;
-  
-  // Debug output
-  Serial.print("rawValue: ");
-  Serial.print(rawValue);
-  Serial.print(", potValue: ");
-  Serial.println(potValue);
+
+  DEBUG_LOG(DEBUG_FRAMES, "potValue: %d\n", potValue.load(std::memory_order_relaxed));
 }
 
 void processInput() {
   // Scale from 0-4095 to 0-1.0 for 12-bit ADC
-  float rawWarpFactor = static_cast<float>(potValue) / 4095.0f;
+  int pot = benchPot(tracePot(potValue.load(std::memory_order_relaxed)));
+  float rawWarpFactor = static_cast<float>(pot) / 4095.0f;
   warpFactor = easeInOutCubic(rawWarpFactor);
-  // Use a more precise threshold for 12-bit ADC (about 2.5% of full scale)
-  bool shouldWarp = (potValue > 100);
+  // Use a more precise threshold for 12-bit ADC (about 2.5% of full scale),
+  // with some hysteresis so a knob resting on it does not flip states
+  bool shouldWarp = prevShouldWarp ? (pot > 100 - POT_WARP_HYSTERESIS) : (pot > 100 + POT_WARP_HYSTERESIS);
+
+  if (shouldWarp != prevShouldWarp) {
+    simStop(); // The animation that was running is about to be erased or replaced
+    beginCrossfade();
+  }
 
   if (shouldWarp && !prevShouldWarp) {
     // Transition to WARP, erase celestial object if in DISCOVERY
@@ -404,7 +690,7 @@ void processInput() {
     currentState = State::DISCOVERY;
 
     // 3/5 probability to show celestial object (increased chance)
-    showingCelestialObject = (random(5) < 4);
+    showingCelestialObject = (discoveryRng.below(5) < 4);
 
     if (showingCelestialObject) {
       // Check if we need to reset our tracking (all objects have been shown)
@@ -419,7 +705,7 @@ void processInput() {
       if (objectsRemaining > 0) {
         // Find an object that hasn't been shown yet
         do {
-          objectIndex = random(0, static_cast<int>(CelestialObject::NUM_TYPES));
+          objectIndex = discoveryRng.range(0, static_cast<int>(CelestialObject::NUM_TYPES));
         } while (objectsShown[objectIndex]);
 
         // Mark this object as shown
@@ -427,7 +713,7 @@ void processInput() {
         objectsRemaining--;
       } else {
         // Fallback (shouldn't happen due to the reset above)
-        objectIndex = random(0, static_cast<int>(CelestialObject::NUM_TYPES));
+        objectIndex = discoveryRng.range(0, static_cast<int>(CelestialObject::NUM_TYPES));
       }
 
       // Set the current object
@@ -438,26 +724,38 @@ void processInput() {
       // Check if the selected object is a Black Hole
       if (currentObject == CelestialObject::BLACK_HOLE) {
         // Set position near the center with a small random offset
-        int centerOffsetX = random(-8, 9); // Offset from -8 to +8 pixels
-        int centerOffsetY = random(-8, 9); // Offset from -8 to +8 pixels
+        const int maxOffset = 8 * PANEL_SCALE; // 8 pixels on a 128 pixel panel
+        int centerOffsetX = discoveryRng.range(-maxOffset, maxOffset + 1);
+        int centerOffsetY = discoveryRng.range(-maxOffset, maxOffset + 1);
         objectX = SCREEN_WIDTH / 2 + centerOffsetX;
         objectY = SCREEN_HEIGHT / 2 + centerOffsetY;
         // Optional: You might want a slightly larger scale for black holes
-        objectScale = random(100, 180) / 100.0f; // Scale 1.8 to 2.8
-        Serial.printf("Black Hole selected! Position: (%d, %d), Scale: %.2f\n", objectX, objectY, objectScale); // Debug print
+        objectScale = discoveryRng.range(100, 180) / 100.0f * PANEL_SCALE; // Scale 1.0 to 1.8 on a 128 pixel panel
+        DEBUG_LOG(DEBUG_EVENTS, "Black Hole selected! Position: (%d, %d), Scale: %.2f\n", objectX, objectY, objectScale);
       } else {
         // Default random positioning for all other objects
-        objectX = random(20, SCREEN_WIDTH - 20);
-        objectY = random(20, SCREEN_HEIGHT - 20);
+        const int margin = 20 * PANEL_SCALE;
+        objectX = discoveryRng.range(margin, SCREEN_WIDTH - margin);
+        objectY = discoveryRng.range(margin, SCREEN_HEIGHT - margin);
         // Use the standard scale range for other objects
-        objectScale = random(120, 240) / 100.0f; // Scale 1.2 to 2.4
-        Serial.printf("Object %d selected. Position: (%d, %d), Scale: %.2f\n", (int)currentObject, objectX, objectY, objectScale); // Debug print
+        objectScale = discoveryRng.range(120, 240) / 100.0f * PANEL_SCALE; // Scale 1.2 to 2.4 on a 128 pixel panel
+        DEBUG_LOG(DEBUG_EVENTS, "Object %d selected. Position: (%d, %d), Scale: %.2f\n", (int)currentObject, objectX, objectY, objectScale);
       }
       // *** MODIFICATION END ***
 
+      // The last object's sim job was stopped above, so its state can be reused.
+      // Its stream restarts too, so each discovery looks the same on a replay.
+      objectRng.seed(discoveryRng.next());
+      arenaReset();
+      const CelestialRenderer& renderer = CELESTIAL_RENDERERS[objectIndex];
+      if (renderer.init) renderer.init();
+      if (renderer.detailBudget) {
+        DEBUG_LOG(DEBUG_EVENTS, "%s: budget %d at detail %d\n", renderer.label, renderer.detailBudget(lodDetail), lodDetail);
+      }
+
     } else {
        // No object selected this time
-       Serial.println("No celestial object selected this cycle.");
+       DEBUG_LOG(DEBUG_EVENTS, "No celestial object selected this cycle.\n");
     }
   } else if (currentState == State::DISCOVERY && !showingCelestialObject) {
     // If we are in DISCOVERY state but not showing an object (e.g., due to probability roll),
@@ -474,23 +772,117 @@ void processInput() {
 }
 
 /**
- * Updates and renders stars in normal mode (non-warp)
- * This creates a gentle twinkling effect by randomly adjusting star brightness
+ * Updates and renders stars in normal mode (non-warp).
+ * Each layer drifts left at its own speed, so a far layer only moves every
+ * second or so, and a slice of each layer takes a twinkle step per call.
+ * Stars are only drawn again when they moved or their color changed.
  */
 void updateStars() {
-  for (int i = 0; i < STAR_COUNT; i++) {
-    if (random(0, 20) == 0) { // 20% chance to update per frame
-      tft.drawPixel(stars[i].x, stars[i].y, BG_COLOR);
-      int delta = random(1, 3);
+  int count = starDetailBudget(lodDetail);
+#if !RENDER_FULL_REDRAW
+  // Stars dropped by the detail level go dark, stars brought back are lit again
+  for (int i = count; i < activeStars; i++) {
+    canvas.drawPixel(stars[i].x, stars[i].y, BG_COLOR);
+  }
+  for (int i = activeStars; i < count; i++) {
+    drawStar(stars[i]);
+  }
+#endif
+  activeStars = count;
+  starFrame++;
+
+  for (int layer = 0, first = 0; layer < STAR_LAYERS; first += STAR_LAYER[layer++].count) {
+    const StarLayer& depth = STAR_LAYER[layer];
+    int last = min(first + (int)depth.count, activeStars);
+
+    // Drift, in whole pixels; the layer is erased before it is drawn so its stars cannot clip each other
+    int shift = (uint64_t)frameClock.timeMs * depth.driftPer10s / 10000 % SCREEN_WIDTH;
+    int moved = (shift - starLayerShift[layer] + SCREEN_WIDTH) % SCREEN_WIDTH;
+    starLayerShift[layer] = shift;
+    if (moved) {
+#if !RENDER_FULL_REDRAW
+      for (int i = first; i < last; i++) {
+        canvas.drawPixel(stars[i].x, stars[i].y, BG_COLOR);
+      }
+#endif
+      for (int i = first; i < last; i++) {
+        stars[i].x = (stars[i].x + SCREEN_WIDTH - moved) % SCREEN_WIDTH;
+        stars[i].realX = stars[i].prevRealX = FX_FROM_INT(stars[i].x);
+      }
+    }
+
+    // Twinkle one star in every twinkleEvery, a different slice each call
+    for (int i = first + starFrame % depth.twinkleEvery; i < last; i += depth.twinkleEvery) {
+      uint16_t before = PAL_GREY.v[stars[i].brightness];
+      int delta = 1 + ((i ^ starFrame) & 1);
       if (stars[i].increasing) {
-        stars[i].brightness = min(stars[i].brightness + delta, 255);
-        if (stars[i].brightness == 255) stars[i].increasing = false;
+        stars[i].brightness = min(stars[i].brightness + delta, (int)depth.maxBrightness);
+        if (stars[i].brightness == depth.maxBrightness) stars[i].increasing = false;
       } else {
-        stars[i].brightness = max(stars[i].brightness - delta, 150);
-        if (stars[i].brightness == 150) stars[i].increasing = true;
+        stars[i].brightness = max(stars[i].brightness - delta, (int)depth.minBrightness);
+        if (stars[i].brightness == depth.minBrightness) stars[i].increasing = true;
+      }
+#if !RENDER_FULL_REDRAW
+      if (!moved && PAL_GREY.v[stars[i].brightness] != before) {
+        drawStar(stars[i]); // Same pixel, no erase needed
+      }
+#endif
+    }
+
+#if !RENDER_FULL_REDRAW
+    if (moved) {
+      for (int i = first; i < last; i++) {
+        drawStar(stars[i]);
       }
-      drawStar(stars[i]);
     }
+#endif
+  }
+}
+
+/**
+ * updateStars() while the intro screen waits. The intro is drawn straight on
+ * the panel, and no frame is presented until it is gone: the buffered modes
+ * only draw stars into the next frame, so the stars that changed are drawn
+ * on tft here, and direct mode flushes its pixel batch.
+ */
+void updateIntroStars() {
+#if RENDER_FULL_REDRAW
+  screen_coord shownX[STAR_COUNT];
+  uint8_t shownBrightness[STAR_COUNT];
+  for (int i = 0; i < activeStars; i++) {
+    shownX[i] = stars[i].x;
+    shownBrightness[i] = stars[i].brightness;
+  }
+  int shown = activeStars;
+  updateStars();
+  for (int i = 0; i < activeStars; i++) {
+    bool known = i < shown;
+    if (known && stars[i].x == shownX[i] && PAL_GREY.v[stars[i].brightness] == PAL_GREY.v[shownBrightness[i]]) continue;
+    if (known && stars[i].x != shownX[i]) tft.drawPixel(shownX[i], stars[i].y, BG_COLOR);
+    tft.drawPixel(stars[i].x, stars[i].y, PAL_GREY.v[stars[i].brightness]);
+  }
+  for (int i = activeStars; i < shown; i++) {
+    tft.drawPixel(shownX[i], stars[i].y, BG_COLOR);
+  }
+#else
+  updateStars();
+  presentFrame(); // Flushes the pixel batch
+#endif
+}
+
+/**
+ * Starfield stars to animate at a detail level (see lod.h)
+ */
+int starDetailBudget(uint8_t detail) {
+  return lodBudget(detail, MIN_STAR_COUNT, STAR_COUNT);
+}
+
+/**
+ * Draws every star of the normal-mode starfield at its current brightness
+ */
+void drawStarfield() {
+  for (int i = 0; i < activeStars; i++) {
+    drawStar(stars[i]);
   }
 }
 
@@ -499,76 +891,102 @@ void updateStars() {
  */
 // Implementation moved to star.h
 
+/**
+ * Moves a warp star by one simulation step.
+ * Stars move faster when further from center.
+ */
+void stepWarpStar(Star& star, q16_16 warp, q16_16 minSpeed) {
+  const q16_16 centerX = FX_FROM_INT(SCREEN_WIDTH) / 2;
+  const q16_16 centerY = FX_FROM_INT(SCREEN_HEIGHT) / 2;
+
+  q16_16 dx = star.realX - centerX;
+  q16_16 dy = star.realY - centerY;
+  q16_16 dirX, dirY;
+  q16_16 distance = fxNormalize(dx, dy, dirX, dirY);
+
+  // Far layers move slower, for parallax
+  const q16_16 depth = STAR_LAYER[star.layer].depth;
+  q16_16 speed = fxMul(distance / 10 + FX_ONE, warp) * 3;
+  speed = fxMul(max(speed, minSpeed), depth);
+
+  star.prevRealX = star.realX;
+  star.prevRealY = star.realY;
+  star.realX += fxMul(dirX, speed);
+  star.realY += fxMul(dirY, speed);
+
+  // Reset stars that move off screen back to a position near center
+  int newX = fxRound(star.realX);
+  int newY = fxRound(star.realY);
+  if (newX < 0 || newX >= SCREEN_WIDTH || newY < 0 || newY >= SCREEN_HEIGHT) {
+    star.realX = centerX + FX_FROM_INT(warpRng.range(-(SCREEN_WIDTH / 2 - 2), SCREEN_WIDTH / 2 - 1));
+    star.realY = centerY + FX_FROM_INT(warpRng.range(-(SCREEN_HEIGHT / 2 - 2), SCREEN_HEIGHT / 2 - 1));
+    star.prevRealX = star.realX; // Nothing to interpolate across the jump
+    star.prevRealY = star.realY;
+    star.brightness = warpRng.range(STAR_LAYER[star.layer].minBrightness, STAR_LAYER[star.layer].maxBrightness + 1);
+  }
+  star.x = fxRound(star.realX);
+  star.y = fxRound(star.realY);
+}
+
 /**
  * Updates and renders stars in warp mode
  * Creates the iconic Star Trek warp effect with stars stretching based on distance from center
  */
 void updateWarpStars() {
-  const float centerX = SCREEN_WIDTH / 2.0f;
-  const float centerY = SCREEN_HEIGHT / 2.0f;
+  const q16_16 centerX = FX_FROM_INT(SCREEN_WIDTH) / 2;
+  const q16_16 centerY = FX_FROM_INT(SCREEN_HEIGHT) / 2;
 
+#if !RENDER_FULL_REDRAW
   // First, clear previous streaks
-  for (int i = 0; i < STAR_COUNT; i++) {
-    for (int j = 0; j <= stars[i].streakLength; j++) {
-      if (prevX[i][j] < SCREEN_WIDTH && prevY[i][j] < SCREEN_HEIGHT) {
-        tft.drawPixel(prevX[i][j], prevY[i][j], BG_COLOR);
-      }
-    }
+  for (int i = 0; i < activeWarpStars; i++) {
+    const StreakEnds& prev = prevStreaks[i];
+    simEraseStreak(prev.headX, prev.headY, prev.tailX, prev.tailY, BG_COLOR);
   }
+#endif
+  int backdropStars = starDetailBudget(simInputs.detail);
+  activeWarpStars = min(backdropStars, WARP_STAR_COUNT);
 
-  // Then draw new streaks and update positions
-  for (int i = 0; i < STAR_COUNT; i++) {
-    // Calculate direction vector from center
-    float dx = stars[i].realX - centerX;
-    float dy = stars[i].realY - centerY;
-    float distance = sqrtf(dx * dx + dy * dy);
-    if (distance < 1.0f) distance = 1.0f;
-
-    float dirX = dx / distance;
-    float dirY = dy / distance;
+  // The far layer is too distant to move; drawn again in case a streak was erased across it
+  for (int i = activeWarpStars; i < backdropStars; i++) {
+    simCanvas.drawPixel(stars[i].x, stars[i].y, PAL_GREY.v[stars[i].brightness]);
+  }
 
-    // Calculate streak length based on warp factor and distance
-    int streakLength = static_cast<int>(warpFactor * min(distance / 2.0f, static_cast<float>(MAX_STREAK_LENGTH)));
-    stars[i].streakLength = streakLength;
-    
-    // Draw the streak
-    for (int j = 0; j <= streakLength; j++) {
-      int streakX = roundf(stars[i].realX + dirX * j);
-      int streakY = roundf(stars[i].realY + dirY * j);
-      if (j <= MAX_STREAK_LENGTH) {
-        prevX[i][j] = streakX;
-        prevY[i][j] = streakY;
-      }
-      if (streakX >= 0 && streakX < SCREEN_WIDTH && streakY >= 0 && streakY < SCREEN_HEIGHT) {
-        // Fade intensity based on position in streak
-        uint8_t intensity = (streakLength > 0) ? (stars[i].brightness * (streakLength - j) / streakLength) : stars[i].brightness;
-        uint16_t color = tft.color565(intensity, intensity, intensity);
-        tft.drawPixel(streakX, streakY, color);
-      }
+  // Then step the positions and draw the new streaks
+  const FrameTime& clock = simInputs.clock;
+  const q16_16 warp = fxFromFloat(simInputs.warpFactor);
+  const q16_16 minSpeed = fxMul(FX_CONST(MIN_WARP_SPEED * 5.0f), warp);
+  for (int i = 0; i < activeWarpStars; i++) {
+    for (int step = 0; step < clock.steps; step++) {
+      stepWarpStar(stars[i], warp, minSpeed);
     }
 
-    // Update star position - stars move faster when further from center
-    float speed = (distance / 10.0f + 1.0f) * warpFactor * 3.0f;
-    speed = max(speed, MIN_WARP_SPEED * warpFactor * 5.0f);
+    // Draw where the star is between its last two steps
+    q16_16 starX = frameLerp(stars[i].prevRealX, stars[i].realX, clock.alpha);
+    q16_16 starY = frameLerp(stars[i].prevRealY, stars[i].realY, clock.alpha);
 
-    stars[i].realX += dirX * speed;
-    stars[i].realY += dirY * speed;
-
-    // Convert to integer positions
-    int newX = roundf(stars[i].realX);
-    int newY = roundf(stars[i].realY);
-
-    // Reset stars that move off screen back to a position near center
-    if (newX < 0 || newX >= SCREEN_WIDTH || newY < 0 || newY >= SCREEN_HEIGHT) {
-      stars[i].realX = centerX + random(-62, 63);
-      stars[i].realY = centerY + random(-62, 63);
-      stars[i].x = roundf(stars[i].realX);
-      stars[i].y = roundf(stars[i].realY);
-      stars[i].brightness = random(150, 256);
-    } else {
-      stars[i].x = newX;
-      stars[i].y = newY;
-    }
+    // Calculate direction vector from center
+    q16_16 dx = starX - centerX;
+    q16_16 dy = starY - centerY;
+    q16_16 dirX, dirY;
+    q16_16 distance = fxNormalize(dx, dy, dirX, dirY);
+
+    // Calculate streak length based on warp factor, distance and depth
+    q16_16 reach = fxMul(min(distance / 2, (q16_16)FX_FROM_INT(MAX_STREAK_LENGTH)), STAR_LAYER[stars[i].layer].depth);
+    int streakLength = fxMul(warp, reach) >> FX_SHIFT;
+    stars[i].streakLength = streakLength;
+    
+    // Draw the streak outwards from the star, fading towards its tail
+    int headX = fxRound(starX);
+    int headY = fxRound(starY);
+    int tailX = fxRound(starX + dirX * streakLength);
+    int tailY = fxRound(starY + dirY * streakLength);
+    simDrawStreak(headX, headY, tailX, tailY, stars[i].brightness);
+#if !RENDER_FULL_REDRAW
+    prevStreaks[i].headX = headX;
+    prevStreaks[i].headY = headY;
+    prevStreaks[i].tailX = tailX;
+    prevStreaks[i].tailY = tailY;
+#endif
   }
 }
 
@@ -586,47 +1004,47 @@ void initShootingStars() {
  * Randomly creates new shooting stars and manages their lifespan
  */
 void updateShootingStars() {
-  unsigned long currentTime = millis();
+  unsigned long currentTime = frameClock.timeMs;
   
   // Randomly create new shooting stars
-  if (random(100) < 1) { // 2% chance per frame
+  if (starRng.below(100) < 1) { // 2% chance per frame
     for (int i = 0; i < MAX_SHOOTING_STARS; i++) {
       if (!shootingStars[i].active) {
         shootingStars[i].active = true;
         shootingStars[i].startTime = currentTime;
-        shootingStars[i].lifetime = random(500, 1500);
+        shootingStars[i].lifetime = starRng.range(500, 1500);
         
         // Randomly choose one of four screen edges to start from
-        int edge = random(4);
+        int edge = starRng.below(4);
         switch (edge) {
           case 0: // top
-            shootingStars[i].x = random(SCREEN_WIDTH);
+            shootingStars[i].x = starRng.below(SCREEN_WIDTH);
             shootingStars[i].y = 0;
             break;
           case 1: // right
             shootingStars[i].x = SCREEN_WIDTH - 1;
-            shootingStars[i].y = random(SCREEN_HEIGHT);
+            shootingStars[i].y = starRng.below(SCREEN_HEIGHT);
             break;
           case 2: // bottom
-            shootingStars[i].x = random(SCREEN_WIDTH);
+            shootingStars[i].x = starRng.below(SCREEN_WIDTH);
             shootingStars[i].y = SCREEN_HEIGHT - 1;
             break;
           case 3: // left
             shootingStars[i].x = 0;
-            shootingStars[i].y = random(SCREEN_HEIGHT);
+            shootingStars[i].y = starRng.below(SCREEN_HEIGHT);
             break;
         }
         
         // Set target to somewhere near center with randomness
-        float targetX = SCREEN_WIDTH / 2 + random(-20, 21);
-        float targetY = SCREEN_HEIGHT / 2 + random(-20, 21);
+        float targetX = SCREEN_WIDTH / 2 + starRng.range(-20, 21);
+        float targetY = SCREEN_HEIGHT / 2 + starRng.range(-20, 21);
         float dx = targetX - shootingStars[i].x;
         float dy = targetY - shootingStars[i].y;
         float dist = sqrt(dx*dx + dy*dy);
-        float speed = random(2, 5) + random(0, 100) / 100.0f;
+        float speed = starRng.range(2, 5) + starRng.range(0, 100) / 100.0f;
         shootingStars[i].vx = dx / dist * speed;
         shootingStars[i].vy = dy / dist * speed;
-        shootingStars[i].length = random(5, 15);
+        shootingStars[i].length = starRng.range(5, 15);
         
         break;
       }
@@ -636,6 +1054,7 @@ void updateShootingStars() {
   // Update and draw active shooting stars
   for (int i = 0; i < MAX_SHOOTING_STARS; i++) {
     if (shootingStars[i].active) {
+#if !RENDER_FULL_REDRAW
       // Erase previous position
       float oldX = shootingStars[i].x;
       float oldY = shootingStars[i].y;
@@ -643,13 +1062,14 @@ void updateShootingStars() {
         float trailX = oldX - j * shootingStars[i].vx / 2;
         float trailY = oldY - j * shootingStars[i].vy / 2;
         if (trailX >= 0 && trailX < SCREEN_WIDTH && trailY >= 0 && trailY < SCREEN_HEIGHT) {
-          tft.drawPixel(trailX, trailY, BG_COLOR);
+          canvas.drawPixel(trailX, trailY, BG_COLOR);
         }
       }
+#endif
       
-      // Update position
-      shootingStars[i].x += shootingStars[i].vx;
-      shootingStars[i].y += shootingStars[i].vy;
+      // Update position, velocities are per simulation step
+      shootingStars[i].x += shootingStars[i].vx * frameClock.steps;
+      shootingStars[i].y += shootingStars[i].vy * frameClock.steps;
       
       // Check if it's off screen or expired
       if (shootingStars[i].x < 0 || shootingStars[i].x >= SCREEN_WIDTH ||
@@ -677,8 +1097,7 @@ void drawShootingStar(int index) {
     float trailY = star.y - j * star.vy / 2;
     if (trailX >= 0 && trailX < SCREEN_WIDTH && trailY >= 0 && trailY < SCREEN_HEIGHT) {
       uint8_t brightness = map(j, 0, star.length - 1, 255, 50);
-      uint16_t color = tft.color565(brightness, brightness, brightness);
-      tft.drawPixel(trailX, trailY, color);
+      canvas.drawPixel(trailX, trailY, PAL_GREY.v[brightness]);
     }
   }
 }
@@ -687,155 +1106,42 @@ void drawShootingStar(int index) {
  * Selects and draws the appropriate celestial object based on current selection
  */
 void drawCelestialObject() {
-  switch (currentObject) {
-    case CelestialObject::STAR:
-      drawStar();
-      displayObjectName("STAR");
-      break;
-    case CelestialObject::PLANET:
-      drawPlanet();
-      displayObjectName("PLANET");
-      break;
-    case CelestialObject::NEBULA:
-      drawNebula();
-      displayObjectName("NEBULA");
-      break;
-    case CelestialObject::GALAXY:
-      drawGalaxy();
-      displayObjectName("GALAXY");
-      break;
-    case CelestialObject::SOLAR_SYSTEM:
-      drawSolarSystem();
-      displayObjectName("SOLAR SYSTEM");
-      break;
-    case CelestialObject::ASTEROID_FIELD:
-      drawAsteroidField();
-      displayObjectName("ASTEROID FIELD");
-      break;
-    case CelestialObject::BLACK_HOLE:
-      drawBlackHole();
-      displayObjectName("BLACK HOLE");
-      break;
-    case CelestialObject::PULSAR:
-      drawPulsar();
-      displayObjectName("PULSAR");
-      break;
-    case CelestialObject::SUPERNOVA:
-      drawSupernova();
-      displayObjectName("SUPERNOVA");
-      break;
-    case CelestialObject::COMET:
-      drawComet();
-      displayObjectName("COMET");
-      break;
-    case CelestialObject::BINARY_STAR:
-      drawBinaryStar();
-      displayObjectName("BINARY STAR");
-      break;
-    case CelestialObject::SPACE_STATION:
-      drawSpaceStation();
-      displayObjectName("SPACE STATION");
-      break;
-    default:
-      break;
+  PROF_SCOPE(PROF_OBJECT_DRAW + static_cast<int>(currentObject));
+  const CelestialRenderer& renderer = CELESTIAL_RENDERERS[static_cast<int>(currentObject)];
+  if (renderer.simCore) {
+    simRun(renderer.draw);
+  } else {
+    renderer.draw();
   }
-}
-
-/**
- * Displays the name of the celestial object at the bottom of the screen
- */
-void displayObjectName(const char* name) {
-  // Clear the bottom text area first
- // tft.fillRect(0, SCREEN_HEIGHT - 10, SCREEN_WIDTH, 10, BG_COLOR);
-  
-  // Set text properties
-  tft.setTextSize(1);
-  tft.setTextColor(TFT_GREEN);
-  
-  // Center the text
-  int16_t x1, y1;
-  uint16_t w, h;
-  // tft.getTextBounds(name, 0, 0, &x1, &y1, &w, &h); // Removed getTextBounds
-  w = tft.textWidth(name); // Use textWidth instead
-  h = 8; // Manually set height based on font size (assuming font size 1)
-  int x = (SCREEN_WIDTH - w) / 2;
-  
-  // Draw the text at the bottom of the screen
-  tft.setCursor(x, SCREEN_HEIGHT - 10);
-  tft.print(name);
+  // The name at the bottom of the screen; only rendered when it changes, hudDraw() shows it
+  hudSetText(HUD_LABEL, renderer.label, TFT_GREEN);
 }
 
 void eraseCelestialObject() {
+  PROF_SCOPE(PROF_OBJECT_ERASE + static_cast<int>(currentObject));
 
-  // Display a message indicating the object is being erased
-  tft.fillRect(0, SCREEN_HEIGHT - 10, SCREEN_WIDTH, 10, BG_COLOR); // Clear previous message
-    
-
-  switch (currentObject) {
-    case CelestialObject::STAR:
-      eraseStar();
-      break;
-    case CelestialObject::PLANET:
-      erasePlanet();
-      break;
-    case CelestialObject::NEBULA:
-      eraseNebula();
-      break;
-    case CelestialObject::GALAXY:
-      eraseGalaxy();
-      break;
-    case CelestialObject::SOLAR_SYSTEM:
-      eraseSolarSystem();
-      break;
-    case CelestialObject::ASTEROID_FIELD:
-      eraseAsteroidField();
-      asteroidFieldInitialized = false;
-      break;
-    case CelestialObject::BLACK_HOLE:
-      eraseBlackHole();
-      break;
-    case CelestialObject::PULSAR:
-      erasePulsar();
-      break;
-    case CelestialObject::SUPERNOVA:
-      eraseSupernova();
-      break;
-    case CelestialObject::COMET:
-      eraseComet();
-      break;
-    case CelestialObject::BINARY_STAR:
-      eraseBinaryStar();
-      break;
-    case CelestialObject::SPACE_STATION:
-      eraseSpaceStation();
-      break;
-  }
-
+  hudHide(HUD_LABEL); // hudDraw() clears it from the panel in direct mode
+  CELESTIAL_RENDERERS[static_cast<int>(currentObject)].erase();
 }
 
 void eraseGalaxy() {
+#if !RENDER_FULL_REDRAW
   if (prevGalaxyCoreRadius > 0) {
     // Clear the core with extra pixels to catch any glow effects
-    tft.fillCircle(prevGalaxyCenterX, prevGalaxyCenterY, prevGalaxyCoreRadius + 1, BG_COLOR);
+    canvasFillCircle(prevGalaxyCenterX, prevGalaxyCenterY, prevGalaxyCoreRadius + 1, BG_COLOR);
   }
   
   // Clear all star points in galaxy arms
-  for (int arm = 0; arm < MAX_GALAXY_ARMS; arm++) {
-    for (int i = 0; i < prevGalaxyPointCount[arm]; i++) {
-      int x = prevGalaxyPoints[arm][i][0];
-      int y = prevGalaxyPoints[arm][i][1];
-      if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-        // Clear the pixel and surrounding pixels to catch any bloom effects
-        tft.drawPixel(x, y, BG_COLOR);
-        if (x > 0) tft.drawPixel(x-1, y, BG_COLOR);
-        if (x < SCREEN_WIDTH-1) tft.drawPixel(x+1, y, BG_COLOR);
-        if (y > 0) tft.drawPixel(x, y-1, BG_COLOR);
-        if (y < SCREEN_HEIGHT-1) tft.drawPixel(x, y+1, BG_COLOR);
+  if (galaxyShown) {
+    for (int i = 0; i < MAX_GALAXY_ARMS * MAX_GALAXY_POINTS; i++) {
+      if (galaxyShown[i].x != SCREEN_NO_COORD) {
+        canvas.drawPixel(galaxyShown[i].x, galaxyShown[i].y, BG_COLOR);
+        galaxyShown[i].x = SCREEN_NO_COORD;
       }
     }
-    prevGalaxyPointCount[arm] = 0;
   }
   prevGalaxyCoreRadius = 0;
+#endif
 }
 
 
@@ -854,22 +1160,71 @@ struct FlareParticle {
 };
 
 #define MAX_FLARE_PARTICLES 15
-FlareParticle flareParticles[MAX_FLARE_PARTICLES];
+FlareParticle* flareParticles = nullptr; // MAX_FLARE_PARTICLES from the object arena
 bool solarSystemInitialized = false; // Flag for initialization
 
+// Faint backdrop stars picked when the solar system is initialized
+#define SOLAR_SYSTEM_STARS 20
+Point* solarSystemStars = nullptr; // SOLAR_SYSTEM_STARS from the object arena
+uint16_t* solarSystemStarColors = nullptr;
+
+#define SOLAR_SYSTEM_ARENA_BYTES (ARENA_SIZE(FlareParticle, MAX_FLARE_PARTICLES) + \
+                                  ARENA_SIZE(Point, SOLAR_SYSTEM_STARS) + ARENA_SIZE(uint16_t, SOLAR_SYSTEM_STARS))
+
+/**
+ * Takes the flares and backdrop stars from the object arena
+ */
+void initSolarSystem() {
+  flareParticles = arenaAlloc<FlareParticle>(MAX_FLARE_PARTICLES);
+  solarSystemStars = arenaAlloc<Point>(SOLAR_SYSTEM_STARS);
+  solarSystemStarColors = arenaAlloc<uint16_t>(SOLAR_SYSTEM_STARS);
+  solarSystemInitialized = false;
+}
+
+/**
+ * Draws the static part of the solar system: backdrop stars, sun with corona and orbit paths
+ */
+void drawSolarSystemBackdrop(int centerX, int centerY, int sunRadius, const int orbitRadii[]) {
+    for (int i = 0; i < SOLAR_SYSTEM_STARS; i++) {
+        canvas.drawPixel(solarSystemStars[i].x, solarSystemStars[i].y, solarSystemStarColors[i]);
+    }
+
+    // Draw sun with corona
+    for (int r = sunRadius + 2; r > sunRadius; r--) {
+        uint8_t brightness = map(r, sunRadius, sunRadius + 2, 255, 100);
+        uint16_t coronaColor = canvas.color565(brightness, brightness, 0);
+        canvasDrawCircle(centerX, centerY, r, coronaColor);
+    }
+    canvasFillCircle(centerX, centerY, sunRadius, TFT_YELLOW);
+
+    // Draw faint orbit paths (static)
+    for (int i = 0; i < 4; i++) {
+        int orbitRadius = orbitRadii[i] * objectScale;
+        for (int j = 0; j < 360; j += 5) { // Increase step for performance
+            float angle = j * PI / 180.0f;
+            int x = centerX + orbitRadius * cos(angle);
+            int y = centerY + orbitRadius * sin(angle);
+            if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
+                canvas.drawPixel(x, y, canvas.color565(20, 20, 20));
+            }
+        }
+        prevOrbitRadii[i] = orbitRadius;
+    }
+}
+
 void drawSolarSystem() {
     int centerX = objectX;
     int centerY = objectY;
     int sunRadius = 10 * objectScale;
-    float t = millis() / 1000.0f;
+    float t = frameClock.timeMs / 1000.0f;
 
     // Planet parameters
     float speeds[] = {0.5, 0.3, 0.2, 0.1};
     uint16_t planetColors[] = {
-        tft.color565(0, 0, 255),     // Mercury - Blue
-        tft.color565(255, 100, 0),   // Venus - Orange
-        tft.color565(0, 255, 0),     // Earth - Green
-        tft.color565(255, 0, 0)      // Mars - Red
+        canvas.color565(0, 0, 255),     // Mercury - Blue
+        canvas.color565(255, 100, 0),   // Venus - Orange
+        canvas.color565(0, 255, 0),     // Earth - Green
+        canvas.color565(255, 0, 0)      // Mars - Red
     };
     int planetSizes[] = {3, 4, 3, 2};
     int orbitRadii[] = {20, 30, 40, 50};
@@ -883,37 +1238,15 @@ void drawSolarSystem() {
             flareParticles[i].active = false;
         }
 
-        // Draw starfield (once during initialization)
-        for (int i = 0; i < 20; i++) {
-            int starX = random(SCREEN_WIDTH);
-            int starY = random(SCREEN_HEIGHT);
-            uint8_t brightness = random(50, 150);
-            uint16_t starColor = tft.color565(brightness, brightness, brightness);
-            tft.drawPixel(starX, starY, starColor);
-            stars[i] = {starX, starY};
+        // Pick starfield (once during initialization)
+        objectRng.fill(solarSystemStars, SOLAR_SYSTEM_STARS, &Point::x, 0, SCREEN_WIDTH);
+        objectRng.fill(solarSystemStars, SOLAR_SYSTEM_STARS, &Point::y, 0, SCREEN_HEIGHT);
+        for (int i = 0; i < SOLAR_SYSTEM_STARS; i++) {
+            uint8_t brightness = objectRng.range(50, 150);
+            solarSystemStarColors[i] = PAL_GREY.v[brightness];
         }
 
-        // Draw sun with corona
-        for (int r = sunRadius + 2; r > sunRadius; r--) {
-            uint8_t brightness = map(r, sunRadius, sunRadius + 2, 255, 100);
-            uint16_t coronaColor = tft.color565(brightness, brightness, 0);
-            tft.drawCircle(centerX, centerY, r, coronaColor);
-        }
-        tft.fillCircle(centerX, centerY, sunRadius, TFT_YELLOW);
-
-        // Draw faint orbit paths (static)
-        for (int i = 0; i < 4; i++) {
-            int orbitRadius = orbitRadii[i] * objectScale;
-            for (int j = 0; j < 360; j += 5) { // Increase step for performance
-                float angle = j * PI / 180.0f;
-                int x = centerX + orbitRadius * cos(angle);
-                int y = centerY + orbitRadius * sin(angle);
-                if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                    tft.drawPixel(x, y, tft.color565(20, 20, 20));
-                }
-            }
-            prevOrbitRadii[i] = orbitRadius;
-        }
+        drawSolarSystemBackdrop(centerX, centerY, sunRadius, orbitRadii);
 
         // Draw initial planets, rings, and moon
         for (int i = 0; i < 4; i++) {
@@ -925,18 +1258,18 @@ void drawSolarSystem() {
             // Planet glow
             for (int r = planetRadius + 1; r > planetRadius; r--) {
                 uint8_t brightness = map(r, planetRadius, planetRadius + 1, 255, 100);
-                uint16_t glowColor = tft.color565(
+                uint16_t glowColor = canvas.color565(
                     ((planetColors[i] >> 11) & 0x1F) * brightness / 255,
                     ((planetColors[i] >> 5) & 0x3F) * brightness / 255,
                     (planetColors[i] & 0x1F) * brightness / 255
                 );
-                tft.drawCircle(planetX, planetY, r, glowColor);
+                canvasDrawCircle(planetX, planetY, r, glowColor);
             }
-            tft.fillCircle(planetX, planetY, planetRadius, planetColors[i]);
+            canvasFillCircle(planetX, planetY, planetRadius, planetColors[i]);
 
             // Rings for planet 2 (Saturn-like)
             if (i == 2) {
-                tft.drawCircle(planetX, planetY, planetRadius + 2, tft.color565(150, 150, 150));
+                canvasDrawCircle(planetX, planetY, planetRadius + 2, canvas.color565(150, 150, 150));
             }
 
             // Moon for planet 1 (Earth-like)
@@ -944,7 +1277,7 @@ void drawSolarSystem() {
                 float moonAngle = t * 2.0f; // Faster orbit
                 int moonX = planetX + 5 * cos(moonAngle);
                 int moonY = planetY + 5 * sin(moonAngle);
-                tft.drawPixel(moonX, moonY, TFT_WHITE);
+                canvas.drawPixel(moonX, moonY, TFT_WHITE);
             }
 
             prevPlanetX[i] = planetX;
@@ -957,17 +1290,22 @@ void drawSolarSystem() {
         prevSunRadius = sunRadius;
         solarSystemInitialized = true;
     } else {
+#if RENDER_FULL_REDRAW
+        // The frame starts empty, so the static layer is drawn again
+        drawSolarSystemBackdrop(centerX, centerY, sunRadius, orbitRadii);
+#else
         // Erase previous planet positions (including rings and moon)
         for (int i = 0; i < 4; i++) {
             // Erase planet with extra radius to cover glow
-            tft.fillCircle(prevPlanetX[i], prevPlanetY[i], prevPlanetRadius[i] + 3, BG_COLOR);
+            canvasFillCircle(prevPlanetX[i], prevPlanetY[i], prevPlanetRadius[i] + 3, BG_COLOR);
             
             // Special handling for ringed planet (i=2)
             if (i == 2) {
                 // Erase ring area with larger radius
-                tft.fillCircle(prevPlanetX[i], prevPlanetY[i], prevPlanetRadius[i] + 4, BG_COLOR);
+                canvasFillCircle(prevPlanetX[i], prevPlanetY[i], prevPlanetRadius[i] + 4, BG_COLOR);
             }
         }
+#endif
 
         // Update and draw planets
         for (int i = 0; i < 4; i++) {
@@ -979,21 +1317,21 @@ void drawSolarSystem() {
             // Planet glow
             for (int r = planetRadius + 1; r > planetRadius; r--) {
                 uint8_t brightness = map(r, planetRadius, planetRadius + 1, 255, 100);
-                uint16_t glowColor = tft.color565(
+                uint16_t glowColor = canvas.color565(
                     ((planetColors[i] >> 11) & 0x1F) * brightness / 255,
                     ((planetColors[i] >> 5) & 0x3F) * brightness / 255,
                     (planetColors[i] & 0x1F) * brightness / 255
                 );
-                tft.drawCircle(planetX, planetY, r, glowColor);
+                canvasDrawCircle(planetX, planetY, r, glowColor);
             }
-            tft.fillCircle(planetX, planetY, planetRadius, planetColors[i]);
+            canvasFillCircle(planetX, planetY, planetRadius, planetColors[i]);
 
             // Rings for planet 2
             if (i == 2) {
                 // Draw thicker ring with inner and outer circles
-                tft.drawCircle(planetX, planetY, planetRadius + 1, tft.color565(150, 150, 150));
-                tft.drawCircle(planetX, planetY, planetRadius + 2, tft.color565(150, 150, 150));
-                tft.drawCircle(planetX, planetY, planetRadius + 3, tft.color565(150, 150, 150));
+                canvasDrawCircle(planetX, planetY, planetRadius + 1, canvas.color565(150, 150, 150));
+                canvasDrawCircle(planetX, planetY, planetRadius + 2, canvas.color565(150, 150, 150));
+                canvasDrawCircle(planetX, planetY, planetRadius + 3, canvas.color565(150, 150, 150));
             }
 
             // Moon for planet 1
@@ -1001,7 +1339,7 @@ void drawSolarSystem() {
                 float moonAngle = t * 2.0f;
                 int moonX = planetX + 5 * cos(moonAngle);
                 int moonY = planetY + 5 * sin(moonAngle);
-                tft.drawPixel(moonX, moonY, TFT_WHITE);
+                canvas.drawPixel(moonX, moonY, TFT_WHITE);
             }
 
             prevPlanetX[i] = planetX;
@@ -1011,8 +1349,10 @@ void drawSolarSystem() {
        // Update existing flare particles
 for (int i = 0; i < MAX_FLARE_PARTICLES; i++) {
     if (flareParticles[i].active) {
+#if !RENDER_FULL_REDRAW
         // Erase previous position
-        tft.drawPixel(flareParticles[i].x, flareParticles[i].y, BG_COLOR);
+        canvas.drawPixel(flareParticles[i].x, flareParticles[i].y, BG_COLOR);
+#endif
         
         // Update position with gravity effect (pulls back to sun)
         float dx = centerX - flareParticles[i].x;
@@ -1047,8 +1387,8 @@ for (int i = 0; i < MAX_FLARE_PARTICLES; i++) {
             uint8_t green = min(255, 180 + (int)(75 * (1.0 - dist / (sunRadius * 5))));
             uint8_t blue = min(200, (int)(80 * (1.0 - dist / (sunRadius * 3))));
             
-            uint16_t currentColor = tft.color565(red, green, blue);
-            tft.drawPixel(flareParticles[i].x, flareParticles[i].y, currentColor);
+            uint16_t currentColor = canvas.color565(red, green, blue);
+            canvas.drawPixel(flareParticles[i].x, flareParticles[i].y, currentColor);
         } else {
             flareParticles[i].active = false;
         }
@@ -1058,18 +1398,18 @@ for (int i = 0; i < MAX_FLARE_PARTICLES; i++) {
 
         // Generate new flares (5% chance per frame)
         // Generate new flares (5% chance per frame)
-if (random(100) < 5) {
+if (objectRng.below(100) < 5) {
     // Choose a random starting angle for the flare
-    float flareAngle = random(360) * PI / 180.0f;
+    float flareAngle = objectRng.below(360) * PI / 180.0f;
     float flareBaseX = centerX + sunRadius * cos(flareAngle);
     float flareBaseY = centerY + sunRadius * sin(flareAngle);
     
     // Redraw the sun when a particle leaves
-    tft.fillCircle(centerX, centerY, sunRadius, TFT_YELLOW); // Redraw sun
+    canvasFillCircle(centerX, centerY, sunRadius, TFT_YELLOW); // Redraw sun
     
     // Generate 8-16 particles for this flare (more particles for better visual effect)
-    int particleCount = random(8, 17);
-    float baseSpeed = random(8, 18) / 10.0f; // Base speed for this eruption
+    int particleCount = objectRng.range(8, 17);
+    float baseSpeed = objectRng.range(8, 18) / 10.0f; // Base speed for this eruption
     
     // Create an arc-like eruption pattern with more variation
     for (int i = 0; i < particleCount; i++) {
@@ -1085,11 +1425,11 @@ if (random(100) < 5) {
                 float arcFactor = 1.0 - fabs(arcPosition - 0.5) * 2.0; // 1.0 in middle, 0.0 at edges
                 
                 // Randomize the velocity direction in an arc pattern with more spread
-                float angleVariation = (random(-30, 30) + (arcPosition - 0.5) * 60) * PI / 180.0f;
+                float angleVariation = (objectRng.range(-30, 30) + (arcPosition - 0.5) * 60) * PI / 180.0f;
                 float particleAngle = flareAngle + angleVariation;
                 
                 // Determine if this will be an escaping particle (only ~10-15% escape)
-                bool willEscape = random(100) < 12;
+                bool willEscape = objectRng.below(100) < 12;
                 
                 // Set velocity - particles in middle of arc move faster
                 float speed;
@@ -1105,16 +1445,16 @@ if (random(100) < 5) {
                 flareParticles[j].vy = speed * sin(particleAngle);
                 
                 // Set random lifetime - escaping particles live longer
-                flareParticles[j].life = random(70, 100) / 100.0f;
+                flareParticles[j].life = objectRng.range(70, 100) / 100.0f;
                 if (willEscape) {
                     flareParticles[j].life += 0.4; // Longer life for escaping particles
                 }
                 
                 // Set initial color based on temperature (yellow-white at base, redder for slower particles)
                 if (willEscape) {
-                    flareParticles[j].color = tft.color565(255, 200, 100); // Brighter orange for escaping
+                    flareParticles[j].color = canvas.color565(255, 200, 100); // Brighter orange for escaping
                 } else {
-                    flareParticles[j].color = tft.color565(255, 150, 50); // Darker orange for non-escaping
+                    flareParticles[j].color = canvas.color565(255, 150, 50); // Darker orange for non-escaping
                 }
                 
                 flareParticles[j].active = true;
@@ -1129,25 +1469,29 @@ if (random(100) < 5) {
 
 void eraseSolarSystem() {
   if (prevSunRadius > 0) {
+#if !RENDER_FULL_REDRAW
     // Clear sun and corona with larger buffer for complete clearing
-    tft.fillCircle(prevSunX, prevSunY, prevSunRadius + 7, BG_COLOR);
+    canvasFillCircle(prevSunX, prevSunY, prevSunRadius + 7, BG_COLOR);
 
     // Clear planets, rings, and moon
     for (int i = 0; i < 4; i++) {
       if (prevPlanetRadius[i] > 0) {
-        tft.fillCircle(prevPlanetX[i], prevPlanetY[i], prevPlanetRadius[i] + 3, BG_COLOR);
+        canvasFillCircle(prevPlanetX[i], prevPlanetY[i], prevPlanetRadius[i] + 3, BG_COLOR);
       }
     }
 
     // Clear stars
-    for (int i = 0; i < 20; i++) {
-      tft.drawPixel(stars[i].x, stars[i].y, BG_COLOR);
+    for (int i = 0; i < SOLAR_SYSTEM_STARS; i++) {
+      canvas.drawPixel(solarSystemStars[i].x, solarSystemStars[i].y, BG_COLOR);
     }
+#endif
     
     // Clear flare particles
     for (int i = 0; i < MAX_FLARE_PARTICLES; i++) {
       if (flareParticles[i].active) {
-        tft.drawPixel(flareParticles[i].x, flareParticles[i].y, BG_COLOR);
+#if !RENDER_FULL_REDRAW
+        canvas.drawPixel(flareParticles[i].x, flareParticles[i].y, BG_COLOR);
+#endif
         flareParticles[i].active = false;
       }
     }
@@ -1161,32 +1505,61 @@ void eraseSolarSystem() {
     solarSystemInitialized = false;
   }
   
+#if !RENDER_FULL_REDRAW
   // Clear orbit paths
   for (int i = 0; i < 4; i++) {
-    tft.fillCircle(objectX, objectY, prevOrbitRadii[i] + 1, BG_COLOR);
+    canvasFillCircle(objectX, objectY, prevOrbitRadii[i] + 1, BG_COLOR);
   }
+#endif
 }
 
 void eraseAsteroidField() {
+#if !RENDER_FULL_REDRAW
   for (int i = 0; i < MAX_ASTEROIDS; i++) {
     if (asteroids[i].radius > 0) {
       // Clear asteroid with expanded radius to ensure complete cleanup
-      tft.fillCircle(asteroids[i].prevX, asteroids[i].prevY, 
+      canvasFillCircle(asteroids[i].prevX, asteroids[i].prevY, 
                     asteroids[i].radius + 8, BG_COLOR); // Increased to +8 for more robust erasure
       
       // Also clear any potential artifacts in the movement path
       int midX = (asteroids[i].prevX + asteroids[i].x) / 2;
       int midY = (asteroids[i].prevY + asteroids[i].y) / 2;
-      tft.fillCircle(midX, midY, asteroids[i].radius + 4, BG_COLOR);
+      canvasFillCircle(midX, midY, asteroids[i].radius + 4, BG_COLOR);
     }
   }
+#endif
 }
 
 // Enhanced nebula constants
 #define MAX_NEBULA_PARTICLES 200  // Slightly increased for better detail
+#define MIN_NEBULA_PARTICLES 80   // Particles kept at the lowest detail level
 #define MAX_NEBULA_CORES 4      // Multiple cores for complex structure
 #define MAX_DUST_LANES 3        // Dark dust lanes for realism
 
+#define NEBULA_BATCH 40           // Particles moved per frame
+#define NEBULA_SPAWNS_PER_FRAME 20 // Particles laid out per frame when the detail level rises
+
+// Nebula engine. The grid engine keeps the gas as density and temperature in
+// a coarse grid over the screen, moves a share of its cells each frame and
+// paints the whole grid into the back buffer, smoothly interpolated, at a cost
+// that only depends on the grid and the screen. It needs the whole frame in
+// memory; direct and band mode keep the particle engine.
+#ifndef NEBULA_GRID
+#define NEBULA_GRID (RENDER_MODE == RENDER_SPRITE || RENDER_MODE == RENDER_TILED)
+#endif
+#if NEBULA_GRID && RENDER_MODE != RENDER_SPRITE && RENDER_MODE != RENDER_TILED
+#error "NEBULA_GRID needs RENDER_MODE == RENDER_SPRITE or RENDER_TILED"
+#endif
+#define NEBULA_GRID_SIZE 32          // Cells per side, power of two
+#define NEBULA_CELLS (NEBULA_GRID_SIZE * NEBULA_GRID_SIZE)
+#define MAX_NEBULA_CELL_UPDATES 256  // Cells moved per frame at full detail
+#define MIN_NEBULA_CELL_UPDATES 64   // Cells moved per frame at the lowest detail level
+#define NEBULA_CELL_STRIDE 397       // Walks the cells in a scattered order, odd so it visits all
+#define NEBULA_FLOW_UNIT 128         // Flow is stored in 1/128 cells per second
+#define NEBULA_SWIRL 0.5f            // Swirl speed at a core's edge, cells per second
+#define NEBULA_RELAX 32              // Pull towards the target density per visit, 256 = all the way
+#define NEBULA_FADE_DENSITY 64       // Thinner gas fades to black instead of bottoming out in the palette
+
 struct NebulaParticle {
     float x, y;
     float vx, vy;
@@ -1194,7 +1567,7 @@ struct NebulaParticle {
     float temperature;   // Temperature affects color
     uint16_t color;
     int radius;
-    int prevX, prevY;
+    int prevX, prevY;    // Last drawn position, prevX < 0 if not drawn
     bool isDustLane;    // Whether this particle is part of a dark dust lane
 };
 
@@ -1205,347 +1578,744 @@ struct NebulaCore {
     float radius;       // Influence radius
 };
 
+/**
+ * Nebula particles swirl around the nearest core and never die; the detail
+ * level decides how many there are
+ */
+struct NebulaTraits {
+    struct Context {
+        float deltaTime;
+        float globalPulse;
+    };
+
+    static bool update(NebulaParticle& particle, Context& context);
+    static void draw(NebulaParticle& particle, Context& context);
+    static void erase(const NebulaParticle& particle, Context& context);
+    static void layOut(NebulaParticle& particle);
+};
+
+typedef ParticleSystem<NebulaParticle, MAX_NEBULA_PARTICLES, NebulaTraits> NebulaCloud;
+
+/**
+ * The grid engine's gas, row by row; all values 0..255
+ */
+struct NebulaGrid {
+    uint8_t density[NEBULA_CELLS];
+    uint8_t temperature[NEBULA_CELLS];        // 0 cool .. 255 hot
+    uint8_t targetDensity[NEBULA_CELLS];      // What the gas relaxes to: cores, structure and dust lanes
+    uint8_t targetTemperature[NEBULA_CELLS];
+    int8_t flowX[NEBULA_CELLS];               // Swirl around the nearest core, NEBULA_FLOW_UNIT
+    int8_t flowY[NEBULA_CELLS];
+    uint16_t cursor;                          // Cells moved so far; times NEBULA_CELL_STRIDE picks the next
+};
+
+static_assert((NEBULA_CELLS & (NEBULA_CELLS - 1)) == 0, "NEBULA_GRID_SIZE must be a power of two");
+
+#if NEBULA_GRID
+#define NEBULA_ARENA_BYTES (ARENA_SIZE(NebulaGrid, 1) + ARENA_SIZE(NebulaCore, MAX_NEBULA_CORES))
+#else
+#define NEBULA_ARENA_BYTES (ARENA_SIZE(NebulaCloud, 1) + ARENA_SIZE(NebulaCore, MAX_NEBULA_CORES))
+#endif
+#define NEBULA_SIM_CORE (!NEBULA_GRID) // The grid engine writes the back buffer, so it stays on the loop() core
+
 // Global variables
-NebulaParticle nebulaParticles[MAX_NEBULA_PARTICLES];
-NebulaCore nebulaCores[MAX_NEBULA_CORES];
+NebulaCloud* nebulaParticles = nullptr;    // From the object arena
+NebulaGrid* nebulaGrid = nullptr;          // From the object arena, grid engine only
+NebulaCore* nebulaCores = nullptr;         // MAX_NEBULA_CORES from the object arena
 bool nebulaInitialized = false;
 
+/**
+ * Nebula particles to animate and draw at a detail level (see lod.h), or
+ * grid cells to move for the grid engine
+ */
+int nebulaDetailBudget(uint8_t detail) {
+#if NEBULA_GRID
+    return lodBudget(detail, MIN_NEBULA_CELL_UPDATES, MAX_NEBULA_CELL_UPDATES);
+#else
+    return lodBudget(detail, MIN_NEBULA_PARTICLES, MAX_NEBULA_PARTICLES);
+#endif
+}
+
+/**
+ * Places the cores the gas gathers around
+ */
+void layOutNebulaCores() {
+    for (int i = 0; i < MAX_NEBULA_CORES; i++) {
+        nebulaCores[i].x = objectX + objectRng.range(-30, 30) * objectScale;
+        nebulaCores[i].y = objectY + objectRng.range(-30, 30) * objectScale;
+        nebulaCores[i].temperature = objectRng.range(60, 100) / 100.0f;
+        nebulaCores[i].intensity = objectRng.range(70, 100) / 100.0f;
+        nebulaCores[i].radius = objectRng.range(15, 25) * objectScale;
+    }
+}
+
+/**
+ * simpleNoise() smoothly interpolated between its lattice points, period cells apart
+ */
+float nebulaNoise(int x, int y, int period, uint32_t seed) {
+    int lx = x / period, ly = y / period;
+    float fx = (float)(x % period) / period, fy = (float)(y % period) / period;
+    fx = fx * fx * (3 - 2 * fx);
+    fy = fy * fy * (3 - 2 * fy);
+    float top = simpleNoise(lx, ly, seed) * (1 - fx) + simpleNoise(lx + 1, ly, seed) * fx;
+    float bottom = simpleNoise(lx, ly + 1, seed) * (1 - fx) + simpleNoise(lx + 1, ly + 1, seed) * fx;
+    return top * (1 - fy) + bottom * fy;
+}
+
+/**
+ * Fills the grid's targets and flow from the cores, the way the particle
+ * engine spreads its particles: gas around each core, thinned and warmed by
+ * noise, with dark dust lanes across it. The gas starts at its target.
+ */
+void layOutNebulaGrid() {
+    NebulaGrid& grid = *nebulaGrid;
+    const float cellW = (float)SCREEN_WIDTH / NEBULA_GRID_SIZE;
+    const float cellH = (float)SCREEN_HEIGHT / NEBULA_GRID_SIZE;
+    uint32_t seed = objectRng.next();
+
+    // Dust lanes: lines through the nebula, in pixels
+    float laneX[MAX_DUST_LANES], laneY[MAX_DUST_LANES], laneDX[MAX_DUST_LANES], laneDY[MAX_DUST_LANES];
+    for (int l = 0; l < MAX_DUST_LANES; l++) {
+        const NebulaCore& core = nebulaCores[objectRng.below(MAX_NEBULA_CORES)];
+        float angle = objectRng.below(360) * PI / 180.0f;
+        laneX[l] = core.x + objectRng.range(-10, 10) * objectScale;
+        laneY[l] = core.y + objectRng.range(-10, 10) * objectScale;
+        laneDX[l] = cos(angle);
+        laneDY[l] = sin(angle);
+    }
+    const float laneWidth = 3.0f * objectScale;
+
+    for (int cy = 0; cy < NEBULA_GRID_SIZE; cy++) {
+        for (int cx = 0; cx < NEBULA_GRID_SIZE; cx++) {
+            int cell = cy * NEBULA_GRID_SIZE + cx;
+            float x = (cx + 0.5f) * cellW;
+            float y = (cy + 0.5f) * cellH;
+
+            // Density falls off around each core; temperature follows the cores that contribute
+            float density = 0, heat = 0, nearest = 1e9f;
+            float swirlX = 0, swirlY = 0;
+            for (int c = 0; c < MAX_NEBULA_CORES; c++) {
+                const NebulaCore& core = nebulaCores[c];
+                float dx = x - core.x, dy = y - core.y;
+                float distSq = dx * dx + dy * dy;
+                float falloff = core.intensity * expf(-distSq / sq(core.radius));
+                density += falloff;
+                heat += falloff * core.temperature;
+                if (distSq < nearest) {
+                    // Tangential, strongest at the core's edge (cells per second)
+                    nearest = distSq;
+                    float dist = max(1.0f, sqrtf(distSq));
+                    float strength = NEBULA_SWIRL * min(1.0f, dist / core.radius) * expf(1.0f - dist / core.radius);
+                    swirlX = -dy / dist * strength;
+                    swirlY = dx / dist * strength;
+                }
+            }
+            float temperature = density > 0.001f ? heat / density : 0;
+            // Clumps a few cells across with finer grain, warmer and cooler patches
+            density *= 0.8f * (0.4f + 0.4f * nebulaNoise(cx, cy, 4, seed) + 0.2f * simpleNoise(cx, cy, seed + 1));
+            temperature *= 0.85f + 0.15f * nebulaNoise(cx, cy, 6, seed + 2);
+
+            // Dark dust lanes
+            for (int l = 0; l < MAX_DUST_LANES; l++) {
+                float across = fabsf((x - laneX[l]) * laneDY[l] - (y - laneY[l]) * laneDX[l]);
+                if (across < laneWidth) density *= 0.3f + 0.7f * across / laneWidth;
+            }
+
+            grid.targetDensity[cell] = constrain((int)(density * 255), 0, 255);
+            grid.targetTemperature[cell] = constrain((int)(temperature * 255), 0, 255);
+            grid.flowX[cell] = constrain((int)(swirlX * NEBULA_FLOW_UNIT), -127, 127);
+            grid.flowY[cell] = constrain((int)(swirlY * NEBULA_FLOW_UNIT), -127, 127);
+        }
+    }
+    memcpy(grid.density, grid.targetDensity, NEBULA_CELLS);
+    memcpy(grid.temperature, grid.targetTemperature, NEBULA_CELLS);
+    grid.cursor = 0;
+}
+
+/**
+ * Takes the particles (or the grid) and cores from the object arena; the
+ * first draw lays them out
+ */
+void initNebula() {
+#if NEBULA_GRID
+    nebulaGrid = arenaAlloc<NebulaGrid>();
+#else
+    nebulaParticles = arenaAlloc<NebulaCloud>();
+#endif
+    nebulaCores = arenaAlloc<NebulaCore>(MAX_NEBULA_CORES);
+    nebulaInitialized = false;
+}
+
+/**
+ * Erases one nebula particle where it was last drawn
+ */
+void NebulaTraits::erase(const NebulaParticle& particle, Context& context) {
+#if !RENDER_FULL_REDRAW
+    if (particle.prevX < 0) return;
+    if (particle.radius == 1) {
+        simCanvas.drawPixel(particle.prevX, particle.prevY, BG_COLOR);
+    } else {
+        simFillCircle(particle.prevX, particle.prevY, particle.radius, BG_COLOR);
+    }
+#endif
+}
+
 // Color temperature mapping (Blackbody radiation approximation)
 uint16_t getColorFromTemperature(float temp, float density) {
-    int r, g, b;
+    // Temperature ranges from 0 (cool) to 1 (hot); the curve is tabulated in palette.h
+    return paletteNebula(temp, density);
+}
+
+/**
+ * Draws one nebula particle and remembers where it was drawn
+ */
+void NebulaTraits::draw(NebulaParticle& particle, Context& context) {
+    // Calculate final color
+    float effectiveTemp = particle.temperature;
+    float effectiveDensity = particle.density * 
+                            (0.8 + 0.2 * context.globalPulse) * 
+                            (particle.isDustLane ? 0.3 : 1.0);
+
+    // Draw particle
+    int x = round(particle.x);
+    int y = round(particle.y);
     
-    // Temperature ranges from 0 (cool) to 1 (hot)
-    if (temp < 0.3) {
-        // Cool reds and purples
-        r = 255 * temp * 3;
-        g = 0;
-        b = 100 * temp;
-    } else if (temp < 0.6) {
-        // Transition to blues
-        r = 150 - (temp - 0.3) * 200;
-        g = (temp - 0.3) * 200;
-        b = 150 + (temp - 0.3) * 200;
-    } else {
-        // Hot blues and whites
-        r = (temp - 0.6) * 400;
-        g = 120 + (temp - 0.6) * 300;
-        b = 255;
+    if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
+        uint16_t color = getColorFromTemperature(effectiveTemp, effectiveDensity);
+        
+        if (particle.radius == 1) {
+            simCanvas.drawPixel(x, y, color);
+        } else {
+            simFillCircle(x, y, particle.radius, color);
+        }
+        
+        particle.prevX = x;
+        particle.prevY = y;
     }
+}
 
-    // Apply density modulation
-    float brightness = constrain(density * 1.2f, 0.2f, 1.0f);
-    r = constrain((int)(r * brightness), 0, 255);
-    g = constrain((int)(g * brightness), 0, 255);
-    b = constrain((int)(b * brightness), 0, 255);
+/**
+ * Moves one nebula particle and lets the nearest core bend its path
+ */
+bool NebulaTraits::update(NebulaParticle& particle, Context& context) {
+    // Update position with smooth motion
+    particle.x += particle.vx * context.deltaTime * 60;
+    particle.y += particle.vy * context.deltaTime * 60;
+
+    // Apply influence from nearest core
+    float minDist = 1000;
+    int nearestCore = 0;
+    for (int c = 0; c < MAX_NEBULA_CORES; c++) {
+        float dx = nebulaCores[c].x - particle.x;
+        float dy = nebulaCores[c].y - particle.y;
+        float dist = sqrt(dx*dx + dy*dy);
+        if (dist < minDist) {
+            minDist = dist;
+            nearestCore = c;
+        }
+    }
 
-    return tft.color565(r, g, b);
+    // Adjust velocity based on core influence
+    if (minDist < nebulaCores[nearestCore].radius) {
+        float angle = atan2(particle.y - nebulaCores[nearestCore].y,
+                          particle.x - nebulaCores[nearestCore].x);
+        particle.vx += cos(angle + PI/2) * 0.0001f;
+        particle.vy += sin(angle + PI/2) * 0.0001f;
+    }
+    return true;
 }
 
-void drawNebula() {
-    int centerX = objectX;
-    int centerY = objectY;
-    float scale = objectScale;
+/**
+ * Places a new particle in the influence of a random core
+ */
+void NebulaTraits::layOut(NebulaParticle& particle) {
+    // Randomly assign particle to a core's influence
+    int coreIndex = objectRng.below(MAX_NEBULA_CORES);
+    float angle = objectRng.below(360) * PI / 180.0;
+    float dist = objectRng.below(nebulaCores[coreIndex].radius * 1.5);
+    
+    particle.x = nebulaCores[coreIndex].x + cos(angle) * dist;
+    particle.y = nebulaCores[coreIndex].y + sin(angle) * dist;
+    
+    // Initialize velocity (slow, swirling motion)
+    float speed = objectRng.range(2, 8) / 1000.0;
+    particle.vx = cos(angle + PI/2) * speed; // Tangential velocity
+    particle.vy = sin(angle + PI/2) * speed;
     
+    // Set particle properties
+    particle.density = objectRng.range(60, 100) / 100.0f;
+    particle.temperature = nebulaCores[coreIndex].temperature * 
+                           (0.7 + objectRng.below(30) / 100.0f);
+    particle.radius = objectRng.below(100) < 30 ? 2 : 1; // 30% larger particles
+    particle.isDustLane = objectRng.below(100) < 15; // 15% dust lanes
+    
+    // Not drawn yet
+    particle.prevX = -1;
+    particle.prevY = -1;
+}
+
+#if NEBULA_GRID
+/**
+ * Grid density at a fractional cell position, bilinear and clamped to the grid;
+ * temperature comes back through *temperature
+ */
+uint8_t sampleNebulaGrid(float gx, float gy, uint8_t* temperature) {
+    const NebulaGrid& grid = *nebulaGrid;
+    gx = constrain(gx, 0.0f, NEBULA_GRID_SIZE - 1.0f);
+    gy = constrain(gy, 0.0f, NEBULA_GRID_SIZE - 1.0f);
+    int x0 = (int)gx, y0 = (int)gy;
+    int x1 = min(x0 + 1, NEBULA_GRID_SIZE - 1), y1 = min(y0 + 1, NEBULA_GRID_SIZE - 1);
+    int fx = (int)((gx - x0) * 256), fy = (int)((gy - y0) * 256);
+    int c00 = y0 * NEBULA_GRID_SIZE + x0, c10 = y0 * NEBULA_GRID_SIZE + x1;
+    int c01 = y1 * NEBULA_GRID_SIZE + x0, c11 = y1 * NEBULA_GRID_SIZE + x1;
+
+    int top = grid.temperature[c00] * (256 - fx) + grid.temperature[c10] * fx;
+    int bottom = grid.temperature[c01] * (256 - fx) + grid.temperature[c11] * fx;
+    *temperature = (top * (256 - fy) + bottom * fy) >> 16;
+    top = grid.density[c00] * (256 - fx) + grid.density[c10] * fx;
+    bottom = grid.density[c01] * (256 - fx) + grid.density[c11] * fx;
+    return (top * (256 - fy) + bottom * fy) >> 16;
+}
+
+/**
+ * Moves budget cells of gas along the flow, semi-Lagrangian: each takes what
+ * was upstream of it, then relaxes a little towards its target so the nebula
+ * keeps its shape. A cell comes round every NEBULA_CELLS / budget frames, so
+ * it moves by that much time at once.
+ */
+void advectNebulaGrid(int budget, float deltaTime) {
+    NebulaGrid& grid = *nebulaGrid;
+    float step = deltaTime * NEBULA_CELLS / budget / NEBULA_FLOW_UNIT;
+    for (int i = 0; i < budget; i++) {
+        int cell = (grid.cursor++ * NEBULA_CELL_STRIDE) & (NEBULA_CELLS - 1);
+        int cx = cell % NEBULA_GRID_SIZE, cy = cell / NEBULA_GRID_SIZE;
+        uint8_t temperature;
+        int density = sampleNebulaGrid(cx - grid.flowX[cell] * step, cy - grid.flowY[cell] * step, &temperature);
+        grid.density[cell] = density + (((int)grid.targetDensity[cell] - density) * NEBULA_RELAX >> 8);
+        grid.temperature[cell] = temperature + (((int)grid.targetTemperature[cell] - temperature) * NEBULA_RELAX >> 8);
+    }
+}
+
+/**
+ * Paints the grid over the back buffer, interpolated between the cell
+ * centres, as light added to the stars behind it. globalPulse (0..1) breathes
+ * the whole nebula the way it does the particles.
+ */
+void paintNebulaGrid(float globalPulse) {
+#if RENDER_MODE == RENDER_SPRITE
+    if (backBufferFrames == 0) return;
+#else
+    if (!backBufferReady) return;
+#endif
+    const NebulaGrid& grid = *nebulaGrid;
+    uint16_t* frame = (uint16_t*)backBuffer.getPointer();
+
+    // Palette density column and fade for each density this frame, after the pulse
+    uint8_t densityIndex[256], densityFade[256];
+    int pulse = (int)((0.8f + 0.2f * globalPulse) * 256);
+    int visible = 256; // Lowest density that shows at all
+    for (int d = 0; d < 256; d++) {
+        int lit = d * pulse >> 8;
+        densityIndex[d] = constrain((int)((lit / 255.0f * 1.2f - 0.2f) * ((PAL_NEBULA_DENSITIES - 1) / 0.8f) + 0.5f),
+                                    0, PAL_NEBULA_DENSITIES - 1); // As in paletteNebula()
+        densityFade[d] = lit >= NEBULA_FADE_DENSITY ? BLEND_ALPHA_MAX : lit * BLEND_ALPHA_MAX / NEBULA_FADE_DENSITY;
+        if (densityFade[d] && visible == 256) visible = d;
+    }
+
+    // Rows of the grid with nothing to show are skipped with the pixel rows between them
+    bool rowLit[NEBULA_GRID_SIZE];
+    for (int row = 0; row < NEBULA_GRID_SIZE; row++) {
+        uint8_t peak = 0;
+        for (int col = 0; col < NEBULA_GRID_SIZE; col++) peak = max(peak, grid.density[row * NEBULA_GRID_SIZE + col]);
+        rowLit[row] = peak >= visible;
+    }
+
+    uint8_t density[NEBULA_GRID_SIZE], temperature[NEBULA_GRID_SIZE];
+    int top = SCREEN_HEIGHT, bottom = -1;
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        // Position between cell centres in 1/256 cells
+        int gy = constrain(((2 * y + 1) * NEBULA_GRID_SIZE * 128) / SCREEN_HEIGHT - 128, 0, (NEBULA_GRID_SIZE - 1) * 256);
+        int r0 = gy >> 8, r1 = min(r0 + 1, NEBULA_GRID_SIZE - 1), fy = gy & 255;
+        if (!rowLit[r0] && !rowLit[r1]) continue;
+
+        const uint8_t* d0 = grid.density + r0 * NEBULA_GRID_SIZE;
+        const uint8_t* d1 = grid.density + r1 * NEBULA_GRID_SIZE;
+        const uint8_t* t0 = grid.temperature + r0 * NEBULA_GRID_SIZE;
+        const uint8_t* t1 = grid.temperature + r1 * NEBULA_GRID_SIZE;
+        for (int col = 0; col < NEBULA_GRID_SIZE; col++) {
+            density[col] = (d0[col] * (256 - fy) + d1[col] * fy) >> 8;
+            temperature[col] = (t0[col] * (256 - fy) + t1[col] * fy) >> 8;
+        }
+
+        uint16_t* out = frame + y * SCREEN_WIDTH;
+        bool drawn = false;
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            int gx = constrain(((2 * x + 1) * NEBULA_GRID_SIZE * 128) / SCREEN_WIDTH - 128, 0, (NEBULA_GRID_SIZE - 1) * 256);
+            int c0 = gx >> 8, c1 = min(c0 + 1, NEBULA_GRID_SIZE - 1), fx = gx & 255;
+            uint8_t d = (density[c0] * (256 - fx) + density[c1] * fx) >> 8;
+            uint8_t fade = densityFade[d];
+            if (fade == 0) continue;
+            uint8_t t = (temperature[c0] * (256 - fx) + temperature[c1] * fx) >> 8;
+            uint16_t color = PAL_NEBULA.v[(t * (PAL_NEBULA_TEMPS - 1) + 127) / 255 * PAL_NEBULA_DENSITIES + densityIndex[d]];
+            if (fade < BLEND_ALPHA_MAX) color = scale565(color, fade);
+            uint16_t sum = add565(color, (out[x] >> 8) | (out[x] << 8));
+            out[x] = (sum >> 8) | (sum << 8);
+            drawn = true;
+        }
+        if (drawn) {
+            top = min(top, y);
+            bottom = y;
+        }
+    }
+#if RENDER_MODE == RENDER_TILED
+    if (bottom >= top) backBuffer.markTiles(0, top, SCREEN_WIDTH, bottom - top + 1);
+#endif
+}
+
+void drawNebula() {
+    if (!nebulaGrid) return;
+    if (!nebulaInitialized) {
+        layOutNebulaCores();
+        layOutNebulaGrid();
+        nebulaInitialized = true;
+    }
+
+    advectNebulaGrid(nebulaDetailBudget(lodDetail), frameClock.deltaUs / 1000000.0f);
+    paintNebulaGrid((sin(frameClock.timeMs / 3000.0f) + 1.0f) / 2.0f);
+}
+#else
+void drawNebula() {
     // Initialize nebula structure
     if (!nebulaInitialized) {
-        // Initialize cores with varying properties
-        for (int i = 0; i < MAX_NEBULA_CORES; i++) {
-            nebulaCores[i].x = centerX + random(-30, 30) * scale;
-            nebulaCores[i].y = centerY + random(-30, 30) * scale;
-            nebulaCores[i].temperature = random(60, 100) / 100.0f;
-            nebulaCores[i].intensity = random(70, 100) / 100.0f;
-            nebulaCores[i].radius = random(15, 25) * scale;
-        }
+        layOutNebulaCores();
 
         // Initialize particles
-        for (int i = 0; i < MAX_NEBULA_PARTICLES; i++) {
-            // Randomly assign particle to a core's influence
-            int coreIndex = random(MAX_NEBULA_CORES);
-            float angle = random(360) * PI / 180.0;
-            float dist = random(nebulaCores[coreIndex].radius * 1.5);
-            
-            nebulaParticles[i].x = nebulaCores[coreIndex].x + cos(angle) * dist;
-            nebulaParticles[i].y = nebulaCores[coreIndex].y + sin(angle) * dist;
-            
-            // Initialize velocity (slow, swirling motion)
-            float speed = random(2, 8) / 1000.0;
-            nebulaParticles[i].vx = cos(angle + PI/2) * speed; // Tangential velocity
-            nebulaParticles[i].vy = sin(angle + PI/2) * speed;
-            
-            // Set particle properties
-            nebulaParticles[i].density = random(60, 100) / 100.0f;
-            nebulaParticles[i].temperature = nebulaCores[coreIndex].temperature * 
-                                           (0.7 + random(30) / 100.0f);
-            nebulaParticles[i].radius = random(100) < 30 ? 2 : 1; // 30% larger particles
-            nebulaParticles[i].isDustLane = random(100) < 15; // 15% dust lanes
-            
-            // Initialize previous position
-            nebulaParticles[i].prevX = -1;
-            nebulaParticles[i].prevY = -1;
+        nebulaParticles->clear();
+        nebulaParticles->beginSpawns(MAX_NEBULA_PARTICLES);
+        while (NebulaParticle* particle = nebulaParticles->spawn()) {
+            NebulaTraits::layOut(*particle);
         }
         nebulaInitialized = true;
     }
 
     // Animation timing
-    static unsigned long lastUpdate = 0;
-    unsigned long currentTime = millis();
-    float deltaTime = (currentTime - lastUpdate) / 1000.0f;
-    lastUpdate = currentTime;
+    unsigned long currentTime = simInputs.clock.timeMs;
+    NebulaTraits::Context context;
+    context.deltaTime = simInputs.clock.deltaUs / 1000000.0f;
     
     // Global nebula pulsing
-    float globalPulse = (sin(currentTime / 3000.0f) + 1.0f) / 2.0f;
+    context.globalPulse = (sin(currentTime / 3000.0f) + 1.0f) / 2.0f;
+
+    // Particles dropped by the detail level are cleared; when it rises again a
+    // few new ones are laid out each frame, and the batches draw them
+    int budget = nebulaDetailBudget(simInputs.detail);
+    nebulaParticles->truncate(budget, context);
+    nebulaParticles->beginSpawns(NEBULA_SPAWNS_PER_FRAME);
+    while (NebulaParticle* particle = nebulaParticles->spawn(budget)) {
+        NebulaTraits::layOut(*particle);
+    }
 
     // Process particles in batches for smooth animation
     static int startIndex = 0;
-    int particlesToUpdate = min(40, MAX_NEBULA_PARTICLES);
+    int liveParticles = nebulaParticles->live();
+    int particlesToUpdate = min(NEBULA_BATCH, liveParticles);
+    startIndex %= liveParticles;
 
+#if !RENDER_FULL_REDRAW
     // Erase old positions
     for (int i = 0; i < particlesToUpdate; i++) {
-        int index = (startIndex + i) % MAX_NEBULA_PARTICLES;
-        if (nebulaParticles[index].prevX >= 0) {
-            if (nebulaParticles[index].radius == 1) {
-                tft.drawPixel(nebulaParticles[index].prevX, 
-                            nebulaParticles[index].prevY, BG_COLOR);
-            } else {
-                tft.fillCircle(nebulaParticles[index].prevX,
-                             nebulaParticles[index].prevY,
-                             nebulaParticles[index].radius, BG_COLOR);
-            }
-        }
+        NebulaTraits::erase((*nebulaParticles)[(startIndex + i) % liveParticles], context);
     }
+#endif
 
     // Update and draw new positions
     for (int i = 0; i < particlesToUpdate; i++) {
-        int index = (startIndex + i) % MAX_NEBULA_PARTICLES;
-        NebulaParticle& particle = nebulaParticles[index];
-
-        // Update position with smooth motion
-        particle.x += particle.vx * deltaTime * 60;
-        particle.y += particle.vy * deltaTime * 60;
-
-        // Apply influence from nearest core
-        float minDist = 1000;
-        int nearestCore = 0;
-        for (int c = 0; c < MAX_NEBULA_CORES; c++) {
-            float dx = nebulaCores[c].x - particle.x;
-            float dy = nebulaCores[c].y - particle.y;
-            float dist = sqrt(dx*dx + dy*dy);
-            if (dist < minDist) {
-                minDist = dist;
-                nearestCore = c;
-            }
-        }
-
-        // Adjust velocity based on core influence
-        if (minDist < nebulaCores[nearestCore].radius) {
-            float angle = atan2(particle.y - nebulaCores[nearestCore].y,
-                              particle.x - nebulaCores[nearestCore].x);
-            particle.vx += cos(angle + PI/2) * 0.0001f;
-            particle.vy += sin(angle + PI/2) * 0.0001f;
-        }
-
-        // Calculate final color
-        float effectiveTemp = particle.temperature;
-        float effectiveDensity = particle.density * 
-                                (0.8 + 0.2 * globalPulse) * 
-                                (particle.isDustLane ? 0.3 : 1.0);
-
-        // Draw particle
-        int x = round(particle.x);
-        int y = round(particle.y);
-        
-        if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-            uint16_t color = getColorFromTemperature(effectiveTemp, effectiveDensity);
-            
-            if (particle.radius == 1) {
-                tft.drawPixel(x, y, color);
-            } else {
-                tft.fillCircle(x, y, particle.radius, color);
-            }
-            
-            particle.prevX = x;
-            particle.prevY = y;
-        }
+        NebulaParticle& particle = (*nebulaParticles)[(startIndex + i) % liveParticles];
+        NebulaTraits::update(particle, context);
+#if !RENDER_FULL_REDRAW
+        NebulaTraits::draw(particle, context);
+#endif
     }
 
-    startIndex = (startIndex + particlesToUpdate) % MAX_NEBULA_PARTICLES;
+#if RENDER_FULL_REDRAW
+    // The frame starts empty, so particles outside this batch are drawn too
+    nebulaParticles->draw(context);
+#endif
+
+    startIndex = (startIndex + particlesToUpdate) % liveParticles;
 }
 
+#endif
+
 void eraseNebula() {
+#if !RENDER_FULL_REDRAW
   if (nebulaInitialized) {
-    for (int i = 0; i < MAX_NEBULA_PARTICLES; i++) {
-      if (nebulaParticles[i].prevX >= 0 && nebulaParticles[i].prevX < SCREEN_WIDTH && 
-          nebulaParticles[i].prevY >= 0 && nebulaParticles[i].prevY < SCREEN_HEIGHT) {
-        if (nebulaParticles[i].radius == 1) {
-          tft.drawPixel(nebulaParticles[i].prevX, nebulaParticles[i].prevY, BG_COLOR);
+    for (int i = 0; i < nebulaParticles->live(); i++) {
+      const NebulaParticle& particle = (*nebulaParticles)[i];
+      if (particle.prevX >= 0 && particle.prevX < SCREEN_WIDTH && 
+          particle.prevY >= 0 && particle.prevY < SCREEN_HEIGHT) {
+        if (particle.radius == 1) {
+          canvas.drawPixel(particle.prevX, particle.prevY, BG_COLOR);
         } else {
-      tft.fillCircle(nebulaParticles[i].prevX, nebulaParticles[i].prevY, 
-                         nebulaParticles[i].radius, BG_COLOR);
+          canvasFillCircle(particle.prevX, particle.prevY, particle.radius, BG_COLOR);
         }
       }
     }
   }
+#endif
   nebulaInitialized = false;
 }
 
-void drawGalaxy() {
+/**
+ * Points drawn per galaxy arm at a detail level (see lod.h)
+ */
+int galaxyDetailBudget(uint8_t detail) {
+  return lodBudget(detail, MIN_GALAXY_POINTS, MAX_GALAXY_POINTS);
+}
+
+/**
+ * Generates the galaxy's point cloud into the object arena
+ */
+void initGalaxy() {
   // Constants for spiral galaxy generation
-  const int numArms = min(5, MAX_GALAXY_ARMS); // Use 5 arms or max available
-  const float armSeparationDistance = 2 * PI / numArms;
+  const float armSeparationDistance = 2 * PI / MAX_GALAXY_ARMS;
   const float armOffsetMax = 0.5f;
   const float rotationFactor = 5;
   const float randomOffsetXY = 2.0f; // Adjusted for pixel space
-  
+
+  // Scaling factor - adjusted to fit the display (smaller value = larger galaxy)
+  float scaleFactor = 25.0f * objectScale;
+
+  galaxyPoints = arenaAlloc<GalaxyPoint>(MAX_GALAXY_ARMS * MAX_GALAXY_POINTS);
+  memset(galaxyArmPoints, 0, sizeof(galaxyArmPoints));
+  if (!galaxyPoints) return;
+
+  for (int arm = 0; arm < MAX_GALAXY_ARMS; arm++) {
+    int count = 0;
+    for (int i = 0; i < GALAXY_ARM_CANDIDATES && count < MAX_GALAXY_POINTS; i++) {
+      // Generate a distance from center (0-1)
+      float distance = (float)i / GALAXY_ARM_CANDIDATES;
+
+      // Square the distance to concentrate more stars near center
+      float distanceSquared = distance * distance;
+
+      // Apply density factor - more stars in inner galaxy
+      float density = 1.0f - distanceSquared * 0.8f;
+
+      // Add some randomness to star distribution
+      if (objectRng.below(100) > density * 90) continue;
+
+      // Calculate arm offset that decreases with distance
+      float armOffset = (objectRng.below(1000) / 1000.0f) * armOffsetMax;
+      armOffset = armOffset - armOffsetMax / 2;
+      armOffset = armOffset * (1 / max(distance, 0.1f));
+
+      // Apply squared offset with sign preservation
+      float squaredArmOffset = armOffset * abs(armOffset);
+
+      // Apply rotation that increases with distance
+      float rotation = distanceSquared * rotationFactor;
+
+      GalaxyPoint& point = galaxyPoints[arm * MAX_GALAXY_POINTS + count++];
+      point.angle = fxAngleFromRadians(arm * armSeparationDistance + squaredArmOffset + rotation);
+      point.radius = (int16_t)(scaleFactor * distance * 256);
+
+      // Add small random offset - more offset farther from center
+      point.jitterX = (int8_t)((objectRng.below(1000) / 1000.0f - 0.5f) * randomOffsetXY * distance * 64);
+      point.jitterY = (int8_t)((objectRng.below(1000) / 1000.0f - 0.5f) * randomOffsetXY * distance * 64);
+
+      // Brightness falls off with distance; the twinkle phase does too
+      point.brightness = (1.0f - distance * 0.5f) * 255.0f;
+      point.twinkle = fxAngleFromRadians(distance * 10.0f);
+
+      // Add colored stars with more variety
+      point.color = 0;
+      if (objectRng.below(15) == 0) { // Increased chance for colored stars
+        if (distance > 0.7f) {
+          point.color = canvas.color565(100, 100, 255); // Blue for outer arms
+        } else if (distance > 0.4f) {
+          point.color = canvas.color565(255, 255, 100); // Yellow for middle arms
+        } else {
+          point.color = canvas.color565(255, 100, 100); // Red for inner arms
+        }
+      }
+    }
+    galaxyArmPoints[arm] = count;
+  }
+
+#if !RENDER_FULL_REDRAW
+  galaxyShown = arenaAlloc<GalaxyPixel>(MAX_GALAXY_ARMS * MAX_GALAXY_POINTS);
+  galaxyErased = arenaAlloc<uint32_t>(GALAXY_ERASED_WORDS);
+  if (galaxyShown) {
+    for (int i = 0; i < MAX_GALAXY_ARMS * MAX_GALAXY_POINTS; i++) {
+      galaxyShown[i].x = SCREEN_NO_COORD;
+    }
+  }
+  prevGalaxyCoreRadius = 0;
+#endif
+}
+
+/**
+ * Where a galaxy point is this frame. Returns false when it is off screen.
+ */
+inline bool galaxyPointScreen(const GalaxyPoint& point, fx_angle rotation, int centerX, int centerY, int& x, int& y) {
+  fx_angle angle = point.angle + rotation;
+  // Q8.8 radius times Q16.16 cos/sin, back to Q16.16; jitter is 1/64 pixel
+  x = centerX + fxRound((((int32_t)point.radius * fxCos(angle)) >> 8) + point.jitterX * (1 << (FX_SHIFT - 6)));
+  y = centerY + fxRound((((int32_t)point.radius * fxSin(angle)) >> 8) + point.jitterY * (1 << (FX_SHIFT - 6)));
+  return x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT;
+}
+
+void drawGalaxy() {
+  if (!galaxyPoints) return;
+  const int maxArmPoints = galaxyDetailBudget(lodDetail);
+
   int centerX = objectX;
   int centerY = objectY;
   int coreRadius = 1 * objectScale; // Slightly larger core
-  
+
   // Add time-based effects
-  float time = millis() / 1000.0f;
+  float time = frameClock.timeMs / 1000.0f;
   float pulseFactor = (sin(time * 2.0f) + 1.0f) / 2.0f; // 0 to 1
   float rotationSpeed = 0.1f + 0.05f * sin(time * 0.5f); // Varying rotation speed
-  
-  // Erase previous core
-  if (prevGalaxyCoreRadius > 0) {
-    tft.fillCircle(prevGalaxyCenterX, prevGalaxyCenterY, prevGalaxyCoreRadius, BG_COLOR);
-  }
-  
-  // Erase previous points
+  fx_angle globalRotation = fxAngleFromRadians(fmodf((frameClock.timeMs / 10000.0f) * rotationSpeed, 2 * PI));
+  fx_angle twinkleTime = fxAngleFromRadians(fmodf(time * 3.0f, 2 * PI));
+
+#if !RENDER_FULL_REDRAW
+  // Only points that moved or are no longer drawn are erased. Their pixels
+  // are remembered so a point still sitting there gets drawn again.
+  if (!galaxyShown || !galaxyErased) return;
+  memset(galaxyErased, 0, GALAXY_ERASED_WORDS * sizeof(uint32_t));
   for (int arm = 0; arm < MAX_GALAXY_ARMS; arm++) {
-    for (int i = 0; i < prevGalaxyPointCount[arm]; i++) {
-      int x = prevGalaxyPoints[arm][i][0];
-      int y = prevGalaxyPoints[arm][i][1];
-      if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-        tft.drawPixel(x, y, BG_COLOR);
-      }
+    for (int i = 0; i < galaxyArmPoints[arm]; i++) {
+      GalaxyPixel& shown = galaxyShown[arm * MAX_GALAXY_POINTS + i];
+      if (shown.x == SCREEN_NO_COORD) continue;
+      int x, y;
+      bool visible = galaxyPointScreen(galaxyPoints[arm * MAX_GALAXY_POINTS + i], globalRotation, centerX, centerY, x, y);
+      if (visible && i < maxArmPoints && x == shown.x && y == shown.y) continue;
+      canvas.drawPixel(shown.x, shown.y, BG_COLOR);
+      galaxyErased[(shown.y * SCREEN_WIDTH + shown.x) >> 5] |= 1u << (shown.x & 31);
+      shown.x = SCREEN_NO_COORD;
     }
-    prevGalaxyPointCount[arm] = 0;
   }
-  
+#endif
+
   // Draw galaxy core with pulsing effect
   for (int r = coreRadius; r > 0; r--) {
     float brightness = map(r, 0, coreRadius, 255, 180);
     brightness *= (0.8f + 0.2f * pulseFactor); // Add pulsing to core
-    uint16_t color = tft.color565(brightness, brightness, brightness);
-    tft.drawCircle(centerX, centerY, r, color);
+    uint16_t color = PAL_GREY.v[(uint8_t)brightness];
+    canvasDrawCircle(centerX, centerY, r, color);
   }
-  
+
   // Add a bright center with color variation
   uint8_t centerBrightness = 255 * (0.7f + 0.3f * pulseFactor);
-  uint16_t centerColor = tft.color565(centerBrightness, centerBrightness, centerBrightness);
-  tft.fillCircle(centerX, centerY, coreRadius / 2, centerColor);
-  
-  // Store current core position and radius
+  uint16_t centerColor = PAL_GREY.v[centerBrightness];
+  canvasFillCircle(centerX, centerY, coreRadius / 2, centerColor);
+
+#if !RENDER_FULL_REDRAW
+  // The core is drawn over the same pixels every frame, so it needs no erase;
+  // points on top of it have to be drawn again though
+  for (int y = max(0, centerY - coreRadius); y <= min(SCREEN_HEIGHT - 1, centerY + coreRadius); y++) {
+    for (int x = max(0, centerX - coreRadius); x <= min(SCREEN_WIDTH - 1, centerX + coreRadius); x++) {
+      galaxyErased[(y * SCREEN_WIDTH + x) >> 5] |= 1u << (x & 31);
+    }
+  }
   prevGalaxyCenterX = centerX;
   prevGalaxyCenterY = centerY;
   prevGalaxyCoreRadius = coreRadius;
-  
-  // Scaling factor - adjusted to fit the display (smaller value = larger galaxy)
-  float scaleFactor = 25.0f * objectScale; 
-  float globalRotation = (millis() / 10000.0f) * rotationSpeed; // Variable rotation speed
-  
-  // Draw each arm with enhanced effects
-  for (int arm = 0; arm < numArms; arm++) {
-    int pointsDrawn = 0;
-    
-    // Number of points per arm - adjusted based on display size
-    const int pointsPerArm = 100; 
-    
-    for (int i = 0; i < pointsPerArm; i++) {
-      // Generate a distance from center (0-1)
-      float distance = (float)i / pointsPerArm;
-      
-      // Square the distance to concentrate more stars near center
-      float distanceSquared = distance * distance;
-      
-      // Apply density factor - more stars in inner galaxy
-      float density = 1.0f - distanceSquared * 0.8f;
-      
-      // Add some randomness to star distribution
-      if (random(100) > density * 90) continue;
-      
-      // Calculate arm offset that decreases with distance
-      float armOffset = (random(1000) / 1000.0f) * armOffsetMax;
-      armOffset = armOffset - armOffsetMax / 2;
-      armOffset = armOffset * (1 / max(distance, 0.1f));
-      
-      // Apply squared offset with sign preservation
-      float squaredArmOffset = armOffset * abs(armOffset);
-      
-      // Apply rotation that increases with distance
-      float rotation = distanceSquared * rotationFactor;
-      
-      // Calculate final angle with time-based variation
-      float angle = arm * armSeparationDistance + squaredArmOffset + rotation + globalRotation;
-      
-      // Convert to cartesian coordinates
-      float radius = scaleFactor * distance;
-      float baseX = centerX + radius * cos(angle);
-      float baseY = centerY + radius * sin(angle);
-      
-      // Add small random offset - more offset farther from center
-      int x = round(baseX + (random(1000) / 1000.0f - 0.5f) * randomOffsetXY * distance);
-      int y = round(baseY + (random(1000) / 1000.0f - 0.5f) * randomOffsetXY * distance);
-      
-      // Check if within screen bounds
-      if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT && 
-          pointsDrawn < MAX_GALAXY_POINTS) {
-        // Store position for next frame's erasing
-        prevGalaxyPoints[arm][pointsDrawn][0] = x;
-        prevGalaxyPoints[arm][pointsDrawn][1] = y;
-        pointsDrawn++;
-        
-        // Enhanced brightness calculation with distance and time effects
-        float brightness = (1.0f - distance * 0.5f) * 255.0f;
-        brightness *= (0.8f + 0.2f * sin(time * 3.0f + distance * 10.0f)); // Add twinkling
-        brightness = constrain(brightness, 150, 255);
-        
-        uint16_t color = tft.color565(brightness, brightness, brightness);
-        
-        // Add colored stars with more variety
-        if (random(15) == 0) { // Increased chance for colored stars
-          if (distance > 0.7f) {
-            color = tft.color565(100, 100, 255); // Blue for outer arms
-          } else if (distance > 0.4f) {
-            color = tft.color565(255, 255, 100); // Yellow for middle arms
-          } else {
-            color = tft.color565(255, 100, 100); // Red for inner arms
-          }
-        }
-        
-        tft.drawPixel(x, y, color);
+#endif
+
+  // Draw each arm, inner points first
+  for (int arm = 0; arm < MAX_GALAXY_ARMS; arm++) {
+    int points = min((int)galaxyArmPoints[arm], maxArmPoints);
+    for (int i = 0; i < points; i++) {
+      const GalaxyPoint& point = galaxyPoints[arm * MAX_GALAXY_POINTS + i];
+      int x, y;
+      if (!galaxyPointScreen(point, globalRotation, centerX, centerY, x, y)) continue;
+
+      uint16_t color = point.color;
+      if (!color) {
+        // Twinkle: brightness * (0.8 + 0.2 * sin(time * 3 + distance * 10)), kept in 150..255
+        q16_16 twinkle = (FX_ONE * 4 + fxSin(twinkleTime + point.twinkle)) / 5;
+        color = PAL_GREY.v[constrain((int)fxMul(point.brightness, twinkle), 150, 255)];
       }
+
+#if !RENDER_FULL_REDRAW
+      GalaxyPixel& shown = galaxyShown[arm * MAX_GALAXY_POINTS + i];
+      bool erased = galaxyErased[(y * SCREEN_WIDTH + x) >> 5] & (1u << (x & 31));
+      if (shown.x == x && shown.y == y && shown.color == color && !erased) continue;
+      shown.x = x;
+      shown.y = y;
+      shown.color = color;
+#endif
+      canvas.drawPixel(x, y, color);
     }
-    
-    prevGalaxyPointCount[arm] = pointsDrawn;
   }
-  
-  // Clear remaining arms if we reduced the number
-  for (int arm = numArms; arm < MAX_GALAXY_ARMS; arm++) {
-    prevGalaxyPointCount[arm] = 0;
+}
+
+/**
+ * Draws one asteroid with its glow at its current position
+ */
+void drawAsteroid(int index, int centerX, int centerY, float maxDistance, float pulseFactor) {
+  int x = round(asteroids[index].x);
+  int y = round(asteroids[index].y);
+  
+  // Calculate asteroid brightness based on distance from center
+  float dx = x - centerX;
+  float dy = y - centerY;
+  float distance = sqrt(dx*dx + dy*dy);
+  float brightness = 1.0f - (distance / maxDistance);
+  brightness = constrain(brightness, 0.3f, 1.0f);
+  
+  // Add pulsing effect
+  brightness *= (0.8f + 0.2f * pulseFactor);
+  
+  // Draw asteroid glow
+  for (int r = asteroids[index].radius + 1; r > asteroids[index].radius; r--) {
+    uint8_t glowBrightness = map(r, asteroids[index].radius, asteroids[index].radius + 1, 255 * brightness, 100);
+    uint16_t glowColor = PAL_GREY.v[glowBrightness];
+    canvasDrawCircle(x, y, r, glowColor);
   }
+  
+  // Draw main asteroid
+  uint8_t asteroidBrightness = 255 * brightness;
+  uint16_t asteroidColor = PAL_GREY.v[asteroidBrightness];
+  canvasFillCircle(x, y, asteroids[index].radius, asteroidColor);
+
+  // Update the previous position
+  asteroids[index].prevX = x;
+  asteroids[index].prevY = y;
+}
+
+/**
+ * Takes the asteroids from the object arena; the first draw scatters them
+ */
+void initAsteroidField() {
+  asteroids = arenaAlloc<Asteroid>(MAX_ASTEROIDS);
+  asteroidFieldInitialized = false;
 }
 
 void drawAsteroidField() {
   if (!asteroidFieldInitialized) {
-    int fieldWidth = 128;
-    int fieldHeight = 128;
+    int fieldWidth = SCREEN_WIDTH;
+    int fieldHeight = SCREEN_HEIGHT;
     int centerX = objectX;
     int centerY = objectY;
     
     // Initialize asteroids with more variety
     for (int i = 0; i < MAX_ASTEROIDS; i++) {
-      asteroids[i].x = centerX + random(-fieldWidth, fieldWidth);
-      asteroids[i].y = centerY + random(-fieldHeight, fieldHeight);
+      asteroids[i].x = centerX + objectRng.range(-fieldWidth, fieldWidth);
+      asteroids[i].y = centerY + objectRng.range(-fieldHeight, fieldHeight);
       
       // Vary asteroid speeds and directions
-      float speed = random(1, 4) + random(0, 100) / 100.0f;
-      float angle = random(0, 360) * PI / 180.0f;
+      float speed = objectRng.range(1, 4) + objectRng.range(0, 100) / 100.0f;
+      float angle = objectRng.range(0, 360) * PI / 180.0f;
       asteroids[i].vx = cos(angle) * speed;
       asteroids[i].vy = sin(angle) * speed;
       
       // Vary asteroid sizes
-      asteroids[i].radius = random(1, 4);
+      asteroids[i].radius = objectRng.range(1, 4);
       asteroids[i].prevX = round(asteroids[i].x);
       asteroids[i].prevY = round(asteroids[i].y);
     }
@@ -1558,7 +2328,7 @@ void drawAsteroidField() {
   int centerY = objectY;
 
   // Add time-based effects - calculate once per frame
-  float time = millis() / 1000.0f;
+  float time = frameClock.timeMs / 1000.0f;
   float pulseFactor = (sin(time * 2.0f) + 1.0f) / 2.0f;
   
   // Calculate max distance once
@@ -1571,18 +2341,20 @@ void drawAsteroidField() {
   for (int i = 0; i < asteroidsToUpdate; i++) {
     int index = (startAsteroid + i) % MAX_ASTEROIDS;
     
+#if !RENDER_FULL_REDRAW
     // Erase the asteroid at its previous position with a larger radius to prevent artifacts
-    tft.fillCircle(asteroids[index].prevX, asteroids[index].prevY, 
+    canvasFillCircle(asteroids[index].prevX, asteroids[index].prevY, 
                    asteroids[index].radius + 3, BG_COLOR);
     
     // Also clear the path between previous and current position to eliminate trails
     int midX = (asteroids[index].prevX + round(asteroids[index].x)) / 2;
     int midY = (asteroids[index].prevY + round(asteroids[index].y)) / 2;
-    tft.fillCircle(midX, midY, asteroids[index].radius + 2, BG_COLOR);
+    canvasFillCircle(midX, midY, asteroids[index].radius + 2, BG_COLOR);
+#endif
 
     // Update the asteroid's position with some randomness
-    asteroids[index].x += asteroids[index].vx + (random(100) - 50) / 1000.0f;
-    asteroids[index].y += asteroids[index].vy + (random(100) - 50) / 1000.0f;
+    asteroids[index].x += asteroids[index].vx + (objectRng.below(100) - 50) / 1000.0f;
+    asteroids[index].y += asteroids[index].vy + (objectRng.below(100) - 50) / 1000.0f;
 
     // Bounce the asteroid off the edges of the field with energy loss
     if (asteroids[index].x < centerX - fieldWidth || asteroids[index].x > centerX + fieldWidth) {
@@ -1596,7 +2368,7 @@ void drawAsteroidField() {
       }
       
       // Add some randomness to the bounce
-      asteroids[index].vy += (random(100) - 50) / 100.0f;
+      asteroids[index].vy += (objectRng.below(100) - 50) / 100.0f;
     }
     
     if (asteroids[index].y < centerY - fieldHeight || asteroids[index].y > centerY + fieldHeight) {
@@ -1610,39 +2382,21 @@ void drawAsteroidField() {
       }
       
       // Add some randomness to the bounce
-      asteroids[index].vx += (random(100) - 50) / 100.0f;
+      asteroids[index].vx += (objectRng.below(100) - 50) / 100.0f;
     }
 
+#if !RENDER_FULL_REDRAW
     // Draw the asteroid with glow effect
-    int x = round(asteroids[index].x);
-    int y = round(asteroids[index].y);
-    
-    // Calculate asteroid brightness based on distance from center
-    float dx = x - centerX;
-    float dy = y - centerY;
-    float distance = sqrt(dx*dx + dy*dy);
-    float brightness = 1.0f - (distance / maxDistance);
-    brightness = constrain(brightness, 0.3f, 1.0f);
-    
-    // Add pulsing effect
-    brightness *= (0.8f + 0.2f * pulseFactor);
-    
-    // Draw asteroid glow
-    for (int r = asteroids[index].radius + 1; r > asteroids[index].radius; r--) {
-      uint8_t glowBrightness = map(r, asteroids[index].radius, asteroids[index].radius + 1, 255 * brightness, 100);
-      uint16_t glowColor = tft.color565(glowBrightness, glowBrightness, glowBrightness);
-      tft.drawCircle(x, y, r, glowColor);
-    }
-    
-    // Draw main asteroid
-    uint8_t asteroidBrightness = 255 * brightness;
-    uint16_t asteroidColor = tft.color565(asteroidBrightness, asteroidBrightness, asteroidBrightness);
-    tft.fillCircle(x, y, asteroids[index].radius, asteroidColor);
+    drawAsteroid(index, centerX, centerY, maxDistance, pulseFactor);
+#endif
+  }
 
-    // Update the previous position
-    asteroids[index].prevX = x;
-    asteroids[index].prevY = y;
+#if RENDER_FULL_REDRAW
+  // The frame starts empty, so asteroids not updated this frame are drawn too
+  for (int i = 0; i < MAX_ASTEROIDS; i++) {
+    drawAsteroid(i, centerX, centerY, maxDistance, pulseFactor);
   }
+#endif
   
   // Update starting asteroid for next frame
   startAsteroid = (startAsteroid + asteroidsToUpdate) % MAX_ASTEROIDS;
@@ -1691,226 +2445,17 @@ void drawAsteroidField() {
 
 /**
  * Draws a planet with atmosphere and surface details
- * Modified to cycle through planet types
  */
-// Static variables to hold the current planet's generated configuration
-static bool planetConfigured = false;
-static uint32_t planetSeed = 0; // Seed for procedural generation
-static uint16_t planetBaseColor1 = TFT_BLACK;
-static uint16_t planetBaseColor2 = TFT_BLACK;
-static uint16_t planetFeatureColor = TFT_BLACK; // For clouds/details
-static uint16_t planetAtmosColor = TFT_BLACK;
-static float lightAngle = 0.0f; // Angle from which light is coming (radians)
-static int planetType = 0;      // 0=Rocky, 1=Gas, 2=Earth-like, 3=Ice
-static int baseRadius = 0;      // Store base radius used for configuration
-
-// Simple pseudo-random noise function (replace with Perlin/Simplex if available/performant)
-// Uses integer coordinates and a seed for deterministic noise
-float simpleNoise(int x, int y, uint32_t seed) {
-    // Simple hash-like function - basic but gives variation
-    uint32_t hash = seed;
-    hash = (hash ^ 61) ^ (x * 31);
-    hash = hash + (y * 53);
-    hash = hash ^ (hash >> 16);
-    hash = hash * 0xDEADBEEF; // Mix it up
-    hash = hash ^ (hash >> 13);
-    return (hash & 0xFFFF) / 65535.0f; // Normalize to 0.0 - 1.0
-}
-
-// Helper to blend two colors
-uint16_t blendColor(uint16_t color1, uint16_t color2, float ratio) {
-    ratio = constrain(ratio, 0.0f, 1.0f);
-    uint8_t r1 = ((color1 >> 11) & 0x1F);
-    uint8_t g1 = ((color1 >> 5) & 0x3F);
-    uint8_t b1 = (color1 & 0x1F);
-
-    uint8_t r2 = ((color2 >> 11) & 0x1F);
-    uint8_t g2 = ((color2 >> 5) & 0x3F);
-    uint8_t b2 = (color2 & 0x1F);
-
-    uint8_t r = r1 * (1.0 - ratio) + r2 * ratio;
-    uint8_t g = g1 * (1.0 - ratio) + g2 * ratio;
-    uint8_t b = b1 * (1.0 - ratio) + b2 * ratio;
-
-    return tft.color565(r << 3, g << 2, b << 3); // Re-encode to 565 directly might lose precision, better use full RGB if possible
-    // Or re-encode using the TFT function if it handles 8-bit RGB input:
-    // return tft.color565( (uint8_t)((r1 * (1.0 - ratio) + r2 * ratio) * 8.1),  // Approximate scaling back to 8-bit range
-    //                      (uint8_t)((g1 * (1.0 - ratio) + g2 * ratio) * 4.05),
-    //                      (uint8_t)((b1 * (1.0 - ratio) + b2 * ratio) * 8.1) );
-}
-
-
-void drawPlanet() {
-    int centerX = objectX;
-    int centerY = objectY;
-    float scale = max(0.1f, objectScale); // Ensure scale is positive
-    int currentRadius = round(15 * scale);  // Slightly larger base radius
-
-    // If planet not configured OR the base radius changed significantly (needs regeneration)
-    if (!planetConfigured || abs(currentRadius - baseRadius) > 2) {
-        planetSeed = random(0xFFFFFFFF); // New seed for this planet
-        planetType = random(0, 4);       // 0=Rocky, 1=Gas, 2=Earth-like, 3=Ice
-        lightAngle = random(0, 360) * DEG_TO_RAD; // Random light direction
-
-        // Define color palettes based on type
-        switch (planetType) {
-            case 0: // Rocky (Mars/Desert like)
-                planetBaseColor1 = tft.color565(110, 70, 50);   // Dark Brown/Red
-                planetBaseColor2 = tft.color565(210, 140, 90);  // Lighter Tan/Orange
-                planetFeatureColor = tft.color565(180, 170, 160); // Wispy clouds/dust
-                planetAtmosColor = tft.color565(230, 180, 150); // Thin, dusty atmosphere
-                break;
-            case 1: // Gas Giant (Jupiter/Saturn like)
-                planetBaseColor1 = tft.color565(160, 140, 110); // Beige/Brown band
-                planetBaseColor2 = tft.color565(220, 200, 170); // Lighter Cream band
-                planetFeatureColor = tft.color565(240, 230, 220); // Bright Storms/swirls
-                planetAtmosColor = tft.color565(210, 200, 180); // Hazy atmosphere
-                break;
-            case 2: // Earth-like
-                planetBaseColor1 = tft.color565(20, 80, 160);   // Deep Ocean Blue
-                planetBaseColor2 = tft.color565(50, 140, 70);   // Land Green
-                planetFeatureColor = tft.color565(250, 250, 250); // White Clouds
-                planetAtmosColor = tft.color565(180, 210, 240); // Blue sky atmosphere
-                break;
-            case 3: // Ice World
-                planetBaseColor1 = tft.color565(150, 180, 210); // Shadowed Ice Blue
-                planetBaseColor2 = tft.color565(220, 235, 255); // Bright Ice/Snow White
-                planetFeatureColor = tft.color565(190, 210, 230); // Cracks / Light Blue features
-                planetAtmosColor = tft.color565(210, 225, 245); // Very thin, bright atmosphere
-                break;
-        }
-        planetConfigured = true;
-        baseRadius = currentRadius; // Store the radius used for this configuration
-    }
-
-    // --- Drawing ---
-    // Calculate square of radius for faster distance check
-    float radiusSq = (float)currentRadius * currentRadius;
-    // Calculate light vector components once
-    float lightVecX = cos(lightAngle);
-    float lightVecY = sin(lightAngle);
-
-    tft.startWrite(); // Optimize drawing speed
-
-    for (int y = -currentRadius; y <= currentRadius; y++) {
-        for (int x = -currentRadius; x <= currentRadius; x++) {
-            float distSq = (float)x * x + (float)y * y;
-
-            // Is the pixel inside the planet's circle?
-            if (distSq <= radiusSq) {
-                float dist = sqrt(distSq);
-                float currentAbsX = centerX + x;
-                float currentAbsY = centerY + y;
-
-                // Check screen bounds (optional but good practice)
-                if (currentAbsX < 0 || currentAbsX >= SCREEN_WIDTH || currentAbsY < 0 || currentAbsY >= SCREEN_HEIGHT) {
-                    continue;
-                }
-
-                // --- Calculate Base Color using Noise ---
-                // Use multiple noise layers for more detail (adjust frequencies/amplitudes)
-                float noiseVal = simpleNoise(x / 2, y / 2, planetSeed) * 0.6f; // Base layer
-                noiseVal += simpleNoise(x * 2, y * 2, planetSeed + 1) * 0.3f; // Detail layer
-                noiseVal += simpleNoise(y / 4, x/ 4, planetSeed + 2) * 0.1f; // Subtle large features (gas giant bands?)
-                noiseVal = constrain(noiseVal, 0.0f, 1.0f);
-
-                // Map noise to color gradient
-                uint16_t baseSurfaceColor;
-                if (planetType == 2) { // Special case for Earth: bias towards water
-                   baseSurfaceColor = blendColor(planetBaseColor1, planetBaseColor2, constrain(noiseVal * 1.5f - 0.3f, 0.0f, 1.0f)); // More water
-                } else {
-                   baseSurfaceColor = blendColor(planetBaseColor1, planetBaseColor2, noiseVal);
-                }
-
-                 // --- Cloud/Feature Layer (optional based on type) ---
-                float featureNoise = simpleNoise(x * 3 + 50, y * 3, planetSeed + 3); // Different noise for features
-                float featureThreshold;
-                switch(planetType) {
-                    case 1: featureThreshold = 0.65f; break; // More prominent storms/bands
-                    case 2: featureThreshold = 0.7f; break; // Clouds
-                    default: featureThreshold = 0.9f; break; // Less frequent features
-                }
-                if (featureNoise > featureThreshold) {
-                    float featureIntensity = (featureNoise - featureThreshold) / (1.0f - featureThreshold); // How "strong" is the feature
-                    baseSurfaceColor = blendColor(baseSurfaceColor, planetFeatureColor, constrain(featureIntensity * 0.8f, 0.0f, 0.8f)); // Blend feature color in
-                }
-
-
-                // --- Calculate Lighting ---
-                // Normalize pixel vector relative to center
-                float pixelVecX = x / (float)currentRadius;
-                float pixelVecY = y / (float)currentRadius;
-                // Dot product between light vector and pixel normal vector (approximated by pixelVec)
-                float dotProd = pixelVecX * lightVecX + pixelVecY * lightVecY;
-                // Intensity based on angle (cosine relationship), clamp negative values (shadow)
-                float lightIntensity = max(0.0f, dotProd);
-                // Add ambient light so shadow side isn't pitch black
-                lightIntensity = 0.15f + lightIntensity * 0.85f; // Adjust ambient(0.15) vs directional(0.85) ratio
-
-                // Apply lighting to the surface color
-                uint8_t r = red(baseSurfaceColor);
-                uint8_t g = green(baseSurfaceColor);
-                uint8_t b = blue(baseSurfaceColor);
-                r = constrain((int)(r * lightIntensity), 0, 255);
-                g = constrain((int)(g * lightIntensity), 0, 255);
-                b = constrain((int)(b * lightIntensity), 0, 255);
-                uint16_t litColor = tft.color565(r, g, b);
-
-                // --- Atmosphere Haze near edge ---
-                float edgeFactor = dist / (float)currentRadius; // 0 at center, 1 at edge
-                float hazeAmount = pow(edgeFactor, 4.0f); // Make haze stronger near edge (power > 1)
-                hazeAmount = constrain(hazeAmount * 0.4f, 0.0f, 0.4f); // Control max haze effect
-                uint16_t finalColor = blendColor(litColor, planetAtmosColor, hazeAmount);
-
-
-                // --- Draw the pixel ---
-                tft.drawPixel(currentAbsX, currentAbsY, finalColor);
-            }
-        }
-    }
-
-    // --- Draw Outer Atmosphere Glow (Softer version) ---
-    int glowRadiusStart = currentRadius + 1;
-    int glowRadiusEnd = currentRadius + max(2, (int)(6 * scale)); // Glow thickness scales
-    for (int r = glowRadiusEnd; r >= glowRadiusStart; r--) {
-        float progress = (float)(r - glowRadiusStart) / (float)(glowRadiusEnd - glowRadiusStart + 1); // 1.0 near planet, 0.0 far out
-        float alpha = (1.0 - progress) * 0.5f; // Fade out, max alpha less than 1.0
-
-        // Blend atmosphere color with background based on alpha
-        uint16_t glowColor = blendColor(BG_COLOR, planetAtmosColor, alpha);
-
-        // Draw circle - might be slow, consider drawing arcs or points if needed
-        tft.drawCircle(centerX, centerY, r, glowColor);
-    }
-
-    tft.endWrite(); // End optimized drawing
-}
-
-// --- Updated Erase Function ---
-
-/**
- * Erases the planet and resets the configuration flag.
- */
-void erasePlanet() {
-    int centerX = objectX;
-    int centerY = objectY;
-    float scale = max(0.1f, objectScale);
-    int currentRadius = round(15 * scale); // Match radius calculation in drawPlanet
-    int glowThickness = max(2, (int)(6 * scale)); // Match glow thickness
-
-    // Erase a circle slightly larger than the planet + atmosphere glow
-    int eraseRadius = currentRadius + glowThickness + 2; // Add buffer
-    tft.fillCircle(centerX, centerY, eraseRadius, BG_COLOR);
-
-    // Signal that the planet needs to be re-configured on the next draw call
-    planetConfigured = false;
-}
+// Implementation moved to planet.h
 
 #include <vector> // Include for std::vector
 
 // --- Static variables for Binary Star state and erasing ---
 static const int MAX_TRAIL_POINTS_BINARY = 10; // Increased for denser trail
 static const int MAX_STREAM_POINTS_BINARY = 15;
+#define BINARY_GLOW_FACTOR 1.7f // Glow reaches this many star radii
+#define BINARY_STAR_ARENA_BYTES (GLOW_BYTES((int)((int)(7 * GLOW_MAX_SCALE) * BINARY_GLOW_FACTOR)) + \
+                                 GLOW_BYTES((int)((int)(4 * GLOW_MAX_SCALE) * BINARY_GLOW_FACTOR)))
 
 // Previous positions and radii for precise erasing
 static int b_prevCenterX = -1000, b_prevCenterY = -1000;
@@ -1919,68 +2464,58 @@ static int b_prevX1 = -1, b_prevY1 = -1, b_prevRadius1_eff = -1; // Store effect
 static int b_prevX2 = -1, b_prevY2 = -1, b_prevRadius2_eff = -1;
 
 // Store previous trail points
+#if !RENDER_FULL_REDRAW
 static std::vector<std::pair<int, int>> b_prevTrail1(MAX_TRAIL_POINTS_BINARY);
 static std::vector<std::pair<int, int>> b_prevTrail2(MAX_TRAIL_POINTS_BINARY);
+#endif
 static int b_prevNumTrailPoints = 0;
 
 // Store previous stream points
+#if !RENDER_FULL_REDRAW
 static std::vector<std::pair<int, int>> b_prevStream(MAX_STREAM_POINTS_BINARY);
+#endif
 static int b_prevNumStreamPoints = 0;
 
 static bool b_wasDrawn = false; // Flag if the system was drawn in the previous frame
 
 /**
- * Helper function to draw a star with soft glow and limb darkening
+ * Renders a star with soft glow and limb darkening into a glow atlas slot
  */
-void drawStarRealistic(int x, int y, int radius, uint16_t coreColor, uint16_t glowColor) {
-    if (radius < 1) return; // Don't draw if too small
-
-    uint8_t core_r = red(coreColor);
-    uint8_t core_g = green(coreColor);
-    uint8_t core_b = blue(coreColor);
-
-    uint8_t glow_r = red(glowColor);
-    uint8_t glow_g = green(glowColor);
-    uint8_t glow_b = blue(glowColor);
-
-    int maxGlowRadius = radius * 1.7; // Adjust glow extent
-
-    tft.startWrite(); // Optimize drawing
-
-    // Draw glow layers
-    for (int r = maxGlowRadius; r > radius; r--) {
-        float progress = (float)(r - radius) / (float)(maxGlowRadius - radius); // 0.0 at edge, 1.0 at max glow
-        float alpha = (1.0 - progress * progress) * 0.4f; // Fade out non-linearly, control intensity
-
-        // Blend glow color with background (approximate)
-        // A true alpha blend needs reading background pixel, which is slow.
-        // We fake it by blending with black (BG_COLOR assumed black here)
-        uint8_t blended_r = glow_r * alpha;
-        uint8_t blended_g = glow_g * alpha;
-        uint8_t blended_b = glow_b * alpha;
-        uint16_t blendedColor = tft.color565(blended_r, blended_g, blended_b);
-
-        if (blended_r > 5 || blended_g > 5 || blended_b > 5) { // Only draw if color is visible
-             tft.drawCircle(x, y, r, blendedColor);
+void createStarRealistic(uint8_t slot, int radius, uint16_t coreColor, uint16_t glowColor) {
+    int maxGlowRadius = radius * BINARY_GLOW_FACTOR; // Adjust glow extent
+
+    glowCreate(slot, maxGlowRadius, [=](int px, int py) -> uint16_t {
+        int distSq = px * px + py * py;
+        if (distSq <= radius * radius) {
+            // The star body with limb darkening, by up to 35% at the edge
+            float dist = sqrtf((float)distSq);
+            return scale565(coreColor, blendAlphaFloat(1.0f - (dist / radius) * 0.35f));
         }
-    }
 
-    // Draw the star body with limb darkening
-    for (int py = -radius; py <= radius; py++) {
-        for (int px = -radius; px <= radius; px++) {
-            float distSq = px * px + py * py;
-            if (distSq <= radius * radius) {
-                float dist = sqrt(distSq);
-                float limbFactor = 1.0 - (dist / radius) * 0.35; // Darken by up to 35% at the edge
+        // Glow layers
+        int ring = glowRing(px, py);
+        if (ring <= radius || ring > maxGlowRadius) return 0;
+        float progress = (float)(ring - radius) / (float)(maxGlowRadius - radius); // 0.0 at edge, 1.0 at max glow
+        float alpha = (1.0f - progress * progress) * 0.4f; // Fade out non-linearly, control intensity
 
-                uint8_t r = constrain((int)(core_r * limbFactor), 0, 255);
-                uint8_t g = constrain((int)(core_g * limbFactor), 0, 255);
-                uint8_t b = constrain((int)(core_b * limbFactor), 0, 255);
-                tft.drawPixel(x + px, y + py, tft.color565(r, g, b));
-            }
-        }
-    }
-    tft.endWrite(); // End optimized drawing
+        // The glow is additive, so it lights up the other star and the stream
+        // behind it instead of covering them with its own dark fringe
+        return scale565(glowColor, blendAlphaFloat(alpha));
+    }, true);
+}
+
+/**
+ * Renders both stars at the discovery's scale
+ */
+void initBinaryStar() {
+    float scale = max(0.1f, objectScale);
+    // More distinct colors
+    createStarRealistic(GLOW_BINARY_PRIMARY, max(1, (int)(7 * scale)),
+                        canvas.color565(255, 210, 100),  // Brighter yellow-orange core
+                        canvas.color565(255, 160, 40));  // Deeper orange glow
+    createStarRealistic(GLOW_BINARY_COMPANION, max(1, (int)(4 * scale)),
+                        canvas.color565(160, 210, 255),  // Bright blue-white core
+                        canvas.color565(70, 150, 240));  // Deeper blue glow
 }
 
 
@@ -1991,8 +2526,10 @@ void drawStarRealistic(int x, int y, int radius, uint16_t coreColor, uint16_t gl
  * Draws a binary star system with two stars orbiting each other, improved graphics
  */
 void drawBinaryStar() {
+#if !RENDER_FULL_REDRAW
     // ---- Erase Previous Frame ---
     eraseBinaryStar(); // Call erase first using stored previous state
+#endif
 
     // ---- Current Frame Calculation ---
     int centerX = objectX;
@@ -2003,11 +2540,7 @@ void drawBinaryStar() {
     int radius1 = max(1, (int)(7 * scale)); // Main star (larger, G-type)
     int radius2 = max(1, (int)(4 * scale)); // Companion star (smaller, B-type)
 
-    // More distinct colors
-    uint16_t color1_core = tft.color565(255, 210, 100); // Brighter yellow-orange core
-    uint16_t color1_glow = tft.color565(255, 160, 40);  // Deeper orange glow
-    uint16_t color2_core = tft.color565(160, 210, 255); // Bright blue-white core
-    uint16_t color2_glow = tft.color565(70, 150, 240);  // Deeper blue glow
+    // Colors are in the glow atlas, see initBinaryStar()
 
     // Orbit mechanics (m1*r1 = m2*r2 -> r2/r1 = m1/m2)
     // Let's assume Star 1 (larger radius) is more massive.
@@ -2018,7 +2551,7 @@ void drawBinaryStar() {
     int orbitRadius2 = max(1, (int)(orbitScale * 0.67f)); // Further orbit for less massive star
 
     float angularSpeed = 0.0012f; // Slightly slower speed
-    float t = millis() * angularSpeed; // Current angle
+    float t = frameClock.timeMs * angularSpeed; // Current angle
 
     // Calculate positions
     int x1 = round(centerX + orbitRadius1 * cos(t));
@@ -2031,11 +2564,11 @@ void drawBinaryStar() {
     b_prevNumStreamPoints = 0;
 
     // --- Draw Orbital Trails ---
-    uint16_t trailColorBase = tft.color565(40, 40, 50); // Faint bluish-grey trail
+    uint16_t trailColorBase = canvas.color565(40, 40, 50); // Faint bluish-grey trail
     float trailLengthAngle = 1.5 * PI; // How much of the orbit trail to show (radians)
     float angleStep = 0.08; // Smaller step for denser trail
 
-    tft.startWrite();
+    beginBatch();
     for (float angleOffset = angleStep; angleOffset <= trailLengthAngle; angleOffset += angleStep) {
         float currentAngle = t - angleOffset; // Go backwards in time for trail
 
@@ -2056,21 +2589,25 @@ void drawBinaryStar() {
         uint8_t tb = blue(trailColorBase) * fade;
 
         if ((tr > 3 || tg > 3 || tb > 3) && b_prevNumTrailPoints < MAX_TRAIL_POINTS_BINARY) { // Only draw/store if visible enough
-            uint16_t fadedTrailColor = tft.color565(tr, tg, tb);
+            uint16_t fadedTrailColor = canvas.color565(tr, tg, tb);
             if (tx1 != b_prevX1 || ty1 != b_prevY1) { // Avoid overdrawing same pixel
-                tft.drawPixel(tx1, ty1, fadedTrailColor);
+                canvas.drawPixel(tx1, ty1, fadedTrailColor);
+#if !RENDER_FULL_REDRAW
                 b_prevTrail1[b_prevNumTrailPoints].first = tx1;
                 b_prevTrail1[b_prevNumTrailPoints].second = ty1;
+#endif
             }
             if (tx2 != b_prevX2 || ty2 != b_prevY2) {
-                tft.drawPixel(tx2, ty2, fadedTrailColor);
+                canvas.drawPixel(tx2, ty2, fadedTrailColor);
+#if !RENDER_FULL_REDRAW
                 b_prevTrail2[b_prevNumTrailPoints].first = tx2;
                 b_prevTrail2[b_prevNumTrailPoints].second = ty2;
+#endif
             }
             b_prevNumTrailPoints++;
         }
     }
-    tft.endWrite();
+    endBatch();
 
 
     // --- Draw Interaction Stream (if stars are close enough) ---
@@ -2100,9 +2637,9 @@ void drawBinaryStar() {
         float perpY = dirX;
         float curveFactor = 7.0 * scale * (1.0 - distanceBetween / interactionDistance); // Stronger curve when closer
 
-        uint16_t streamColor = tft.color565(200, 210, 240); // Faint hot gas color
+        uint16_t streamColor = canvas.color565(200, 210, 240); // Faint hot gas color
 
-        tft.startWrite();
+        beginBatch();
         for (int i = 0; i < MAX_STREAM_POINTS_BINARY; ++i) {
             float t_stream = (float)i / (MAX_STREAM_POINTS_BINARY - 1); // Progress along stream (0 to 1)
 
@@ -2122,19 +2659,21 @@ void drawBinaryStar() {
             uint8_t sb = blue(streamColor) * fade;
 
             if (sr > 3 || sg > 3 || sb > 3) {
-                tft.drawPixel(streamX, streamY, tft.color565(sr, sg, sb));
+                canvas.drawPixel(streamX, streamY, canvas.color565(sr, sg, sb));
+#if !RENDER_FULL_REDRAW
                 // Store for erasing
                 b_prevStream[b_prevNumStreamPoints].first = streamX;
                 b_prevStream[b_prevNumStreamPoints].second = streamY;
+#endif
                 b_prevNumStreamPoints++;
             }
         }
-        tft.endWrite();
+        endBatch();
     }
 
     // --- Draw Stars (on top of trails/streams) ---
-    drawStarRealistic(x1, y1, radius1, color1_core, color1_glow);
-    drawStarRealistic(x2, y2, radius2, color2_core, color2_glow);
+    glowBlit(GLOW_BINARY_PRIMARY, x1, y1);
+    glowBlit(GLOW_BINARY_COMPANION, x2, y2);
 
     // --- Store state for next erase ---
     b_prevCenterX = centerX;
@@ -2159,29 +2698,31 @@ void drawBinaryStar() {
 void eraseBinaryStar() {
     if (!b_wasDrawn) return; // Nothing to erase if nothing was drawn
 
-    tft.startWrite(); // Use transaction for faster erasing
+#if !RENDER_FULL_REDRAW
+    beginBatch(); // Use transaction for faster erasing
 
     // Erase previous Stream
     for (int i = 0; i < b_prevNumStreamPoints; ++i) {
-        tft.drawPixel(b_prevStream[i].first, b_prevStream[i].second, BG_COLOR);
+        canvas.drawPixel(b_prevStream[i].first, b_prevStream[i].second, BG_COLOR);
     }
 
     // Erase previous Trails
     for (int i = 0; i < b_prevNumTrailPoints; ++i) {
-        tft.drawPixel(b_prevTrail1[i].first, b_prevTrail1[i].second, BG_COLOR);
-        tft.drawPixel(b_prevTrail2[i].first, b_prevTrail2[i].second, BG_COLOR);
+        canvas.drawPixel(b_prevTrail1[i].first, b_prevTrail1[i].second, BG_COLOR);
+        canvas.drawPixel(b_prevTrail2[i].first, b_prevTrail2[i].second, BG_COLOR);
     }
 
     // Erase previous Star positions (using stored effective radius including glow)
     if (b_prevRadius1_eff > 0) {
         // Add a small buffer to the erase radius just in case
-        tft.fillCircle(b_prevX1, b_prevY1, b_prevRadius1_eff + 2, BG_COLOR);
+        canvasFillCircle(b_prevX1, b_prevY1, b_prevRadius1_eff + 2, BG_COLOR);
     }
     if (b_prevRadius2_eff > 0) {
-        tft.fillCircle(b_prevX2, b_prevY2, b_prevRadius2_eff + 2, BG_COLOR);
+        canvasFillCircle(b_prevX2, b_prevY2, b_prevRadius2_eff + 2, BG_COLOR);
     }
 
-    tft.endWrite(); // Finish transaction
+    endBatch(); // Finish transaction
+#endif
 
     // Reset state variables and flag
     b_wasDrawn = false;
@@ -2196,22 +2737,17 @@ void eraseBinaryStar() {
  * Using true pixel-based updates to eliminate flickering
  */
 void drawSpaceStation() {
+#if !RENDER_FULL_REDRAW
   static float prevStationAngle = -100; // Initial invalid value to force first draw
   static int prevBodyPoints[4][2] = {{0}}; // Store previous body corner positions
   static int prevPanelPoints[2][4][4][2] = {{{{0}}}}; // [panel][segment][corner][x,y]
   static int prevPanelBorders[2][4][5][2] = {{{{0}}}}; // [panel][segment][border_point][x,y] - Added for border tracking
-  static int prevDishPos[2] = {0}; // Previous dish position
-  static int prevLightPos[3][2] = {{0}}; // Previous light positions [red,green,strobe][x,y]
-  static int prevBeamPoints[2][2] = {{0}}; // Previous beam endpoints
-  static bool prevLightState[3] = {false}; // Previous light states [red,green,strobe]
-  static bool prevBeamActive = false; // Was beam active in previous frame
-  static int prevWindowPos[3][2] = {{0}}; // Previous window positions
-  static bool prevWindowState[3] = {false}; // Previous window states
+#endif
   
   int centerX = objectX;
   int centerY = objectY;
   float scale = objectScale;
-  unsigned long currentTime = millis();
+  unsigned long currentTime = frameClock.timeMs;
   
   // Station dimensions
   int bodyWidth = 18 * scale;
@@ -2236,9 +2772,8 @@ void drawSpaceStation() {
     y = centerY + relX * sinAngle + relY * cosAngle;
   };
   
-  // For the first draw or if rotation has changed significantly, redraw everything
+#if !RENDER_FULL_REDRAW
   bool firstDraw = (prevStationAngle < -99);
-  bool majorRotationChange = abs(stationAngle - prevStationAngle) > 0.05;
   
   // First, erase previous elements if this isn't the first draw
   if (!firstDraw) {
@@ -2283,14 +2818,14 @@ void drawSpaceStation() {
     maxY = min(SCREEN_HEIGHT-1, maxY + height/6);
     
     // Clear the expanded bounding area
-    tft.fillRect(minX, minY, maxX - minX + 1, maxY - minY + 1, BG_COLOR);
+    canvas.fillRect(minX, minY, maxX - minX + 1, maxY - minY + 1, BG_COLOR);
     
     // Additional precise clearing of panel borders
     for (int panel = 0; panel < 2; panel++) {
       for (int segment = 0; segment < 4; segment++) {
         for (int border = 0; border < 4; border++) {
           int nextBorder = (border + 1) % 4;
-          tft.drawLine(
+          canvas.drawLine(
             prevPanelBorders[panel][segment][border][0],
             prevPanelBorders[panel][segment][border][1],
             prevPanelBorders[panel][segment][nextBorder][0],
@@ -2301,6 +2836,7 @@ void drawSpaceStation() {
       }
     }
   }
+#endif
   
   // Main station body - ALWAYS redraw to ensure rotation
   int x1 = centerX - moduleWidth/2;
@@ -2318,23 +2854,25 @@ void drawSpaceStation() {
   }
   
   // Draw a filled polygon for the station body
-  uint16_t bodyColor = tft.color565(180, 180, 180);
-  tft.fillTriangle(
+  uint16_t bodyColor = canvas.color565(180, 180, 180);
+  canvas.fillTriangle(
     bodyCorners[0][0], bodyCorners[0][1],
     bodyCorners[1][0], bodyCorners[1][1],
     bodyCorners[2][0], bodyCorners[2][1],
     bodyColor
   );
   
-  tft.fillTriangle(
+  canvas.fillTriangle(
     bodyCorners[0][0], bodyCorners[0][1],
     bodyCorners[2][0], bodyCorners[2][1],
     bodyCorners[3][0], bodyCorners[3][1],
     bodyColor
   );
   
+#if !RENDER_FULL_REDRAW
   // Store body corners for next frame
   memcpy(prevBodyPoints, bodyCorners, sizeof(bodyCorners));
+#endif
   
   // Draw solar panels with improved border tracking
   for (int panel = 0; panel < 2; panel++) {
@@ -2359,24 +2897,28 @@ void drawSpaceStation() {
       // Rotate all corners
       for (int c = 0; c < 4; c++) {
         rotatePoint(corners[c][0], corners[c][1]);
+#if !RENDER_FULL_REDRAW
         // Store rotated corners for border tracking
         prevPanelBorders[panel][segment][c][0] = corners[c][0];
         prevPanelBorders[panel][segment][c][1] = corners[c][1];
+#endif
       }
       
+#if !RENDER_FULL_REDRAW
       // Store for next frame's panel corners
       memcpy(prevPanelPoints[panel][segment], corners, sizeof(corners));
+#endif
       
       // Draw filled panel
-      uint16_t panelColor = tft.color565(40 + segment*5, 45 + segment*5, 80 + segment*10);
-      tft.fillTriangle(
+      uint16_t panelColor = canvas.color565(40 + segment*5, 45 + segment*5, 80 + segment*10);
+      canvas.fillTriangle(
         corners[0][0], corners[0][1],
         corners[1][0], corners[1][1],
         corners[2][0], corners[2][1],
         panelColor
       );
       
-      tft.fillTriangle(
+      canvas.fillTriangle(
         corners[0][0], corners[0][1],
         corners[2][0], corners[2][1],
         corners[3][0], corners[3][1],
@@ -2384,15 +2926,16 @@ void drawSpaceStation() {
       );
       
       // Draw and store panel borders with extra precision
-      uint16_t panelOutlineColor = tft.color565(30 + segment*5, 35 + segment*5, 70 + segment*10);
+      uint16_t panelOutlineColor = canvas.color565(30 + segment*5, 35 + segment*5, 70 + segment*10);
       for (int c = 0; c < 4; c++) {
         int next = (c + 1) % 4;
-        tft.drawLine(
+        canvas.drawLine(
           corners[c][0], corners[c][1],
           corners[next][0], corners[next][1],
           panelOutlineColor
         );
         
+#if !RENDER_FULL_REDRAW
         // Store border points with slight offset for better coverage
         float dx = corners[next][0] - corners[c][0];
         float dy = corners[next][1] - corners[c][1];
@@ -2404,6 +2947,7 @@ void drawSpaceStation() {
           prevPanelBorders[panel][segment][4][0] = corners[c][0] + nx;
           prevPanelBorders[panel][segment][4][1] = corners[c][1] + ny;
         }
+#endif
       }
     }
   }
@@ -2412,9 +2956,7 @@ void drawSpaceStation() {
   int dishX = centerX;
   int dishY = centerY - bodyHeight/2 - 2 * scale;
   rotatePoint(dishX, dishY);
-  tft.fillCircle(dishX, dishY, dishRadius, tft.color565(120, 120, 120));
-  prevDishPos[0] = dishX;
-  prevDishPos[1] = dishY;
+  canvasFillCircle(dishX, dishY, dishRadius, canvas.color565(120, 120, 120));
   
   // Navigation lights
   // Red light (left)
@@ -2423,11 +2965,8 @@ void drawSpaceStation() {
   rotatePoint(redX, redY);
   bool redOn = ((currentTime / 500) % 2 == 0);
   if (redOn) {
-    tft.fillCircle(redX, redY, lightRadius, tft.color565(255, 0, 0));
+    canvasFillCircle(redX, redY, lightRadius, canvas.color565(255, 0, 0));
   }
-  prevLightPos[0][0] = redX;
-  prevLightPos[0][1] = redY;
-  prevLightState[0] = redOn;
   
   // Green light (right)
   int greenX = centerX + bodyWidth/2;
@@ -2435,11 +2974,8 @@ void drawSpaceStation() {
   rotatePoint(greenX, greenY);
   bool greenOn = ((currentTime / 500) % 2 == 1);
   if (greenOn) {
-    tft.fillCircle(greenX, greenY, lightRadius, tft.color565(0, 255, 0));
+    canvasFillCircle(greenX, greenY, lightRadius, canvas.color565(0, 255, 0));
   }
-  prevLightPos[1][0] = greenX;
-  prevLightPos[1][1] = greenY;
-  prevLightState[1] = greenOn;
   
   // White strobe (top)
   int strobeX = centerX;
@@ -2447,11 +2983,8 @@ void drawSpaceStation() {
   rotatePoint(strobeX, strobeY);
   bool strobeOn = ((currentTime / 2000) % 4 == 0);
   if (strobeOn) {
-    tft.fillCircle(strobeX, strobeY, lightRadius, tft.color565(255, 255, 255));
+    canvasFillCircle(strobeX, strobeY, lightRadius, canvas.color565(255, 255, 255));
   }
-  prevLightPos[2][0] = strobeX;
-  prevLightPos[2][1] = strobeY;
-  prevLightState[2] = strobeOn;
   
   // Draw windows with blinking lights
   for (int i = 0; i < 3; i++) {
@@ -2462,16 +2995,12 @@ void drawSpaceStation() {
     // Window light effect
     bool windowOn = ((currentTime / 1000) + i) % 3 == 0;
     uint16_t windowColor = windowOn ? 
-      tft.color565(255, 255, 150) : tft.color565(100, 100, 80);
+      canvas.color565(255, 255, 150) : canvas.color565(100, 100, 80);
     
-    tft.drawPixel(winX, winY, windowColor);
+    canvas.drawPixel(winX, winY, windowColor);
     if (scale > 1.0) {
-      tft.drawPixel(winX, winY+1, windowColor);
+      canvas.drawPixel(winX, winY+1, windowColor);
     }
-    
-    prevWindowPos[i][0] = winX;
-    prevWindowPos[i][1] = winY;
-    prevWindowState[i] = windowOn;
   }
   
   // Communication beam
@@ -2480,28 +3009,25 @@ void drawSpaceStation() {
     int beamLength = 10 * scale;
     int beamEndX = dishX + cos(stationAngle + PI/4) * beamLength;
     int beamEndY = dishY + sin(stationAngle + PI/4) * beamLength;
-    tft.drawLine(dishX, dishY, beamEndX, beamEndY, tft.color565(70, 70, 255));
-    
-    prevBeamPoints[0][0] = dishX;
-    prevBeamPoints[0][1] = dishY;
-    prevBeamPoints[1][0] = beamEndX;
-    prevBeamPoints[1][1] = beamEndY;
+    canvas.drawLine(dishX, dishY, beamEndX, beamEndY, canvas.color565(70, 70, 255));
     
     // Add beam animation
     if ((currentTime / 200) % 2 == 0) {
       int midX = dishX + cos(stationAngle + PI/4) * beamLength * 0.5;
       int midY = dishY + sin(stationAngle + PI/4) * beamLength * 0.5;
-      tft.drawPixel(midX, midY, tft.color565(200, 200, 255));
+      canvas.drawPixel(midX, midY, canvas.color565(200, 200, 255));
     }
   }
-  prevBeamActive = beamActive;
   
+#if !RENDER_FULL_REDRAW
   // Store angle for next frame
   prevStationAngle = stationAngle;
+#endif
 }
 
 // Erase function is kept empty as erasing is handled in the drawing function
 void eraseSpaceStation() {
+#if !RENDER_FULL_REDRAW
   // Calculate the maximum possible extent of the station based on its dimensions
   float scale = objectScale;
   int bodyWidth = 18 * scale;
@@ -2513,7 +3039,7 @@ void eraseSpaceStation() {
   int maxExtent = max(max(bodyWidth, panelHeight), max(bodyHeight, panelWidth)) + 5; // Increased margin
   
   // Clear the entire station area with a rectangle that encompasses all parts
-  tft.fillRect(objectX - maxExtent, objectY - maxExtent, maxExtent * 2, maxExtent * 2, BG_COLOR);
+  canvas.fillRect(objectX - maxExtent, objectY - maxExtent, maxExtent * 2, maxExtent * 2, BG_COLOR);
   
   // Use multiple overlapping circles for more thorough cleaning of rotated elements
   int maxRadius = maxExtent + 10; // Slightly larger than the bounding box
@@ -2521,19 +3047,19 @@ void eraseSpaceStation() {
   // Clear with multiple overlapping circles at different positions
   for (int offset = 0; offset <= 10; offset += 2) {
     // Center circle
-    tft.fillCircle(objectX, objectY, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX, objectY, maxRadius - offset, BG_COLOR);
     
     // Offset circles in cardinal directions
-    tft.fillCircle(objectX + offset, objectY, maxRadius - offset, BG_COLOR);
-    tft.fillCircle(objectX - offset, objectY, maxRadius - offset, BG_COLOR);
-    tft.fillCircle(objectX, objectY + offset, maxRadius - offset, BG_COLOR);
-    tft.fillCircle(objectX, objectY - offset, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX + offset, objectY, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX - offset, objectY, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX, objectY + offset, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX, objectY - offset, maxRadius - offset, BG_COLOR);
     
     // Diagonal offset circles
-    tft.fillCircle(objectX + offset, objectY + offset, maxRadius - offset, BG_COLOR);
-    tft.fillCircle(objectX - offset, objectY + offset, maxRadius - offset, BG_COLOR);
-    tft.fillCircle(objectX + offset, objectY - offset, maxRadius - offset, BG_COLOR);
-    tft.fillCircle(objectX - offset, objectY - offset, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX + offset, objectY + offset, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX - offset, objectY + offset, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX + offset, objectY - offset, maxRadius - offset, BG_COLOR);
+    canvasFillCircle(objectX - offset, objectY - offset, maxRadius - offset, BG_COLOR);
   }
   
   // Clear any potential beam artifacts with a wider line
@@ -2541,7 +3067,7 @@ void eraseSpaceStation() {
   for (float angle = 0; angle < 2 * PI; angle += PI / 8) {
     int endX = objectX + cos(angle) * beamLength;
     int endY = objectY + sin(angle) * beamLength;
-    tft.drawLine(objectX, objectY, endX, endY, BG_COLOR);
+    canvas.drawLine(objectX, objectY, endX, endY, BG_COLOR);
   }
   
   // Additional cleanup for any remaining artifacts
@@ -2549,10 +3075,42 @@ void eraseSpaceStation() {
     float angle = i * PI / 2;
     int x = objectX + cos(angle) * maxRadius;
     int y = objectY + sin(angle) * maxRadius;
-    tft.fillCircle(x, y, 5, BG_COLOR);
+    canvasFillCircle(x, y, 5, BG_COLOR);
   }
+#endif
 }
 
+// Object arena, sized for the object that needs the most state
+constexpr size_t OBJECT_ARENA_BYTES =
+  arenaMax(arenaMax(arenaMax(arenaMax(STAR_ARENA_BYTES, PLANET_ARENA_BYTES), arenaMax(NEBULA_ARENA_BYTES, GALAXY_ARENA_BYTES)),
+                    arenaMax(arenaMax(SOLAR_SYSTEM_ARENA_BYTES, ASTEROID_FIELD_ARENA_BYTES), arenaMax(BLACK_HOLE_ARENA_BYTES, PULSAR_ARENA_BYTES))),
+           arenaMax(arenaMax(SUPERNOVA_ARENA_BYTES, COMET_ARENA_BYTES), BINARY_STAR_ARENA_BYTES));
+alignas(ARENA_ALIGN) uint8_t objectArena[OBJECT_ARENA_BYTES];
+const size_t objectArenaSize = OBJECT_ARENA_BYTES;
+
+// One renderer per CelestialObject, in enum order
+const CelestialRenderer CELESTIAL_RENDERERS[] = {
+  // label            init               draw                erase                detailBudget          simCore
+  {"STAR",           initStar,          drawStar,           eraseStar,           nullptr,              false},
+  {"PLANET",         initPlanet,        drawPlanet,         erasePlanet,         nullptr,              false},
+  {"NEBULA",         initNebula,        drawNebula,         eraseNebula,         nebulaDetailBudget,   NEBULA_SIM_CORE},
+  {"GALAXY",         initGalaxy,        drawGalaxy,         eraseGalaxy,         galaxyDetailBudget,   false},
+  {"SOLAR SYSTEM",   initSolarSystem,   drawSolarSystem,    eraseSolarSystem,    nullptr,              false},
+  {"ASTEROID FIELD", initAsteroidField, drawAsteroidField,  eraseAsteroidField,  nullptr,              false},
+  {"BLACK HOLE",     initBlackHole,     drawBlackHole,      eraseBlackHole,      blackHoleDetailBudget, true},
+  {"PULSAR",         initPulsar,        drawPulsar,         erasePulsar,         nullptr,              false},
+  {"SUPERNOVA",      initSupernova,     drawSupernova,      eraseSupernova,      nullptr,              true},
+  {"COMET",          initComet,         drawComet,          eraseComet,          cometDetailBudget,    true},
+  {"BINARY STAR",    initBinaryStar,    drawBinaryStar,     eraseBinaryStar,     nullptr,              false},
+  {"SPACE STATION",  nullptr,           drawSpaceStation,   eraseSpaceStation,   nullptr,              false},
+};
+static_assert(sizeof(CELESTIAL_RENDERERS) / sizeof(CELESTIAL_RENDERERS[0]) == static_cast<int>(CelestialObject::NUM_TYPES),
+              "Every celestial object needs a renderer");
+
+// The intro is laid out for 128x128 and centred on bigger panels
+constexpr int INTRO_LEFT = (SCREEN_WIDTH - 128) / 2;
+constexpr int INTRO_TOP = (SCREEN_HEIGHT - 128) / 2;
+
 /**
  * Draws a retro-style intro screen with animation and waits for user input
  * Uses the main stars array for a seamless transition
@@ -2565,20 +3123,20 @@ void drawIntroScreen() {
   }
   
   // Draw WARP DRIVE title with shadow for 3D effect
-  const int titleY = 20;
+  const int titleY = INTRO_TOP + 20;
   // Shadow first
   tft.setTextColor(tft.color565(0, 0, 80));
   tft.setTextSize(2);
-  tft.setCursor(12, titleY+1);
+  tft.setCursor(INTRO_LEFT + 12, titleY+1);
   tft.print("WARP");
-  tft.setCursor(22, titleY+17);
+  tft.setCursor(INTRO_LEFT + 22, titleY+17);
   tft.print("DRIVE");
   
   // Then main text
   tft.setTextColor(tft.color565(80, 200, 255)); // Bright cyan
-  tft.setCursor(10, titleY);
+  tft.setCursor(INTRO_LEFT + 10, titleY);
   tft.print("WARP");
-  tft.setCursor(20, titleY+16);
+  tft.setCursor(INTRO_LEFT + 20, titleY+16);
   tft.print("DRIVE");
   
   // Animate a spaceship
@@ -2587,19 +3145,19 @@ void drawIntroScreen() {
   // Draw "ESP8266" subtitle with proper positioning
   tft.setTextSize(1);
   tft.setTextColor(tft.color565(0, 255, 0));
-  tft.setCursor(28, titleY + 48);
+  tft.setCursor(INTRO_LEFT + 28, titleY + 48);
   typewriterText("For Mahira <3", 40);
   
   // Draw interface instructions with proper positioning
   tft.setTextColor(tft.color565(255, 255, 0));
-  tft.setCursor(10, 85);
+  tft.setCursor(INTRO_LEFT + 10, INTRO_TOP + 85);
   typewriterText("TURN KNOB FOR WARP", 20);
   
   // Draw pixelated loading bar
   const int barWidth = 100;
   const int barHeight = 4;
   const int barX = (SCREEN_WIDTH - barWidth) / 2;
-  const int barY = 100;
+  const int barY = INTRO_TOP + 100;
   
   // Bar outline
   tft.drawRect(barX-1, barY-1, barWidth+2, barHeight+2, tft.color565(80, 80, 80));
@@ -2607,16 +3165,16 @@ void drawIntroScreen() {
   // "READY" blink
   for (int i = 0; i < 2; i++) {
     tft.setTextColor(tft.color565(255, 255, 255));
-    tft.setCursor(50, 110);
+    tft.setCursor(INTRO_LEFT + 50, INTRO_TOP + 110);
     tft.print("READY");
     delay(400);
     tft.setTextColor(BG_COLOR);
-    tft.setCursor(50, 110);
+    tft.setCursor(INTRO_LEFT + 50, INTRO_TOP + 110);
     tft.print("READY");
     delay(200);
   }
   tft.setTextColor(tft.color565(255, 255, 255));
-  tft.setCursor(50, 110);
+  tft.setCursor(INTRO_LEFT + 50, INTRO_TOP + 110);
   tft.print("READY");
   
   // Wait for user input before proceeding
@@ -2625,19 +3183,15 @@ void drawIntroScreen() {
   
   // Loop until input is detected
   while (!inputDetected) {
-    // Read potentiometer value
-    int rawValue = 0;
-    for (int i = 0; i < 4; i++) {
-      rawValue += analogRead(POT_PIN);
+    // Read potentiometer value (un-inverted and halved, as this check was tuned on)
+    if (!potSamplerRunning) {
+      readPotentiometer();
     }
-    int currentPotValue = rawValue / 8; // 0-1023
+    int currentPotValue = (4095 - potValue.load(std::memory_order_relaxed)) / 2;
  
-    // Check if potentiometer has been turned (value > threshold)
-    if (currentPotValue < 1900) {
+    // Check if potentiometer has been turned (value > threshold); a replay or a benchmark starts at once
+    if (currentPotValue < 1900 || traceReplaying() || benchRunning()) {
       inputDetected = true;
-      // Set the global potValue for use in main loop
-      potValue = currentPotValue;
-      
     }
     
     // Update twinkling stars while waiting (similar to updateStars function)
@@ -2646,7 +3200,7 @@ void drawIntroScreen() {
       lastStarUpdateTime = currentTime;
       
       // Use the main updateStars function to keep the starfield consistent
-      updateStars();
+      updateIntroStars();
     }
     
     // Small delay to prevent CPU hogging
@@ -2677,13 +3231,13 @@ void warpTransitionEffect() {
 void drawAnimatedSpaceship() {
   const int shipWidth = 15;
   const int shipHeight = 8; 
-  const int shipY = 55;
+  const int shipY = INTRO_TOP + 55;
   
   // Draw animated ship
   for (int frame = 0; frame < 12; frame++) {
     // Calculate position - ship moves slightly in a wave pattern
     int offsetY = sin(frame * 0.5) * 2;
-    int shipX = 20 + frame * 7;
+    int shipX = INTRO_LEFT + 20 + frame * 7;
     
     if (frame > 0) {
       // Erase previous ship position
@@ -2720,7 +3274,7 @@ void drawAnimatedSpaceship() {
     
     // Draw engine glow - changes size and color to animate
     uint8_t thrusterSize = 2 + (frame % 3);
-    uint8_t thrusterBrightness = 180 + random(-20, 50);
+    uint8_t thrusterBrightness = 180 + starRng.range(-20, 50);
     
     tft.fillRect(
       shipX - thrusterSize, shipY + shipHeight/2 - thrusterSize/2 + offsetY,
@@ -2732,8 +3286,8 @@ void drawAnimatedSpaceship() {
     for (int i = 1; i <= 5; i++) {
       uint8_t exhaustBrightness = max(0, 150 - i * 30);
       tft.drawPixel(
-        shipX - thrusterSize - i - random(0, 2), 
-        shipY + shipHeight/2 + random(-1, 2) + offsetY,
+        shipX - thrusterSize - i - starRng.range(0, 2), 
+        shipY + shipHeight/2 + starRng.range(-1, 2) + offsetY,
         tft.color565(exhaustBrightness, exhaustBrightness/3, 0)
       );
     }
@@ -2746,7 +3300,7 @@ void drawAnimatedSpaceship() {
  * Prints text with a typewriter effect
  */
 void typewriterText(const char* text, int delayMs) {
-  for (int i = 0; i < strlen(text); i++) {
+  for (int i = 0; text[i] != '\0'; i++) {
     tft.print(text[i]);
     delay(delayMs);
   }
@@ -2763,7 +3317,7 @@ void checkPowerButton() {
   const unsigned long debounceDelay = 50;
   
   // Read button with debounce
-  int reading = digitalRead(BUTTON_PIN);
+  int reading = traceButton(digitalRead(BUTTON_PIN));
   
   if (reading != lastButtonState) {
     lastDebounceTime = millis();
@@ -2776,16 +3330,16 @@ void checkPowerButton() {
       // Button press started
       if (buttonState == LOW) {
         pressStartTime = millis();
-        Serial.println("Button pressed");
+        DEBUG_LOG(DEBUG_EVENTS, "Button pressed\n");
       }
       // Button released
       else {
         unsigned long pressDuration = millis() - pressStartTime;
-        Serial.printf("Button released after %lu ms\n", pressDuration);
+        DEBUG_LOG(DEBUG_EVENTS, "Button released after %lu ms\n", pressDuration);
         
         // Long press detected while powered on
         if (pressDuration >= LONG_PRESS_TIME && isPoweredOn) {
-          Serial.println("Long press detected - powering off");
+          DEBUG_LOG(DEBUG_EVENTS, "Long press detected - powering off\n");
           isPoweredOn = false;
           powerOffRequested = true;
         }
@@ -2805,6 +3359,11 @@ void powerOff() {
   Serial.println("Entering deep sleep");
   
   // Show power off message
+  simStop();
+  potSamplerEnd();
+  traceEnd(); // Keep the recording up to the long press
+  saveSnapshot();
+  releaseDisplay();
   tft.fillScreen(TFT_BLACK);
   tft.setTextColor(TFT_RED);
   tft.setTextSize(1);